@@ -235,7 +235,7 @@ void square_light_spot(struct chunk *c, int y, int x)
 {
 	if (c == cave) {
 		player->upkeep->redraw |= PR_ITEMLIST;
-		event_signal_point(EVENT_MAP, x, y);
+		event_queue_map_point(x, y);
 	}
 }
 
@@ -264,7 +264,7 @@ static void cave_light(struct point_set *ps)
 		int x = ps->pts[i].x;
 
 		/* Perma-Light */
-		sqinfo_on(cave->squares[y][x].info, SQUARE_GLOW);
+		square_flag_on(cave, y, x, SQUARE_GLOW);
 	}
 
 	/* Fully update the visuals */
@@ -327,7 +327,7 @@ static void cave_unlight(struct point_set *ps)
 		int x = ps->pts[i].x;
 
 		/* Darken the grid */
-		sqinfo_off(cave->squares[y][x].info, SQUARE_GLOW);
+		square_flag_off(cave, y, x, SQUARE_GLOW);
 
 		/* Hack -- Forget "boring" grids */
 		if (square_isfloor(cave, y, x))
@@ -437,13 +437,13 @@ void wiz_light(struct chunk *c, bool full)
 					int xx = x + ddx_ddd[i];
 
 					/* Perma-light the grid */
-					sqinfo_on(c->squares[yy][xx].info, SQUARE_GLOW);
+					square_flag_on(c, yy, xx, SQUARE_GLOW);
 
 					/* Memorize normal features */
 					if (!square_isfloor(c, yy, xx) || 
 						square_isvisibletrap(c, yy, xx)) {
 						square_memorize(c, yy, xx);
-						square_mark(cave, yy, xx);
+						square_mark(c, yy, xx);
 					}
 				}
 			}
@@ -508,10 +508,10 @@ void cave_illuminate(struct chunk *c, bool daytime)
 
 			/* Only interesting grids at night */
 			if (daytime || !tf_has(feat->flags, TF_FLOOR)) {
-				sqinfo_on(c->squares[y][x].info, SQUARE_GLOW);
+				square_flag_on(c, y, x, SQUARE_GLOW);
 				square_memorize(c, y, x);
 			} else {
-				sqinfo_off(c->squares[y][x].info, SQUARE_GLOW);
+				square_flag_off(c, y, x, SQUARE_GLOW);
 				square_forget(c, y, x);
 			}
 		}
@@ -525,7 +525,7 @@ void cave_illuminate(struct chunk *c, bool daytime)
 			for (i = 0; i < 8; i++) {
 				int yy = y + ddy_ddd[i];
 				int xx = x + ddx_ddd[i];
-				sqinfo_on(c->squares[yy][xx].info, SQUARE_GLOW);
+				square_flag_on(c, yy, xx, SQUARE_GLOW);
 				square_memorize(c, yy, xx);
 			}
 		}
@@ -539,18 +539,17 @@ void cave_illuminate(struct chunk *c, bool daytime)
 	player->upkeep->redraw |= (PR_MAP | PR_MONLIST | PR_ITEMLIST);
 }
 
-/**
- * Size of the circular queue used by "update_flow()"
- */
-#define FLOW_MAX 2048
-
 /*
  * Hack -- provide some "speed" for the "flow" code
- * This entry is the "current index" for the "when" field
- * Note that a "when" value of "zero" means "not used".
  *
- * Note that the "cost" indexes from 1 to 127 are for
- * "old" data, and from 128 to 255 are for "new" data.
+ * Every grid the current flow reaches has a "when" of FLOW_NOW and holds its
+ * distance from the player in "cost".  A grid the flow stops reaching keeps
+ * its last "cost" as scent, and is stamped with the value of "flow_save" at
+ * the update that lost it, so fresher scent has a higher "when".  Note that
+ * a "when" value of "zero" means "not used".
+ *
+ * Note that the scent stamps from 1 to 127 are for "old" data, and from 128
+ * to 254 are for "new" data.
  *
  * This means that as long as the player does not "teleport",
  * then any monster up to 128 + z_info->max_flow_depth will be
@@ -560,103 +559,307 @@ void cave_illuminate(struct chunk *c, bool daytime)
  */
 static int flow_save = 0;
 
+/**
+ * The "when" of grids the current flow reaches
+ */
+#define FLOW_NOW	255
 
+/**
+ * How many grids may change passability between two flow updates before
+ * the next update simply rebuilds the flow
+ */
+#define FLOW_CHANGED_MAX	32
+
+/**
+ * What a chunk remembers between flow updates
+ *
+ * Grids waiting to have their distance repaired are kept in one list per
+ * distance, threaded through "queue" and "next".  "queued" holds one more
+ * than the distance each grid of the chunk was last queued at, or zero.
+ */
+struct flow_field {
+	struct loc grid;	/* Player grid the flow was built from */
+
+	struct loc *queue;	/* Queued grids */
+	int *next;			/* Next entry queued at the same distance */
+	int *bucket;		/* First entry queued at each distance, or -1 */
+	int queue_n;
+	int queue_max;
+	bool overflow;		/* The queue ran out of room */
+
+	byte *queued;		/* width * height, see above */
+
+	struct loc changed[FLOW_CHANGED_MAX];	/* Grids that changed passability */
+	int changed_n;		/* More than FLOW_CHANGED_MAX forces a rebuild */
+};
+
+
+/**
+ * Grow the bounding box of grids holding flow data to include the
+ * flow window around (y, x)
+ */
+static void flow_mark_region(struct chunk *c, int y, int x)
+{
+	int r = z_info->max_flow_depth;
+
+	c->flow_min.y = MIN(c->flow_min.y, MAX(y - r, 0));
+	c->flow_min.x = MIN(c->flow_min.x, MAX(x - r, 0));
+	c->flow_max.y = MAX(c->flow_max.y, MIN(y + r, c->height - 1));
+	c->flow_max.x = MAX(c->flow_max.x, MIN(x + r, c->width - 1));
+}
 
 /**
  * Forget the "flow" information ready for a complete update
+ *
+ * Only the grids inside the flow bounding box can hold flow data, so only
+ * those are cleared.
  */
 void cave_forget_flow(struct chunk *c)
 {
 	int x, y;
 
+	/* The next update starts from scratch */
+	if (c->flow) {
+		c->flow->grid = loc(-1, -1);
+		c->flow->changed_n = 0;
+	}
+
 	/* Nothing to forget */
 	if (!flow_save) return;
 
-	/* Check the entire dungeon */
-	for (y = 0; y < c->height; y++) {
-		for (x = 0; x < c->width; x++) {
+	/* Check the part of the dungeon the flow has reached */
+	for (y = c->flow_min.y; y <= c->flow_max.y; y++) {
+		for (x = c->flow_min.x; x <= c->flow_max.x; x++) {
 			/* Forget the old data */
 			c->squares[y][x].cost = 0;
 			c->squares[y][x].when = 0;
 		}
 	}
 
+	/* The box is now empty */
+	c->flow_min = loc(c->width, c->height);
+	c->flow_max = loc(-1, -1);
+
 	/* Start over */
 	flow_save = 0;
 }
 
+/**
+ * Note that the grid at (y, x) has started or stopped letting the flow
+ * through, so the next cave_update_flow() repairs the distances around it
+ */
+void cave_note_flow(struct chunk *c, int y, int x)
+{
+	struct flow_field *flow = c->flow;
 
-/*
- * Hack -- fill in the "cost" field of every grid that the player can
- * "reach" with the number of steps needed to reach that grid.  This
- * also yields the "distance" of the player from every grid.
- *
- * In addition, mark the "when" of the grids that can reach the player
- * with the incremented value of "flow_save".
+	/* No flow to repair */
+	if (!flow || flow->grid.y < 0) return;
+
+	/* Too many changes are cheaper to rebuild */
+	if (flow->changed_n < FLOW_CHANGED_MAX)
+		flow->changed[flow->changed_n] = loc(x, y);
+	if (flow->changed_n <= FLOW_CHANGED_MAX)
+		flow->changed_n++;
+}
+
+/**
+ * Distance of the grid at (y, x) from the player, or max_flow_depth if the
+ * current flow does not reach it
+ */
+static int flow_dist(struct chunk *c, int y, int x)
+{
+	if (c->squares[y][x].when != FLOW_NOW) return z_info->max_flow_depth;
+	return c->squares[y][x].cost;
+}
+
+/**
+ * Distance the grid at (y, x) should have, given the distances of its
+ * neighbours
+ */
+static int flow_best(struct chunk *c, int y, int x)
+{
+	int d, best = z_info->max_flow_depth;
+
+	/* The player grid */
+	if ((y == c->flow->grid.y) && (x == c->flow->grid.x)) return 0;
+
+	/* Ignore "walls" and "rubble" */
+	if (tf_has(f_info[c->squares[y][x].feat].flags, TF_NO_FLOW)) return best;
+
+	/* One step further than the nearest neighbour */
+	for (d = 0; d < 8; d++) {
+		int yy = y + ddy_ddd[d];
+		int xx = x + ddx_ddd[d];
+		if (!square_in_bounds(c, yy, xx)) continue;
+
+		best = MIN(best, flow_dist(c, yy, xx) + 1);
+	}
+
+	return MIN(best, z_info->max_flow_depth);
+}
+
+/**
+ * Give the grid at (y, x) a new distance, leaving its old cost as scent if
+ * the flow no longer reaches it
+ */
+static void flow_set(struct chunk *c, int y, int x, int dist)
+{
+	if (dist < z_info->max_flow_depth) {
+		c->squares[y][x].when = FLOW_NOW;
+		c->squares[y][x].cost = dist;
+	} else {
+		c->squares[y][x].when = flow_save;
+	}
+}
+
+/**
+ * Queue the grid at (y, x) if its distance disagrees with its neighbours
+ */
+static void flow_check(struct chunk *c, int y, int x)
+{
+	struct flow_field *flow = c->flow;
+	int dist = flow_dist(c, y, x);
+	int best = flow_best(c, y, x);
+	int key = MIN(dist, best);
+	int i = y * c->width + x;
+
+	/* Consistent, or already queued at the right distance */
+	if ((dist == best) || (flow->queued[i] == key + 1)) return;
+
+	/* Out of room */
+	if (flow->queue_n == flow->queue_max) {
+		flow->overflow = true;
+		return;
+	}
+
+	flow->queued[i] = key + 1;
+	flow->queue[flow->queue_n] = loc(x, y);
+	flow->next[flow->queue_n] = flow->bucket[key];
+	flow->bucket[key] = flow->queue_n++;
+}
+
+/**
+ * Repair the distances of every queued grid, nearest first
  *
- * Hack -- use the local "flow_y" and "flow_x" arrays as a "circular
- * queue" of cave grids.
+ * A grid that is too far from its nearest neighbour takes the distance that
+ * neighbour gives it.  A grid that is too close has lost the path it was
+ * reached by, so it is dropped from the flow and queued again at whatever
+ * distance is left.  Either way only its neighbours need checking again, so
+ * the work done is in proportion to the number of grids whose distance
+ * changes.  Grids are never queued at a distance below the one being
+ * processed, so a single pass over the distances is enough.
  *
- * We do not need a priority queue because the cost from grid to grid
- * is always "one" (even along diagonals) and we process them in order.
+ * Returns false if the queue overflowed, leaving the flow half repaired.
  */
-void cave_update_flow(struct chunk *c)
+static bool flow_repair(struct chunk *c)
 {
-	int py = player->py;
-	int px = player->px;
+	struct flow_field *flow = c->flow;
+	int i, k, d;
 
-	int ty, tx;
+	for (k = 0; k < z_info->max_flow_depth; k++) {
+		while (flow->bucket[k] >= 0) {
+			struct loc grid = flow->queue[flow->bucket[k]];
+			int y = grid.y, x = grid.x;
+			int dist, best;
 
-	int y, x;
+			flow->bucket[k] = flow->next[flow->bucket[k]];
 
-	int n, d;
+			/* Skip entries queued again at another distance */
+			if (flow->queued[y * c->width + x] != k + 1) continue;
+			flow->queued[y * c->width + x] = 0;
 
-	int flow_n;
+			/* Already repaired */
+			dist = flow_dist(c, y, x);
+			best = flow_best(c, y, x);
+			if (dist == best) continue;
 
-	int flow_tail = 0;
-	int flow_head = 0;
+			if (best < dist) {
+				flow_set(c, y, x, best);
+			} else {
+				flow_set(c, y, x, z_info->max_flow_depth);
+				flow_check(c, y, x);
+			}
 
-	byte flow_y[FLOW_MAX];
-	byte flow_x[FLOW_MAX];
+			/* Check the neighbours */
+			for (d = 0; d < 8; d++) {
+				int yy = y + ddy_ddd[d];
+				int xx = x + ddx_ddd[d];
+				if (!square_in_bounds(c, yy, xx)) continue;
 
+				flow_check(c, yy, xx);
+			}
 
-	/*** Cycle the flow ***/
+			if (flow->overflow) break;
+		}
+		if (flow->overflow) break;
+	}
 
-	/* Cycle the flow */
-	if (flow_save++ == 255)
-	{
-		/* Cycle the flow */
-		for (y = 0; y < c->height; y++)
-		{
-			for (x = 0; x < c->width; x++)
-			{
-				int w = c->squares[y][x].when;
-				c->squares[y][x].when = (w >= 128) ? (w - 128) : 0;
-			}
+	/* Leave nothing marked as queued */
+	if (flow->overflow)
+		for (i = 0; i < flow->queue_n; i++) {
+			struct loc grid = flow->queue[i];
+			flow->queued[grid.y * c->width + grid.x] = 0;
 		}
 
-		/* Restart */
-		flow_save = 128;
+	return !flow->overflow;
+}
+
+/*
+ * Hack -- fill in the "cost" field of every grid that the player at "grid"
+ * can "reach" with the number of steps needed to reach that grid, stamping
+ * those grids with FLOW_NOW and every grid the old flow reached but the new
+ * one does not with "flow_save".
+ *
+ * The search never leaves the square of side 2 * max_flow_depth - 1
+ * centred on the player, and visits each grid in it at most once, so it
+ * fits in the flow queue.
+ *
+ * We do not need a priority queue because the cost from grid to grid
+ * is always "one" (even along diagonals) and we process them in order.
+ */
+static void flow_rebuild(struct chunk *c, struct loc grid)
+{
+	struct flow_field *flow = c->flow;
+	struct loc *queue = flow->queue;
+	struct loc min = c->flow_min, max = c->flow_max;
+	int py = grid.y;
+	int px = grid.x;
+
+	int y, x;
+
+	int n, d;
+
+	int flow_tail = 0;
+	int flow_head = 0;
+
+	/* The old flow lies within reach of the grid it was built from */
+	if (flow->grid.y >= 0) {
+		int r = z_info->max_flow_depth - 1;
+		min.y = MAX(min.y, flow->grid.y - r);
+		min.x = MAX(min.x, flow->grid.x - r);
+		max.y = MIN(max.y, flow->grid.y + r);
+		max.x = MIN(max.x, flow->grid.x + r);
 	}
 
-	/* Local variable */
-	flow_n = flow_save;
+	/* Everything the old flow reached becomes scent */
+	for (y = min.y; y <= max.y; y++)
+		for (x = min.x; x <= max.x; x++)
+			if (c->squares[y][x].when == FLOW_NOW)
+				c->squares[y][x].when = flow_save;
+
+	flow->grid = grid;
 
 
 	/*** Player Grid ***/
 
 	/* Save the time-stamp */
-	c->squares[py][px].when = flow_n;
+	c->squares[py][px].when = FLOW_NOW;
 
 	/* Save the flow cost */
 	c->squares[py][px].cost = 0;
 
 	/* Enqueue that entry */
-	flow_y[flow_head] = py;
-	flow_x[flow_head] = px;
-
-	/* Advance the queue */
-	++flow_tail;
+	queue[flow_tail++] = loc(px, py);
 
 
 	/*** Process Queue ***/
@@ -665,14 +868,10 @@ void cave_update_flow(struct chunk *c)
 	while (flow_head != flow_tail)
 	{
 		/* Extract the next entry */
-		ty = flow_y[flow_head];
-		tx = flow_x[flow_head];
-
-		/* Forget that entry (with wrap) */
-		if (++flow_head == FLOW_MAX) flow_head = 0;
+		struct loc grid = queue[flow_head++];
 
 		/* Child cost */
-		n = c->squares[ty][tx].cost + 1;
+		n = c->squares[grid.y][grid.x].cost + 1;
 
 		/* Hack -- Limit flow depth */
 		if (n == z_info->max_flow_depth) continue;
@@ -680,37 +879,118 @@ void cave_update_flow(struct chunk *c)
 		/* Add the "children" */
 		for (d = 0; d < 8; d++)
 		{
-			int old_head = flow_tail;
-
 			/* Child location */
-			y = ty + ddy_ddd[d];
-			x = tx + ddx_ddd[d];
+			y = grid.y + ddy_ddd[d];
+			x = grid.x + ddx_ddd[d];
 			if (!square_in_bounds(c, y, x)) continue;
 
 			/* Ignore "pre-stamped" entries */
-			if (c->squares[y][x].when == flow_n) continue;
+			if (c->squares[y][x].when == FLOW_NOW) continue;
 
 			/* Ignore "walls" and "rubble" */
 			if (tf_has(f_info[c->squares[y][x].feat].flags, TF_NO_FLOW))
 				continue;
 
 			/* Save the time-stamp */
-			c->squares[y][x].when = flow_n;
+			c->squares[y][x].when = FLOW_NOW;
 
 			/* Save the flow cost */
 			c->squares[y][x].cost = n;
 
 			/* Enqueue that entry */
-			flow_y[flow_tail] = y;
-			flow_x[flow_tail] = x;
+			queue[flow_tail++] = loc(x, y);
+		}
+	}
+}
 
-			/* Advance the queue */
-			if (++flow_tail == FLOW_MAX) flow_tail = 0;
+/**
+ * Bring the flow up to date with the player's position and any terrain
+ * changes noted by cave_note_flow().
+ *
+ * If the player has not moved, only the grids that changed passability are
+ * checked, and the distances are repaired outward from them.  A step by the
+ * player changes the distance of nearly every grid in reach, so then, or if
+ * too much terrain has changed, the flow is rebuilt around the player
+ * instead.  Either way the result is the same: every grid within
+ * max_flow_depth - 1 steps has its distance, and the grids that just left
+ * the flow are stamped as the freshest scent.
+ */
+void cave_update_flow(struct chunk *c)
+{
+	struct flow_field *flow;
+	struct loc grid = loc(player->px, player->py);
+
+	int y, x, i;
+
+	/* Nothing to do */
+	if (z_info->max_flow_depth <= 0) return;
+
+	/* Set up on first use */
+	if (!c->flow) {
+		int side = 2 * z_info->max_flow_depth - 1;
+
+		flow = mem_arena_zalloc(c->arena, sizeof(*flow));
+		flow->grid = loc(-1, -1);
+		flow->queue_max = 4 * side * side;
+		flow->queue = mem_arena_alloc(c->arena,
+									  flow->queue_max * sizeof(struct loc));
+		flow->next = mem_arena_alloc(c->arena, flow->queue_max * sizeof(int));
+		flow->bucket = mem_arena_alloc(c->arena,
+									   z_info->max_flow_depth * sizeof(int));
+		flow->queued = mem_arena_zalloc(c->arena, c->width * c->height);
+		c->flow = flow;
+	}
+	flow = c->flow;
 
-			/* Hack -- Overflow by forgetting new entry */
-			if (flow_tail == flow_head) flow_tail = old_head;
+	/* Nothing has changed */
+	if ((grid.y == flow->grid.y) && (grid.x == flow->grid.x) &&
+		!flow->changed_n)
+		return;
+
+
+	/*** Cycle the flow ***/
+
+	/* Cycle the flow */
+	if (++flow_save == FLOW_NOW)
+	{
+		/* Cycle the flow */
+		for (y = c->flow_min.y; y <= c->flow_max.y; y++)
+		{
+			for (x = c->flow_min.x; x <= c->flow_max.x; x++)
+			{
+				int w = c->squares[y][x].when;
+				if (w == FLOW_NOW) continue;
+				c->squares[y][x].when = (w >= 128) ? (w - 128) : 0;
+			}
 		}
+
+		/* Restart */
+		flow_save = FLOW_NOW - 128;
 	}
+
+	/* Everything stamped below lies in the flow window */
+	flow_mark_region(c, grid.y, grid.x);
+
+	/* Only a few grids have changed */
+	if ((grid.y == flow->grid.y) && (grid.x == flow->grid.x) &&
+		(flow->changed_n <= FLOW_CHANGED_MAX)) {
+		flow->queue_n = 0;
+		flow->overflow = false;
+		for (i = 0; i < z_info->max_flow_depth; i++)
+			flow->bucket[i] = -1;
+
+		/* Grids that have become walls or stopped being walls */
+		for (i = 0; i < flow->changed_n; i++)
+			flow_check(c, flow->changed[i].y, flow->changed[i].x);
+
+		/* Repair outward from them, or start again if it gets too big */
+		if (!flow_repair(c))
+			flow_rebuild(c, grid);
+	} else {
+		flow_rebuild(c, grid);
+	}
+
+	flow->changed_n = 0;
 }
 
 /**
@@ -315,7 +315,7 @@ bool square_ismark(struct chunk *c, int y, int x) {
  */
 bool square_isglow(struct chunk *c, int y, int x) {
 	assert(square_in_bounds(c, y, x));
-	return sqinfo_has(c->squares[y][x].info, SQUARE_GLOW);
+	return cave_plane_has(c, PLANE_GLOW, y, x);
 }
 
 /**
@@ -341,7 +341,7 @@ bool square_isroom(struct chunk *c, int y, int x) {
  */
 bool square_isseen(struct chunk *c, int y, int x) {
 	assert(square_in_bounds(c, y, x));
-	return sqinfo_has(c->squares[y][x].info, SQUARE_SEEN);
+	return cave_plane_has(c, PLANE_SEEN, y, x);
 }
 
 /**
@@ -349,7 +349,7 @@ bool square_isseen(struct chunk *c, int y, int x) {
  */
 bool square_isview(struct chunk *c, int y, int x) {
 	assert(square_in_bounds(c, y, x));
-	return sqinfo_has(c->squares[y][x].info, SQUARE_VIEW);
+	return cave_plane_has(c, PLANE_VIEW, y, x);
 }
 
 /**
@@ -357,7 +357,7 @@ bool square_isview(struct chunk *c, int y, int x) {
  */
 bool square_wasseen(struct chunk *c, int y, int x) {
 	assert(square_in_bounds(c, y, x));
-	return sqinfo_has(c->squares[y][x].info, SQUARE_WASSEEN);
+	return cave_plane_has(c, PLANE_WASSEEN, y, x);
 }
 
 /**
@@ -389,7 +389,7 @@ bool square_isinvis(struct chunk *c, int y, int x) {
  */
 bool square_iswall_inner(struct chunk *c, int y, int x) {
 	assert(square_in_bounds(c, y, x));
-	return sqinfo_has(c->squares[y][x].info, SQUARE_WALL_INNER);
+	return cave_plane_has(c, PLANE_WALL_INNER, y, x);
 }
 
 /**
@@ -397,7 +397,7 @@ bool square_iswall_inner(struct chunk *c, int y, int x) {
  */
 bool square_iswall_outer(struct chunk *c, int y, int x) {
 	assert(square_in_bounds(c, y, x));
-	return sqinfo_has(c->squares[y][x].info, SQUARE_WALL_OUTER);
+	return cave_plane_has(c, PLANE_WALL_OUTER, y, x);
 }
 
 /**
@@ -405,7 +405,7 @@ bool square_iswall_outer(struct chunk *c, int y, int x) {
  */
 bool square_iswall_solid(struct chunk *c, int y, int x) {
 	assert(square_in_bounds(c, y, x));
-	return sqinfo_has(c->squares[y][x].info, SQUARE_WALL_SOLID);
+	return cave_plane_has(c, PLANE_WALL_SOLID, y, x);
 }
 
 /**
@@ -750,6 +750,11 @@ void square_set_feat(struct chunk *c, int y, int x, int feat)
 	/* Make the change */
 	c->squares[y][x].feat = feat;
 
+	/* The flow only needs to know about new or removed walls */
+	if (tf_has(f_info[current_feat].flags, TF_NO_FLOW) !=
+		tf_has(f_info[feat].flags, TF_NO_FLOW))
+		cave_note_flow(c, y, x);
+
 	/* Make the new terrain feel at home */
 	if (character_dungeon) {
 		/* Remove traps if necessary */
@@ -760,9 +765,9 @@ void square_set_feat(struct chunk *c, int y, int x, int feat)
 		square_light_spot(c, y, x);
 	} else {
 		/* Make sure no incorrect wall flags set for dungeon generation */
-		sqinfo_off(c->squares[y][x].info, SQUARE_WALL_INNER);
-		sqinfo_off(c->squares[y][x].info, SQUARE_WALL_OUTER);
-		sqinfo_off(c->squares[y][x].info, SQUARE_WALL_SOLID);
+		cave_plane_off(c, PLANE_WALL_INNER, y, x);
+		cave_plane_off(c, PLANE_WALL_OUTER, y, x);
+		cave_plane_off(c, PLANE_WALL_SOLID, y, x);
 	}
 }
 
@@ -935,3 +940,65 @@ void square_mark(struct chunk *c, int y, int x) {
 void square_unmark(struct chunk *c, int y, int x) {
 	sqinfo_off(c->squares[y][x].info, SQUARE_MARK);
 }
+
+/**
+ * Test, set or clear any square flag, wherever it is held
+ */
+bool square_flag_has(struct chunk *c, int y, int x, int flag) {
+	int plane = square_flag_plane(flag);
+	if (plane < 0)
+		return sqinfo_has(c->squares[y][x].info, flag);
+	return cave_plane_has(c, plane, y, x);
+}
+
+void square_flag_on(struct chunk *c, int y, int x, int flag) {
+	int plane = square_flag_plane(flag);
+	if (plane < 0)
+		sqinfo_on(c->squares[y][x].info, flag);
+	else
+		cave_plane_on(c, plane, y, x);
+}
+
+void square_flag_off(struct chunk *c, int y, int x, int flag) {
+	int plane = square_flag_plane(flag);
+	if (plane < 0)
+		sqinfo_off(c->squares[y][x].info, flag);
+	else
+		cave_plane_off(c, plane, y, x);
+}
+
+/**
+ * Get the full set of a square's flags, including those held in bit planes,
+ * for copying or saving
+ */
+void square_get_info(struct chunk *c, int y, int x, bitflag *info) {
+	int flag;
+
+	sqinfo_copy(info, c->squares[y][x].info);
+	for (flag = FLAG_START; flag < SQUARE_MAX; flag++) {
+		int plane = square_flag_plane(flag);
+		if (plane >= 0 && cave_plane_has(c, plane, y, x))
+			sqinfo_on(info, flag);
+	}
+}
+
+/**
+ * Set the full set of a square's flags, as got by square_get_info()
+ */
+void square_set_info(struct chunk *c, int y, int x, const bitflag *info) {
+	bitflag copy[SQUARE_SIZE];
+	int flag;
+
+	/* The source may be the square's own info */
+	sqinfo_copy(copy, info);
+	sqinfo_copy(c->squares[y][x].info, copy);
+	for (flag = FLAG_START; flag < SQUARE_MAX; flag++) {
+		int plane = square_flag_plane(flag);
+		if (plane < 0) continue;
+		sqinfo_off(c->squares[y][x].info, flag);
+		if (sqinfo_has(copy, flag))
+			cave_plane_on(c, plane, y, x);
+		else
+			cave_plane_off(c, plane, y, x);
+	}
+}
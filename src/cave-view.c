@@ -20,6 +20,7 @@
 #include "cave.h"
 #include "cmds.h"
 #include "init.h"
+#include "mon-make.h"
 #include "monster.h"
 #include "player-calcs.h"
 #include "player-timed.h"
@@ -431,37 +432,29 @@ bool los(struct chunk *c, int y1, int x1, int y2, int x2)
  */
 void forget_view(struct chunk *c)
 {
-	int x, y;
-
-	for (y = 0; y < c->height; y++) {
-		for (x = 0; x < c->width; x++) {
-			if (!square_isview(c, y, x))
-				continue;
-			sqinfo_off(c->squares[y][x].info, SQUARE_VIEW);
-			sqinfo_off(c->squares[y][x].info, SQUARE_SEEN);
-			square_light_spot(c, y, x);
-		}
-	}
-}
+	int i = -1;
 
+	while ((i = cave_plane_next(c, PLANE_VIEW, i + 1)) >= 0) {
+		int y = i / c->width;
+		int x = i % c->width;
 
+		cave_plane_off(c, PLANE_VIEW, y, x);
+		cave_plane_off(c, PLANE_SEEN, y, x);
+		square_light_spot(c, y, x);
+	}
+}
 
 /**
  * Mark the currently seen grids, then wipe in preparation for recalculating
  */
 static void mark_wasseen(struct chunk *c) 
 {
-	int x, y;
 	/* Save the old "view" grids for later */
-	for (y = 0; y < c->height; y++) {
-		for (x = 0; x < c->width; x++) {
-			if (square_isseen(c, y, x))
-				sqinfo_on(c->squares[y][x].info, SQUARE_WASSEEN);
-			sqinfo_off(c->squares[y][x].info, SQUARE_VIEW);
-			sqinfo_off(c->squares[y][x].info, SQUARE_SEEN);
-		}
-	}
+	cave_plane_union(c, PLANE_WASSEEN, PLANE_SEEN);
+	cave_plane_wipe(c, PLANE_VIEW);
+	cave_plane_wipe(c, PLANE_SEEN);
 }
+
 /**
  * Like it says on the tin
  */
@@ -469,20 +462,18 @@ static void add_monster_lights(struct chunk *c, struct loc from)
 {
 	int i, j, k;
 
-	/* Scan monster list and add monster lights */
-	for (k = 1; k < cave_monster_max(c); k++) {
+	/* Scan the light-carrying monsters and add their lights */
+	for (k = mon_index_next_light(c, 0); k; k = mon_index_next_light(c, k)) {
 		/* Check the k'th monster */
 		struct monster *m = cave_monster(c, k);
+		bool in_los;
 
-		bool in_los = los(c, from.y, from.x, m->fy, m->fx);
-
-		/* Skip dead monsters */
-		if (!m->race)
+		/* Skip monsters too far away to light anything in view */
+		if (ABS(m->fy - from.y) > z_info->max_sight + 1 ||
+			ABS(m->fx - from.x) > z_info->max_sight + 1)
 			continue;
 
-		/* Skip monsters not carrying light */
-		if (!rf_has(m->race->flags, RF_HAS_LIGHT))
-			continue;
+		in_los = los(c, from.y, from.x, m->fy, m->fx);
 
 		/* Light a 3x3 box centered on the monster */
 		for (i = -1; i <= 1; i++)
@@ -503,22 +494,19 @@ static void add_monster_lights(struct chunk *c, struct loc from)
 					continue;
 
 				/* Mark the square lit and seen */
-				sqinfo_on(c->squares[sy][sx].info, SQUARE_VIEW);
-				sqinfo_on(c->squares[sy][sx].info, SQUARE_SEEN);
+				cave_plane_on(c, PLANE_VIEW, sy, sx);
+				cave_plane_on(c, PLANE_SEEN, sy, sx);
 			}
 	}
 }
 
 /**
- * Update view for a single square
+ * Update view for a single square whose "seen" state has changed
  */
-static void update_one(struct chunk *c, int y, int x, int blind)
+static void update_one(struct chunk *c, int y, int x)
 {
-	if (blind)
-		sqinfo_off(c->squares[y][x].info, SQUARE_SEEN);
-
 	/* Square went from unseen -> seen */
-	if (square_isseen(c, y, x) && !square_wasseen(c, y, x)) {
+	if (square_isseen(c, y, x)) {
 		if (square_isfeel(c, y, x)) {
 			c->feeling_squares++;
 			sqinfo_off(c->squares[y][x].info, SQUARE_FEEL);
@@ -532,13 +520,10 @@ static void update_one(struct chunk *c, int y, int x, int blind)
 
 		square_note_spot(c, y, x);
 		square_light_spot(c, y, x);
-	}
-
-	/* Square went from seen -> unseen */
-	if (!square_isseen(c, y, x) && square_wasseen(c, y, x))
+	} else {
+		/* Square went from seen -> unseen */
 		square_light_spot(c, y, x);
-
-	sqinfo_off(c->squares[y][x].info, SQUARE_WASSEEN);
+	}
 }
 
 /**
@@ -551,10 +536,10 @@ static void become_viewable(struct chunk *c, int y, int x, int lit, int py, int
 	if (square_isview(c, y, x))
 		return;
 
-	sqinfo_on(c->squares[y][x].info, SQUARE_VIEW);
+	cave_plane_on(c, PLANE_VIEW, y, x);
 
 	if (lit)
-		sqinfo_on(c->squares[y][x].info, SQUARE_SEEN);
+		cave_plane_on(c, PLANE_SEEN, y, x);
 
 	if (square_isglow(c, y, x)) {
 		if (square_iswall(c, y, x)) {
@@ -565,7 +550,7 @@ static void become_viewable(struct chunk *c, int y, int x, int lit, int py, int
 			yc = (y < py) ? (y + 1) : (y > py) ? (y - 1) : y;
 		}
 		if (square_isglow(c, yc, xc))
-			sqinfo_on(c->squares[y][x].info, SQUARE_SEEN);
+			cave_plane_on(c, PLANE_SEEN, y, x);
 	}
 }
 
@@ -645,15 +630,27 @@ static void update_view_one(struct chunk *c, int y, int x, int radius, int py, i
 
 /**
  * Update the player's current view
+ *
+ * No grid further than z_info->max_sight from the player can be in view, so
+ * only the box of that radius around the player is recalculated.  The grids
+ * to redraw are then exactly those whose SQUARE_SEEN and SQUARE_WASSEEN bit
+ * planes differ, which are found a word at a time.
  */
 void update_view(struct chunk *c, struct player *p)
 {
-	int x, y;
+	int i, x, y;
+	int y1, x1, y2, x2;
 
 	int radius;
 
 	mark_wasseen(c);
 
+	/* Bound the part of the level which can be in view */
+	y1 = MAX(p->py - z_info->max_sight, 0);
+	x1 = MAX(p->px - z_info->max_sight, 0);
+	y2 = MIN(p->py + z_info->max_sight, c->height - 1);
+	x2 = MIN(p->px + z_info->max_sight, c->width - 1);
+
 	/* Extract "radius" value */
 	radius = p->state.cur_light;
 
@@ -663,19 +660,24 @@ void update_view(struct chunk *c, struct player *p)
 	add_monster_lights(c, loc(p->px, p->py));
 
 	/* Assume we can view the player grid */
-	sqinfo_on(c->squares[p->py][p->px].info, SQUARE_VIEW);
+	cave_plane_on(c, PLANE_VIEW, p->py, p->px);
 	if (radius > 0 || square_isglow(c, p->py, p->px))
-		sqinfo_on(c->squares[p->py][p->px].info, SQUARE_SEEN);
+		cave_plane_on(c, PLANE_SEEN, p->py, p->px);
 
 	/* View squares we have LOS to */
-	for (y = 0; y < c->height; y++)
-		for (x = 0; x < c->width; x++)
+	for (y = y1; y <= y2; y++)
+		for (x = x1; x <= x2; x++)
 			update_view_one(c, y, x, radius, p->py, p->px);
 
-	/* Complete the algorithm */
-	for (y = 0; y < c->height; y++)
-		for (x = 0; x < c->width; x++)
-			update_one(c, y, x, p->timed[TMD_BLIND]);
+	/* Blind players see nothing */
+	if (p->timed[TMD_BLIND])
+		cave_plane_wipe(c, PLANE_SEEN);
+
+	/* Complete the algorithm for every grid whose view has changed */
+	i = -1;
+	while ((i = cave_plane_next_diff(c, PLANE_SEEN, PLANE_WASSEEN, i + 1)) >= 0)
+		update_one(c, i / c->width, i % c->width);
+	cave_plane_wipe(c, PLANE_WASSEEN);
 }
 
 
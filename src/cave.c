@@ -132,26 +132,59 @@ void set_terrain(void)
  * Allocate a new chunk of the world
  */
 struct chunk *cave_new(int height, int width) {
-	int y, x;
+	int y;
 
 	struct chunk *c = mem_zalloc(sizeof *c);
 	c->height = height;
 	c->width = width;
-	c->feat_count = mem_zalloc((z_info->f_max + 1) * sizeof(int));
-
-	c->squares = mem_zalloc(c->height * sizeof(struct square*));
-	for (y = 0; y < c->height; y++) {
-		c->squares[y] = mem_zalloc(c->width * sizeof(struct square));
-		for (x = 0; x < c->width; x++)
-			c->squares[y][x].info = mem_zalloc(SQUARE_SIZE * sizeof(bitflag));
-	}
+	c->arena = mem_arena_new();
+	c->feat_count = mem_arena_zalloc(c->arena,
+									 (z_info->f_max + 1) * sizeof(int));
+
+	/* All the squares live in one block, indexed by row */
+	c->square_data = mem_arena_zalloc(c->arena,
+									  c->height * c->width * sizeof(struct square));
+	c->squares = mem_arena_zalloc(c->arena,
+								  c->height * sizeof(struct square*));
+	for (y = 0; y < c->height; y++)
+		c->squares[y] = c->square_data + y * c->width;
+
+	/* The bit planes for the commonest square flags */
+	c->plane_words = (c->height * c->width + PLANE_WORD_BITS - 1)
+		/ PLANE_WORD_BITS;
+	c->planes = mem_arena_zalloc(c->arena,
+								 PLANE_MAX * c->plane_words * sizeof(u64b));
 
 	c->objects = mem_zalloc(OBJECT_LIST_SIZE * sizeof(struct object*));
 	c->obj_max = OBJECT_LIST_SIZE - 1;
 
-	c->monsters = mem_zalloc(z_info->level_monster_max *sizeof(struct monster));
+	c->monsters = mem_arena_zalloc(c->arena, z_info->level_monster_max
+								   * sizeof(struct monster));
 	c->mon_max = 1;
 	c->mon_current = -1;
+	c->mon_live = mem_arena_zalloc(c->arena, (z_info->level_monster_max
+		+ MON_WORD_BITS - 1) / MON_WORD_BITS * sizeof(u64b));
+	c->mon_waiting = mem_arena_zalloc(c->arena, (z_info->level_monster_max
+		+ MON_WORD_BITS - 1) / MON_WORD_BITS * sizeof(u64b));
+	c->mon_light = mem_arena_zalloc(c->arena, (z_info->level_monster_max
+		+ MON_WORD_BITS - 1) / MON_WORD_BITS * sizeof(u64b));
+
+	/* Monsters are also kept in lists by map region */
+	c->mon_region_wid = ((width - 1) >> MON_REGION_SHIFT) + 1;
+	c->mon_region_count = c->mon_region_wid
+		* (((height - 1) >> MON_REGION_SHIFT) + 1);
+	c->mon_region = mem_arena_zalloc(c->arena, c->mon_region_count
+									 * sizeof(s16b));
+	c->mon_region_next = mem_arena_zalloc(c->arena, z_info->level_monster_max
+										  * sizeof(s16b));
+	c->mon_region_prev = mem_arena_zalloc(c->arena, z_info->level_monster_max
+										  * sizeof(s16b));
+	c->mon_found = mem_arena_zalloc(c->arena, z_info->level_monster_max
+									* sizeof(s16b));
+
+	/* Flow data could be anywhere until it is first forgotten */
+	c->flow_min = loc(0, 0);
+	c->flow_max = loc(width - 1, height - 1);
 
 	c->created_at = turn;
 	return c;
@@ -165,24 +198,168 @@ void cave_free(struct chunk *c) {
 
 	for (y = 0; y < c->height; y++) {
 		for (x = 0; x < c->width; x++) {
-			mem_free(c->squares[y][x].info);
 			if (c->squares[y][x].trap)
 				square_free_trap(c, y, x);
 			if (c->squares[y][x].obj)
 				object_pile_free(c->squares[y][x].obj);
 		}
-		mem_free(c->squares[y]);
 	}
-	mem_free(c->squares);
-
-	mem_free(c->feat_count);
 	mem_free(c->objects);
-	mem_free(c->monsters);
+	mem_free(c->obj_free);
+	mem_free(c->saved);
+	mem_arena_free(c->arena);
 	if (c->name)
 		string_free(c->name);
 	mem_free(c);
 }
 
+/**
+ * Get the bit plane that holds a square flag, or -1 if it is held in the
+ * square's info
+ */
+int square_flag_plane(int flag)
+{
+	switch (flag) {
+		case SQUARE_GLOW: return PLANE_GLOW;
+		case SQUARE_VIEW: return PLANE_VIEW;
+		case SQUARE_SEEN: return PLANE_SEEN;
+		case SQUARE_WASSEEN: return PLANE_WASSEEN;
+		case SQUARE_WALL_INNER: return PLANE_WALL_INNER;
+		case SQUARE_WALL_OUTER: return PLANE_WALL_OUTER;
+		case SQUARE_WALL_SOLID: return PLANE_WALL_SOLID;
+		default: return -1;
+	}
+}
+
+/**
+ * The words of one bit plane
+ */
+static u64b *cave_plane(struct chunk *c, int plane)
+{
+	assert(plane >= 0 && plane < PLANE_MAX);
+	return c->planes + plane * c->plane_words;
+}
+
+bool cave_plane_has(struct chunk *c, int plane, int y, int x)
+{
+	int i = y * c->width + x;
+	return (cave_plane(c, plane)[i / PLANE_WORD_BITS]
+			>> (i % PLANE_WORD_BITS)) & 1;
+}
+
+void cave_plane_on(struct chunk *c, int plane, int y, int x)
+{
+	int i = y * c->width + x;
+	cave_plane(c, plane)[i / PLANE_WORD_BITS] |=
+		(u64b)1 << (i % PLANE_WORD_BITS);
+}
+
+void cave_plane_off(struct chunk *c, int plane, int y, int x)
+{
+	int i = y * c->width + x;
+	cave_plane(c, plane)[i / PLANE_WORD_BITS] &=
+		~((u64b)1 << (i % PLANE_WORD_BITS));
+}
+
+/**
+ * Clear a plane for the whole chunk
+ */
+void cave_plane_wipe(struct chunk *c, int plane)
+{
+	memset(cave_plane(c, plane), 0, c->plane_words * sizeof(u64b));
+}
+
+/**
+ * Set every bit in plane `dest` that is set in plane `src`
+ */
+void cave_plane_union(struct chunk *c, int dest, int src)
+{
+	u64b *d = cave_plane(c, dest);
+	const u64b *s = cave_plane(c, src);
+	int i;
+
+	for (i = 0; i < c->plane_words; i++)
+		d[i] |= s[i];
+}
+
+/**
+ * Count the grids of the chunk with a plane's bit set
+ */
+int cave_plane_count(struct chunk *c, int plane)
+{
+	const u64b *p = cave_plane(c, plane);
+	int i, n = 0;
+
+	for (i = 0; i < c->plane_words; i++) {
+		u64b w = p[i];
+
+		/* Count bits in parallel */
+		w = w - ((w >> 1) & 0x5555555555555555ULL);
+		w = (w & 0x3333333333333333ULL) + ((w >> 2) & 0x3333333333333333ULL);
+		w = (w + (w >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+		n += (int)((w * 0x0101010101010101ULL) >> 56);
+	}
+
+	return n;
+}
+
+/**
+ * Position of the lowest set bit of a non-zero word
+ */
+static int plane_low_bit(u64b w)
+{
+	int b = 0;
+
+	if (!(w & 0xFFFFFFFFULL)) { w >>= 32; b += 32; }
+	if (!(w & 0xFFFF)) { w >>= 16; b += 16; }
+	if (!(w & 0xFF)) { w >>= 8; b += 8; }
+	if (!(w & 0xF)) { w >>= 4; b += 4; }
+	if (!(w & 0x3)) { w >>= 2; b += 2; }
+	if (!(w & 0x1)) b += 1;
+
+	return b;
+}
+
+/**
+ * Find the first grid index at or after `start` whose bit is set in `p1`
+ * but not the same in `p2` (or just set in `p1` if `p2` is NULL), skipping
+ * whole words at a time; -1 if there is none
+ */
+static int plane_next(struct chunk *c, const u64b *p1, const u64b *p2,
+					  int start)
+{
+	int i = start / PLANE_WORD_BITS;
+	u64b w;
+
+	if (start >= c->height * c->width) return -1;
+
+	w = (p1[i] ^ (p2 ? p2[i] : 0)) & (~(u64b)0 << (start % PLANE_WORD_BITS));
+	while (!w) {
+		if (++i == c->plane_words) return -1;
+		w = p1[i] ^ (p2 ? p2[i] : 0);
+	}
+
+	return i * PLANE_WORD_BITS + plane_low_bit(w);
+}
+
+/**
+ * Find the first grid (as y * width + x) at or after `start` with a plane's
+ * bit set, or -1 if there is none
+ */
+int cave_plane_next(struct chunk *c, int plane, int start)
+{
+	return plane_next(c, cave_plane(c, plane), NULL, start);
+}
+
+/**
+ * Find the first grid (as y * width + x) at or after `start` whose bits in
+ * two planes differ, or -1 if there is none
+ */
+int cave_plane_next_diff(struct chunk *c, int plane1, int plane2, int start)
+{
+	return plane_next(c, cave_plane(c, plane1), cave_plane(c, plane2), start);
+}
+
 
 /**
  * Standard "find me a location" function
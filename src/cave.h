@@ -22,6 +22,7 @@
 #include "z-type.h"
 #include "z-bitflag.h"
 
+struct flow_field;
 struct player;
 struct monster;
 
@@ -63,6 +64,28 @@ enum
 #define sqinfo_inter(f1, f2)       flag_inter(f1, f2, SQUARE_SIZE)
 #define sqinfo_diff(f1, f2)        flag_diff(f1, f2, SQUARE_SIZE)
 
+/**
+ * Square flags which are kept in per-chunk bit planes (one bit per grid, in
+ * storage order) instead of in each square's info, so that level-wide scans
+ * and updates can work a word at a time.  They must be accessed through the
+ * square_* and cave_plane_* functions, never with sqinfo_* on the info.
+ */
+enum
+{
+	PLANE_GLOW,
+	PLANE_VIEW,
+	PLANE_SEEN,
+	PLANE_WASSEEN,
+	PLANE_WALL_INNER,
+	PLANE_WALL_OUTER,
+	PLANE_WALL_SOLID,
+	PLANE_MAX
+};
+
+#define PLANE_WORD_BITS            64
+#define MON_WORD_BITS              64
+#define MON_REGION_SHIFT           3
+
 
 /**
  * Terrain flags
@@ -132,7 +155,7 @@ struct grid_data {
 
 struct square {
 	byte feat;
-	bitflag *info;
+	bitflag info[SQUARE_SIZE];
 	byte cost;
 	byte when;
 	s16b mon;
@@ -156,17 +179,45 @@ struct chunk {
 	u16b feeling_squares; /* How many feeling squares the player has visited */
 	int *feat_count;
 
-	struct square **squares;
+	struct mem_arena *arena;	/* Storage released along with the chunk */
+
+	struct square **squares;	/* Row pointers into square_data */
+	struct square *square_data;	/* All squares, one row after another */
+
+	u64b *planes;			/* PLANE_MAX bit planes of plane_words words */
+	int plane_words;
+
+	struct flow_field *flow;	/* Kept between cave_update_flow() calls */
+	struct loc flow_min;	/* Bounding box of grids with flow data */
+	struct loc flow_max;
 
 	struct object **objects;
 	u16b obj_max;
+	u64b *obj_free;			/* Bitmap of object list slots that may be free */
+	u16b obj_free_max;		/* The obj_max that obj_free was built for */
+	int obj_free_first;		/* First word of obj_free that may be non-zero */
 
 	struct monster *monsters;
 	u16b mon_max;
 	u16b mon_cnt;
 	int mon_current;
+	u64b *mon_live;			/* Bitmap of monster list slots in use */
+	u64b *mon_waiting;		/* Bitmap of monsters yet to act this game turn */
+	byte mon_waiting_energy;	/* No waiting monster has more energy */
+	byte mon_handled_energy;	/* No handled monster has more energy */
+	s16b *mon_region;		/* First monster in each region of the map */
+	s16b *mon_region_next;	/* Next monster in the same region */
+	s16b *mon_region_prev;	/* Previous monster in the same region */
+	int mon_region_wid;		/* Regions across the map */
+	int mon_region_count;
+	s16b *mon_found;		/* Room for the results of one area query */
+	u64b *mon_light;		/* Bitmap of monsters carrying light */
 
 	struct trap *trap_current;
+
+	byte *saved;			/* A stored chunk as last written to the savefile */
+	u32b saved_size;
+	bool lent;				/* Things have been copied out of the chunk */
 };
 
 /*** Feature Indexes (see "lib/gamedata/terrain.txt") ***/
@@ -224,6 +275,7 @@ void wiz_light(struct chunk *c, bool full);
 void cave_illuminate(struct chunk *c, bool daytime);
 void cave_update_flow(struct chunk *c);
 void cave_forget_flow(struct chunk *c);
+void cave_note_flow(struct chunk *c, int y, int x);
 
 /* cave-square.c */
 /**
@@ -355,10 +407,25 @@ void square_forget(struct chunk *c, int y, int x);
 void square_mark(struct chunk *c, int y, int x);
 void square_unmark(struct chunk *c, int y, int x);
 
+bool square_flag_has(struct chunk *c, int y, int x, int flag);
+void square_flag_on(struct chunk *c, int y, int x, int flag);
+void square_flag_off(struct chunk *c, int y, int x, int flag);
+void square_get_info(struct chunk *c, int y, int x, bitflag *info);
+void square_set_info(struct chunk *c, int y, int x, const bitflag *info);
+
 /* cave.c */
 void set_terrain(void);
 struct chunk *cave_new(int height, int width);
 void cave_free(struct chunk *c);
+int square_flag_plane(int flag);
+bool cave_plane_has(struct chunk *c, int plane, int y, int x);
+void cave_plane_on(struct chunk *c, int plane, int y, int x);
+void cave_plane_off(struct chunk *c, int plane, int y, int x);
+void cave_plane_wipe(struct chunk *c, int plane);
+void cave_plane_union(struct chunk *c, int dest, int src);
+int cave_plane_count(struct chunk *c, int plane);
+int cave_plane_next(struct chunk *c, int plane, int start);
+int cave_plane_next_diff(struct chunk *c, int plane1, int plane2, int start);
 void scatter(struct chunk *c, int *yp, int *xp, int y, int x, int d, bool need_los);
 
 struct monster *cave_monster(struct chunk *c, int idx);
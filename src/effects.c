@@ -1346,12 +1346,13 @@ bool effect_handler_DETECT_OBJECTS(effect_handler_context_t *context)
  */
 bool effect_handler_DETECT_VISIBLE_MONSTERS(effect_handler_context_t *context)
 {
-	int i, x, y;
+	int i, n;
 	int x1, x2, y1, y2;
 	int y_dist = context->value.dice;
 	int x_dist = context->value.sides;
 
 	bool monsters = false;
+	s16b *found;
 
 	/* Pick an area to detect */
 	y1 = player->py - y_dist;
@@ -1364,19 +1365,11 @@ bool effect_handler_DETECT_VISIBLE_MONSTERS(effect_handler_context_t *context)
 	if (y2 > cave->height - 1) y2 = cave->height - 1;
 	if (x2 > cave->width - 1) x2 = cave->width - 1;
 
-	/* Scan monsters */
-	for (i = 1; i < cave_monster_max(cave); i++) {
-		struct monster *mon = cave_monster(cave, i);
-
-		/* Skip dead monsters */
-		if (!mon->race) continue;
-
-		/* Location */
-		y = mon->fy;
-		x = mon->fx;
-
-		/* Only detect nearby monsters */
-		if (x < x1 || y < y1 || x > x2 || y > y2) continue;
+	/* Scan monsters in the area */
+	found = cave->mon_found;
+	n = mon_index_rect(cave, y1, x1, y2, x2, found);
+	for (i = 0; i < n; i++) {
+		struct monster *mon = cave_monster(cave, found[i]);
 
 		/* Detect all non-invisible, obvious monsters */
 		if (!rf_has(mon->race->flags, RF_INVISIBLE) &&
@@ -1415,12 +1408,13 @@ bool effect_handler_DETECT_VISIBLE_MONSTERS(effect_handler_context_t *context)
  */
 bool effect_handler_DETECT_INVISIBLE_MONSTERS(effect_handler_context_t *context)
 {
-	int i, x, y;
+	int i, n;
 	int x1, x2, y1, y2;
 	int y_dist = context->value.dice;
 	int x_dist = context->value.sides;
 
 	bool monsters = false;
+	s16b *found;
 
 	/* Pick an area to detect */
 	y1 = player->py - y_dist;
@@ -1433,23 +1427,15 @@ bool effect_handler_DETECT_INVISIBLE_MONSTERS(effect_handler_context_t *context)
 	if (y2 > cave->height - 1) y2 = cave->height - 1;
 	if (x2 > cave->width - 1) x2 = cave->width - 1;
 
-	/* Scan monsters */
-	for (i = 1; i < cave_monster_max(cave); i++) {
-		struct monster *mon = cave_monster(cave, i);
+	/* Scan monsters in the area */
+	found = cave->mon_found;
+	n = mon_index_rect(cave, y1, x1, y2, x2, found);
+	for (i = 0; i < n; i++) {
+		struct monster *mon = cave_monster(cave, found[i]);
 		struct monster_lore *lore;
 
-		/* Skip dead monsters */
-		if (!mon->race) continue;
-
 		lore = get_lore(mon->race);
 
-		/* Location */
-		y = mon->fy;
-		x = mon->fx;
-
-		/* Only detect nearby monsters */
-		if (x < x1 || y < y1 || x > x2 || y > y2) continue;
-
 		/* Detect invisible monsters */
 		if (rf_has(mon->race->flags, RF_INVISIBLE)) {
 			/* Take note that they are invisible */
@@ -1520,12 +1506,13 @@ bool effect_handler_IDENTIFY(effect_handler_context_t *context)
  */
 bool effect_handler_DETECT_EVIL(effect_handler_context_t *context)
 {
-	int i, x, y;
+	int i, n;
 	int x1, x2, y1, y2;
 	int y_dist = context->value.dice;
 	int x_dist = context->value.sides;
 
 	bool monsters = false;
+	s16b *found;
 
 	/* Pick an area to detect */
 	y1 = player->py - y_dist;
@@ -1538,23 +1525,15 @@ bool effect_handler_DETECT_EVIL(effect_handler_context_t *context)
 	if (y2 > cave->height - 1) y2 = cave->height - 1;
 	if (x2 > cave->width - 1) x2 = cave->width - 1;
 
-	/* Scan monsters */
-	for (i = 1; i < cave_monster_max(cave); i++) {
-		struct monster *mon = cave_monster(cave, i);
+	/* Scan monsters in the area */
+	found = cave->mon_found;
+	n = mon_index_rect(cave, y1, x1, y2, x2, found);
+	for (i = 0; i < n; i++) {
+		struct monster *mon = cave_monster(cave, found[i]);
 		struct monster_lore *lore;
 
-		/* Skip dead monsters */
-		if (!mon->race) continue;
-
 		lore = get_lore(mon->race);
 
-		/* Location */
-		y = mon->fy;
-		x = mon->fx;
-
-		/* Only detect nearby monsters */
-		if (x < x1 || y < y1 || x > x2 || y > y2) continue;
-
 		/* Detect evil monsters */
 		if (rf_has(mon->race->flags, RF_EVIL)) {
 			/* Take note that they are evil */
@@ -2175,34 +2154,29 @@ bool effect_handler_ACQUIRE(effect_handler_context_t *context)
  */
 bool effect_handler_WAKE(effect_handler_context_t *context)
 {
-	int i;
+	int i, n;
 	bool sleep = false;
 	int midx = cave->mon_current;
 	struct monster *who = midx > 0 ? cave_monster(cave, midx) : NULL;
 	struct trap *trap = cave->trap_current;
+	int radius = z_info->max_sight * 2;
+	s16b *found = cave->mon_found;
 
-	/* Wake everyone nearby */
-	for (i = 1; i < cave_monster_max(cave); i++) {
-		struct monster *mon = cave_monster(cave, i);
-		int radius = z_info->max_sight * 2;
-
-		/* Paranoia -- Skip dead monsters */
-		if (!mon->race) continue;
+	/* Find everyone nearby */
+	if (who) {
+		/* Woken by monster */
+		n = mon_index_radius(cave, who->fy, who->fx, radius - 1, found);
+	} else if (trap) {
+		/* Woken by trap */
+		n = mon_index_radius(cave, trap->fy, trap->fx, radius - 1, found);
+	} else {
+		/* Woken by player */
+		n = mon_index_radius(cave, player->py, player->px, radius - 1, found);
+	}
 
-		/* Skip monsters too far away */
-		if (who) {
-			/* Woken by monster */
-			if (distance(who->fy, who->fx, mon->fy, mon->fx) >= radius)
-				continue;
-		} else if (trap) {
-			/* Woken by trap */
-			if (distance(trap->fy, trap->fx, mon->fy, mon->fx) >= radius)
-				continue;
-		} else {
-			/* Woken by player */
-			if (distance(player->py, player->px, mon->fy, mon->fx) >= radius)
-				continue;
-		}
+	/* Wake everyone nearby */
+	for (i = 0; i < n; i++) {
+		struct monster *mon = cave_monster(cave, found[i]);
 
 		/* Wake up nearby sleeping monsters */
 		if (mon->m_timed[MON_TMD_SLEEP]) {
@@ -2931,7 +2905,7 @@ bool effect_handler_DESTRUCTION(effect_handler_context_t *context)
 			sqinfo_off(cave->squares[y][x].info, SQUARE_VAULT);
 
 			/* Lose light */
-			sqinfo_off(cave->squares[y][x].info, SQUARE_GLOW);
+			square_flag_off(cave, y, x, SQUARE_GLOW);
 			square_light_spot(cave, y, x);
 
 			/* Deal with player later */
@@ -3055,7 +3029,7 @@ bool effect_handler_EARTHQUAKE(effect_handler_context_t *context)
 			sqinfo_off(cave->squares[yy][xx].info, SQUARE_VAULT);
 
 			/* Lose light */
-			sqinfo_off(cave->squares[yy][xx].info, SQUARE_GLOW);
+			square_flag_off(cave, yy, xx, SQUARE_GLOW);
 
 			/* Skip the epicenter */
 			if (!dx && !dy) continue;
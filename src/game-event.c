@@ -23,99 +23,154 @@
 
 struct event_handler_entry
 {
-	struct event_handler_entry *next;	
 	game_event_handler *fn;
 	void *user;
 };
 
-static struct event_handler_entry *event_handlers[N_GAME_EVENTS];
+/**
+ * The handlers for one event type, kept in a contiguous array in the order
+ * they were added.  Entries removed while the type is being dispatched are
+ * only cleared, and the array is compacted once the dispatch has finished.
+ */
+struct event_handler_set
+{
+	struct event_handler_entry *entries;
+	size_t count;
+	size_t alloc;
+	int dispatching;
+	bool removed;
+};
+
+static struct event_handler_set event_handlers[N_GAME_EVENTS];
+
+/**
+ * Map grids queued for a single EVENT_MAP_POINTS signal; the bitmap stops
+ * the same grid being queued twice.
+ */
+static struct
+{
+	struct loc *grids;
+	int count;
+	int alloc;
+	bitflag *queued;
+	int wid;
+	int hgt;
+	struct loc min;
+	struct loc max;
+	bool flushing;
+} map_points;
+
+#define MAP_POINTS_SIZE FLAG_SIZE(FLAG_START + map_points.wid * map_points.hgt)
+#define MAP_POINTS_FLAG(x, y) (FLAG_START + (y) * map_points.wid + (x))
+
+static void event_handler_compact(struct event_handler_set *set)
+{
+	size_t i, n = 0;
+
+	for (i = 0; i < set->count; i++)
+		if (set->entries[i].fn)
+			set->entries[n++] = set->entries[i];
+
+	set->count = n;
+	set->removed = false;
+}
 
 static void game_event_dispatch(game_event_type type, game_event_data *data)
 {
-	struct event_handler_entry *this = event_handlers[type];
+	struct event_handler_set *set = &event_handlers[type];
+	size_t i;
+
+	/* Let the UI catch up on the map before it hears anything else */
+	if (map_points.count && !map_points.flushing)
+		event_flush_map_points();
 
 	/* 
-	 * Send the word out to all interested event handlers.
+	 * Send the word out to all interested event handlers, most recently
+	 * added first; handlers added during the dispatch are not called.
 	 */
-	while (this)
-	{
+	set->dispatching++;
+	for (i = set->count; i > 0; i--) {
+		struct event_handler_entry *this = &set->entries[i - 1];
+
 		/* Call the handler with the relevant data */
-		this->fn(type, data, this->user);
-		this = this->next;
+		if (this->fn)
+			this->fn(type, data, this->user);
 	}
+	set->dispatching--;
+
+	if (!set->dispatching && set->removed)
+		event_handler_compact(set);
 }
 
 void event_add_handler(game_event_type type, game_event_handler *fn, void *user)
 {
-	struct event_handler_entry *new;
+	struct event_handler_set *set = &event_handlers[type];
 
 	assert(fn != NULL);
 
-	/* Make a new entry */
-	new = mem_alloc(sizeof *new);
-	new->fn = fn;
-	new->user = user;
+	/* Make room for a new entry */
+	if (set->count == set->alloc) {
+		set->alloc = set->alloc ? set->alloc * 2 : 4;
+		set->entries = mem_realloc(set->entries,
+			set->alloc * sizeof(*set->entries));
+	}
 
-	/* Add it to the head of the appropriate list */
-	new->next = event_handlers[type];
-	event_handlers[type] = new;
+	/* Add it to the end of the appropriate array */
+	set->entries[set->count].fn = fn;
+	set->entries[set->count].user = user;
+	set->count++;
 }
 
 void event_remove_handler(game_event_type type, game_event_handler *fn, void *user)
 {
-	struct event_handler_entry *prev = NULL;
-	struct event_handler_entry *this = event_handlers[type];
-
-	/* Look for the entry in the list */
-	while (this)
-	{
-		/* Check if this is the entry we want to remove */
-		if (this->fn == fn && this->user == user)
-		{
-			if (!prev)
-			{
-				event_handlers[type] = this->next;
-			}
-			else
-			{
-				prev->next = this->next;
-			}
+	struct event_handler_set *set = &event_handlers[type];
+	size_t i;
 
-			mem_free(this);
+	/* Look for the most recently added matching entry */
+	for (i = set->count; i > 0; i--) {
+		struct event_handler_entry *this = &set->entries[i - 1];
+
+		if (this->fn == fn && this->user == user) {
+			/* Don't move entries underneath a dispatch */
+			if (set->dispatching) {
+				this->fn = NULL;
+				set->removed = true;
+			} else {
+				memmove(this, this + 1,
+					(set->count - i) * sizeof(*this));
+				set->count--;
+			}
 			return;
 		}
-
-		prev = this;
-		this = this->next;
 	}
 }
 
 void event_remove_handler_type(game_event_type type)
 {
-	struct event_handler_entry *handler = event_handlers[type];
+	struct event_handler_set *set = &event_handlers[type];
+	size_t i;
 
-	while (handler) {
-		struct event_handler_entry *next = handler->next;
-		mem_free(handler);
-		handler = next;
+	if (set->dispatching) {
+		for (i = 0; i < set->count; i++)
+			set->entries[i].fn = NULL;
+		set->removed = true;
+		return;
 	}
-	event_handlers[type] = NULL;
+
+	mem_free(set->entries);
+	memset(set, 0, sizeof(*set));
 }
 
 void event_remove_all_handlers(void)
 {
 	int type;
-	struct event_handler_entry *handler, *next;
-
-	for (type = 0; type < N_GAME_EVENTS; type++) {
-		handler = event_handlers[type];
-		while (handler) {
-			next = handler->next;
-			mem_free(handler);
-			handler = next;
-		}
-		event_handlers[type] = NULL;
-	}
+
+	for (type = 0; type < N_GAME_EVENTS; type++)
+		event_remove_handler_type(type);
+
+	mem_free(map_points.grids);
+	mem_free(map_points.queued);
+	memset(&map_points, 0, sizeof(map_points));
 }
 
 void event_add_handler_set(game_event_type *type, size_t n_types, game_event_handler *fn, void *user)
@@ -135,6 +190,89 @@ void event_remove_handler_set(game_event_type *type, size_t n_types, game_event_
 }
 
 
+/**
+ * Grow the queued-grid bitmap to cover (x, y), keeping what is queued
+ */
+static void map_points_grow(int x, int y)
+{
+	int wid = MAX(map_points.wid, x + 1);
+	int hgt = MAX(map_points.hgt, y + 1);
+	int i;
+
+	mem_free(map_points.queued);
+	map_points.wid = wid;
+	map_points.hgt = hgt;
+	map_points.queued = mem_zalloc(MAP_POINTS_SIZE * sizeof(bitflag));
+
+	for (i = 0; i < map_points.count; i++)
+		flag_on(map_points.queued, MAP_POINTS_SIZE,
+			MAP_POINTS_FLAG(map_points.grids[i].x, map_points.grids[i].y));
+}
+
+/**
+ * Note that a map grid has changed.  If anything is listening for batches
+ * of grids the point is held until the next event_flush_map_points() (or
+ * the next event of any kind); otherwise it goes out at once as EVENT_MAP.
+ */
+void event_queue_map_point(int x, int y)
+{
+	if (!event_handlers[EVENT_MAP_POINTS].count || map_points.flushing ||
+		x < 0 || y < 0) {
+		event_signal_point(EVENT_MAP, x, y);
+		return;
+	}
+
+	if (x >= map_points.wid || y >= map_points.hgt)
+		map_points_grow(x, y);
+
+	/* Already queued */
+	if (!flag_on(map_points.queued, MAP_POINTS_SIZE, MAP_POINTS_FLAG(x, y)))
+		return;
+
+	if (map_points.count == map_points.alloc) {
+		map_points.alloc = map_points.alloc ? map_points.alloc * 2 : 64;
+		map_points.grids = mem_realloc(map_points.grids,
+			map_points.alloc * sizeof(*map_points.grids));
+	}
+	map_points.grids[map_points.count].x = x;
+	map_points.grids[map_points.count].y = y;
+
+	/* Track the bounding rectangle */
+	if (!map_points.count) {
+		map_points.min = map_points.max = map_points.grids[0];
+	} else {
+		map_points.min.x = MIN(map_points.min.x, x);
+		map_points.min.y = MIN(map_points.min.y, y);
+		map_points.max.x = MAX(map_points.max.x, x);
+		map_points.max.y = MAX(map_points.max.y, y);
+	}
+	map_points.count++;
+}
+
+/**
+ * Send any queued map grids out as a single EVENT_MAP_POINTS
+ */
+void event_flush_map_points(void)
+{
+	game_event_data data;
+	int i;
+
+	if (!map_points.count || map_points.flushing) return;
+
+	data.points.count = map_points.count;
+	data.points.grids = map_points.grids;
+	data.points.min = map_points.min;
+	data.points.max = map_points.max;
+
+	map_points.flushing = true;
+	game_event_dispatch(EVENT_MAP_POINTS, &data);
+	map_points.flushing = false;
+
+	for (i = 0; i < map_points.count; i++)
+		flag_off(map_points.queued, MAP_POINTS_SIZE,
+			MAP_POINTS_FLAG(map_points.grids[i].x, map_points.grids[i].y));
+	map_points.count = 0;
+}
 
 
 void event_signal(game_event_type type)
@@ -27,6 +27,7 @@
 typedef enum game_event_type
 {
 	EVENT_MAP = 0,		/* Some part of the map has changed. */
+	EVENT_MAP_POINTS,	/* A batch of map grids has changed. */
 
 	EVENT_STATS,  		/* One or more of the stats. */
 	EVENT_HP,	   	/* HP or MaxHP. */
@@ -98,6 +99,14 @@ typedef union
 {
 	struct loc point;
 
+	struct
+	{
+		int count;
+		const struct loc *grids;
+		struct loc min;
+		struct loc max;
+	} points;
+
 	const char *string;
 
 	bool flag;
@@ -176,6 +185,8 @@ void event_remove_handler_set(game_event_type *type, size_t n_types, game_event_
 void event_signal_birthpoints(int stats[6], int remaining);
 
 void event_signal_point(game_event_type, int x, int y);
+void event_queue_map_point(int x, int y);
+void event_flush_map_points(void);
 void event_signal_string(game_event_type, const char *s);
 void event_signal_message(game_event_type type, int t, const char *s);
 void event_signal_flag(game_event_type type, bool flag);
@@ -84,7 +84,7 @@
 static bool square_is_granite_with_flag(struct chunk *c, int y, int x, int flag)
 {
 	if (c->squares[y][x].feat != FEAT_GRANITE) return false;
-	if (!sqinfo_has(c->squares[y][x].info, flag)) return false;
+	if (!square_flag_has(c, y, x, flag)) return false;
 
 	return true;
 }
@@ -748,7 +748,7 @@ struct chunk *labyrinth_chunk(int depth, int h, int w, bool lit, bool soft)
 			int k_local = yx_to_i(y, x, w);
 			sets[k_local] = k_local;
 			square_set_feat(c, y + 1, x + 1, FEAT_FLOOR);
-			if (lit) sqinfo_on(c->squares[y + 1][x + 1].info, SQUARE_GLOW);
+			if (lit) square_flag_on(c, y + 1, x + 1, SQUARE_GLOW);
 		}
     }
 
@@ -777,7 +777,7 @@ struct chunk *labyrinth_chunk(int depth, int h, int w, bool lit, bool soft)
 			int sa = sets[a];
 			int sb = sets[b];
 			square_set_feat(c, y_local + 1, x_local + 1, FEAT_FLOOR);
-			if (lit) sqinfo_on(c->squares[y_local + 1][x_local + 1].info, SQUARE_GLOW);
+			if (lit) square_flag_on(c, y_local + 1, x_local + 1, SQUARE_GLOW);
 
 			for (k = 0; k < n; k++) {
 				if (sets[k] == sb) sets[k] = sa;
@@ -1011,84 +1011,135 @@ static void glow_point(struct chunk *c, int y, int x) {
     int i, j;
     for (i = -1; i <= -1; i++)
 		for (j = -1; j <= -1; j++)
-			sqinfo_on(c->squares[y + i][x + j].info, SQUARE_GLOW);
+			square_flag_on(c, y + i, x + j, SQUARE_GLOW);
 }
 #endif
 
 /**
- * Color a particular point, and all adjacent points.
- * \param c is the current chunk
- * \param colors is the array of current point colors
- * \param counts is the array of current color counts
- * \param y are the co-ordinates
- * \param x are the co-ordinates
- * \param color is the color we are coloring
- * \param diagonal controls whether we can progress diagonally
+ * Scratch space for build_colors() and join_region(), which run several
+ * times a level.  It is kept between calls, grown to the largest chunk seen,
+ * and freed by free_region_scratch() when the generate module is cleaned up.
  */
-static void build_color_point(struct chunk *c, int colors[], int counts[], int y, int x, int color, bool diagonal) {
-    int h = c->height;
-    int w = c->width;
-    int size = h * w;
-    struct queue *queue = q_new(size);
-
-    int dslimit = diagonal ? 8 : 4;
-
-    int *added = mem_zalloc(size * sizeof(int));
-    array_filler(added, 0, size);
-
-    q_push_int(queue, yx_to_i(y, x, w));
-
-    counts[color] = 0;
-
-    while (q_len(queue) > 0) {
-		int i, y2, x2;
-		int n2 = q_pop_int(queue);
+static struct {
+	int size;
+	int *points;		/* Union-find parents, or join_region() paths */
+	struct queue *queue;
+} region_scratch;
 
-		i_to_yx(n2, w, &y2, &x2);
-
-		if (ignore_point(c, colors, y2, x2)) continue;
-
-		colors[n2] = color;
-		counts[color]++;
+/**
+ * Make sure the region scratch space has room for a chunk of `size` points
+ */
+static void reserve_region_scratch(int size)
+{
+	if (size <= region_scratch.size) return;
 
-		/*if (lit) glow_point(c, y2, x2);*/
+	free_region_scratch();
+	region_scratch.size = size;
+	region_scratch.points = mem_alloc(size * sizeof(int));
+	region_scratch.queue = q_new(size);
+}
 
-		for (i = 0; i < dslimit; i++) {
-			int y3 = y2 + yds[i];
-			int x3 = x2 + xds[i];
-			int n3 = yx_to_i(y3, x3, w);
-			if (ignore_point(c, colors, y3, x3)) continue;
-			if (added[n3]) continue;
+/**
+ * Free the region scratch space
+ */
+void free_region_scratch(void)
+{
+	mem_free(region_scratch.points);
+	if (region_scratch.queue)
+		q_free(region_scratch.queue);
+	memset(&region_scratch, 0, sizeof(region_scratch));
+}
 
-			q_push_int(queue, n3);
-			added[n3] = 1;
-		}
+/**
+ * Find the root of a point's region in the union-find forest.
+ * \param parent is the array of parent points
+ * \param n is the point
+ */
+static int region_find(int parent[], int n) {
+    while (parent[n] != n) {
+		parent[n] = parent[parent[n]];
+		n = parent[n];
     }
+    return n;
+}
 
-    mem_free(added);
-    q_free(queue);
+/**
+ * Merge the regions of two points; the root of the merged region is always
+ * its first point in grid order.
+ * \param parent is the array of parent points
+ * \param n1 is one point
+ * \param n2 is the other point
+ */
+static void region_union(int parent[], int n1, int n2) {
+    n1 = region_find(parent, n1);
+    n2 = region_find(parent, n2);
+    if (n1 < n2)
+		parent[n2] = n1;
+    else if (n2 < n1)
+		parent[n1] = n2;
 }
 
 /**
  * Create a color for each "NESW contiguous" region of the dungeon.
  * \param c is the current chunk
- * \param colors is the array of current point colors
+ * \param colors is the array of current point colors, all zero on entry
  * \param counts is the array of current color counts
  * \param diagonal controls whether we can progress diagonally
+ * \return the number of colors used
+ *
+ * Every point is linked to its open neighbours above and to the left in one
+ * pass over the grid, and a second pass numbers the regions in the order
+ * their first points appear, so the colors are those a flood fill from each
+ * uncolored point in turn would give.
  */
-static void build_colors(struct chunk *c, int colors[], int counts[], bool diagonal) {
-    int y, x;
+static int build_colors(struct chunk *c, int colors[], int counts[], bool diagonal) {
+    int n;
     int h = c->height;
     int w = c->width;
-    int color = 1;
+    int size = h * w;
+    int color = 0;
+    int *parent;
+
+    reserve_region_scratch(size);
+    parent = region_scratch.points;
 
-    for (y = 0; y < h; y++) {
-		for (x = 0; x < w; x++) {
-			if (ignore_point(c, colors, y, x)) continue;
-			build_color_point(c, colors, counts, y, x, color, diagonal);
-			color++;
+    for (n = 0; n < size; n++) {
+		int y, x;
+		i_to_yx(n, w, &y, &x);
+
+		if (ignore_point(c, colors, y, x)) {
+			parent[n] = -1;
+			continue;
+		}
+		parent[n] = n;
+
+		if (x > 0 && parent[n - 1] >= 0)
+			region_union(parent, n, n - 1);
+		if (y == 0) continue;
+		if (parent[n - w] >= 0)
+			region_union(parent, n, n - w);
+		if (!diagonal) continue;
+		if (x > 0 && parent[n - w - 1] >= 0)
+			region_union(parent, n, n - w - 1);
+		if (x < w - 1 && parent[n - w + 1] >= 0)
+			region_union(parent, n, n - w + 1);
+    }
+
+    for (n = 0; n < size; n++) {
+		int root;
+		if (parent[n] < 0) continue;
+
+		root = region_find(parent, n);
+		if (root == n) {
+			colors[n] = ++color;
+			counts[color] = 0;
+		} else {
+			colors[n] = colors[root];
 		}
+		counts[colors[n]]++;
     }
+
+    return color;
 }
 
 /**
@@ -1096,19 +1147,18 @@ static void build_colors(struct chunk *c, int colors[], int counts[], bool diago
  * \param c is the current chunk
  * \param colors is the array of current point colors
  * \param counts is the array of current color counts
+ * \param num is the number of colors
  */
-static void clear_small_regions(struct chunk *c, int colors[], int counts[]) {
+static void clear_small_regions(struct chunk *c, int colors[], int counts[],
+								int num) {
     int i, y, x;
-    int h = c->height;
     int w = c->width;
-    int size = h * w;
 
-    int *deleted = mem_zalloc(size * sizeof(int));
-    array_filler(deleted, 0, size);
+    bool *deleted = mem_zalloc((num + 1) * sizeof(bool));
 
-    for (i = 0; i < size; i++) {
+    for (i = 0; i <= num; i++) {
 		if (counts[i] < 9) {
-			deleted[i] = 1;
+			deleted[i] = true;
 			counts[i] = 0;
 		}
     }
@@ -1129,7 +1179,7 @@ static void clear_small_regions(struct chunk *c, int colors[], int counts[]) {
 /**
  * Return the number of colors which have active cells.
  * \param counts is the array of current color counts
- * \param size is the total area
+ * \param size is the number of counts
  */
 static int count_colors(int counts[], int size) {
     int i;
@@ -1141,7 +1191,7 @@ static int count_colors(int counts[], int size) {
 /**
  * Return the first color which has one or more active cells.
  * \param counts is the array of current color counts
- * \param size is the total area
+ * \param size is the number of counts
  */
 static int first_color(int counts[], int size) {
     int i;
@@ -1180,14 +1230,16 @@ static void join_region(struct chunk *c, int colors[], int counts[], int color,
     int h = c->height;
     int w = c->width;
     int size = h * w;
+    struct queue *queue;
+    int *previous;
 
-    /* Allocate a processing queue */
-    struct queue *queue = q_new(size);
-
-    /* Allocate an array to keep track of handled squares, and which square
-     * we reached them from.
+    /* Get an empty processing queue, and an array to keep track of handled
+     * squares, and which square we reached them from.
      */
-    int *previous = mem_zalloc(size * sizeof(int));
+    reserve_region_scratch(size);
+    queue = region_scratch.queue;
+    q_clear(queue);
+    previous = region_scratch.points;
     array_filler(previous, -1, size);
 
     /* Push all squares of the given color onto the queue */
@@ -1250,10 +1302,6 @@ static void join_region(struct chunk *c, int colors[], int counts[], int color,
 			previous[n2] = n;
 		}
     }
-
-    /* Free the memory we've allocated */
-    q_free(queue);
-    mem_free(previous);
 }
 
 
@@ -1262,18 +1310,17 @@ static void join_region(struct chunk *c, int colors[], int counts[], int color,
  * \param c is the current chunk
  * \param colors is the array of current point colors
  * \param counts is the array of current color counts
+ * \param colors_used is the number of colors build_colors() used
  */
-static void join_regions(struct chunk *c, int colors[], int counts[]) {
-    int h = c->height;
-    int w = c->width;
-    int size = h * w;
-    int num = count_colors(counts, size);
+static void join_regions(struct chunk *c, int colors[], int counts[],
+						 int colors_used) {
+    int num = count_colors(counts, colors_used + 1);
 
     /* While we have multiple colors (i.e. disconnected regions), join one of
      * the regions to another one.
      */
     while (num > 1) {
-		int color = first_color(counts, size);
+		int color = first_color(counts, colors_used + 1);
 		join_region(c, colors, counts, color, -1);
 		num--;
     }
@@ -1292,8 +1339,7 @@ void ensure_connectedness(struct chunk *c) {
     int *colors = mem_zalloc(size * sizeof(int));
     int *counts = mem_zalloc(size * sizeof(int));
 
-    build_colors(c, colors, counts, true);
-    join_regions(c, colors, counts);
+    join_regions(c, colors, counts, build_colors(c, colors, counts, true));
 
     mem_free(colors);
     mem_free(counts);
@@ -1310,7 +1356,7 @@ void ensure_connectedness(struct chunk *c) {
  */
 struct chunk *cavern_chunk(int depth, int h, int w)
 {
-    int i;
+    int i, num;
     int size = h * w;
     int limit = size / 13;
     int density = rand_range(25, 40);
@@ -1348,9 +1394,9 @@ struct chunk *cavern_chunk(int depth, int h, int w)
 		return NULL;
 	}
 
-	build_colors(c, colors, counts, false);
-	clear_small_regions(c, colors, counts);
-	join_regions(c, colors, counts);
+	num = build_colors(c, colors, counts, false);
+	clear_small_regions(c, colors, counts, num);
+	join_regions(c, colors, counts, num);
 
     mem_free(colors);
     mem_free(counts);
@@ -2109,8 +2155,8 @@ void connect_caverns(struct chunk *c, struct loc floor[])
 	join_region(c, colors, counts, color_of_floor[0], color_of_floor[1]);
 	join_region(c, colors, counts, color_of_floor[2], color_of_floor[3]);
 
-	/* Redo the colors, join the two big caverns */
-    build_colors(c, colors, counts, true);
+	/* Join the two big caverns; the joins above have kept the colors up to
+	 * date */
 	for (i = 1; i < 3; i++) {
 		int spot = yx_to_i(floor[i].y, floor[i].x, c->width);
 		color_of_floor[i] = colors[spot];
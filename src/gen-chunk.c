@@ -52,6 +52,7 @@ struct chunk *chunk_write(int y0, int x0, int height, int width, bool monsters,
 						 bool objects, bool traps)
 {
 	int x, y;
+	bitflag info[SQUARE_SIZE];
 
 	struct chunk *new = cave_new(height, width);
 
@@ -60,8 +61,8 @@ struct chunk *chunk_write(int y0, int x0, int height, int width, bool monsters,
 		for (x = 0; x < width; x++) {
 			/* Terrain */
 			new->squares[y][x].feat = cave->squares[y0 + y][x0 + x].feat;
-			sqinfo_copy(new->squares[y][x].info,
-						cave->squares[y0 + y][x0 + x].info);
+			square_get_info(cave, y0 + y, x0 + x, info);
+			square_set_info(new, y, x, info);
 
 			/* Dungeon objects */
 			if (objects) {
@@ -82,19 +83,30 @@ struct chunk *chunk_write(int y0, int x0, int height, int width, bool monsters,
 					struct monster *source_mon = square_monster(cave, y0 + y,
 															  x0 + x);
 					struct monster *dest_mon = NULL;
+					int idx;
 
 					/* Valid monster */
 					if (!source_mon->race)
 						continue;
 
+					/* Make a monster */
+					idx = mon_pop(new);
+
+					/* Hope this never happens */
+					if (!idx)
+						break;
+
 					/* Copy over */
-					new->squares[y][x].mon = ++new->mon_cnt;
-					dest_mon = cave_monster(new, new->mon_cnt);
+					new->squares[y][x].mon = idx;
+					dest_mon = cave_monster(new, idx);
 					memcpy(dest_mon, source_mon, sizeof(*source_mon));
 
-					/* Adjust position */
+					/* Adjust stuff */
+					dest_mon->midx = idx;
 					dest_mon->fy = y;
 					dest_mon->fx = x;
+					mon_schedule_add(new, dest_mon);
+					mon_index_add(new, dest_mon);
 
 					/* Held objects */
 					if (objects && source_mon->held_obj)
@@ -253,6 +265,7 @@ bool chunk_copy(struct chunk *dest, struct chunk *source, int y0, int x0,
 {
 	int i;
 	int y, x;
+	bitflag info[SQUARE_SIZE];
 	int h = source->height, w = source->width;
 
 	/* Check bounds */
@@ -274,13 +287,14 @@ bool chunk_copy(struct chunk *dest, struct chunk *source, int y0, int x0,
 
 			/* Terrain */
 			dest->squares[dest_y][dest_x].feat = source->squares[y][x].feat;
-			sqinfo_copy(dest->squares[dest_y][dest_x].info,
-						source->squares[y][x].info);
+			square_get_info(source, y, x, info);
+			square_set_info(dest, dest_y, dest_x, info);
 
 			/* Dungeon objects */
 			if (square_object(source, y, x)) {
 				struct object *obj;
 				dest->squares[dest_y][dest_x].obj = square_object(source, y, x);
+				source->lent = true;
 
 				for (obj = square_object(source, y, x); obj; obj = obj->next) {
 					/* Adjust position */
@@ -315,16 +329,21 @@ bool chunk_copy(struct chunk *dest, struct chunk *source, int y0, int x0,
 				dest_mon->midx = idx;
 				dest_mon->fy = dest_y;
 				dest_mon->fx = dest_x;
+				mon_schedule_add(dest, dest_mon);
+				mon_index_add(dest, dest_mon);
 
 				/* Held objects */
-				if (source_mon->held_obj)
+				if (source_mon->held_obj) {
 					dest_mon->held_obj = source_mon->held_obj;
+					source->lent = true;
+				}
 			}
 
 			/* Traps */
 			if (source->squares[y][x].trap) {
 				struct trap *trap = source->squares[y][x].trap;
 				dest->squares[y][x].trap = trap;
+				source->lent = true;
 
 				/* Traverse the trap list */
 				while (trap) {
@@ -350,8 +369,10 @@ bool chunk_copy(struct chunk *dest, struct chunk *source, int y0, int x0,
 								* sizeof(struct object*));
 	for (i = 0; i <= source->obj_max; i++) {
 		dest->objects[dest->obj_max + i] = source->objects[i];
-		if (dest->objects[dest->obj_max + i] != NULL)
+		if (dest->objects[dest->obj_max + i] != NULL) {
 			dest->objects[dest->obj_max + i]->oidx = dest->obj_max + i;
+			source->lent = true;
+		}
 	}
 	dest->obj_max += source->obj_max + 1;
 
@@ -101,7 +101,7 @@ static void generate_room(struct chunk *c, int y1, int x1, int y2, int x2, int l
 		for (x = x1; x <= x2; x++) {
 			sqinfo_on(c->squares[y][x].info, SQUARE_ROOM);
 			if (light)
-				sqinfo_on(c->squares[y][x].info, SQUARE_GLOW);
+				square_flag_on(c, y, x, SQUARE_GLOW);
 		}
 }
 
@@ -121,7 +121,7 @@ void generate_mark(struct chunk *c, int y1, int x1, int y2, int x2, int flag)
 
 	for (y = y1; y <= y2; y++) {
 		for (x = x1; x <= x2; x++) {
-			sqinfo_on(c->squares[y][x].info, flag);
+			square_flag_on(c, y, x, flag);
 		}
 	}
 }
@@ -199,9 +199,9 @@ static void fill_xrange(struct chunk *c, int y, int x1, int x2, int feat,
 	for (x = x1; x <= x2; x++) {
 		square_set_feat(c, y, x, feat);
 		sqinfo_on(c->squares[y][x].info, SQUARE_ROOM);
-		if (flag) sqinfo_on(c->squares[y][x].info, flag);
+		if (flag) square_flag_on(c, y, x, flag);
 		if (light)
-			sqinfo_on(c->squares[y][x].info, SQUARE_GLOW);
+			square_flag_on(c, y, x, SQUARE_GLOW);
 	}
 }
 
@@ -223,9 +223,9 @@ static void fill_yrange(struct chunk *c, int x, int y1, int y2, int feat,
 	for (y = y1; y <= y2; y++) {
 		square_set_feat(c, y, x, feat);
 		sqinfo_on(c->squares[y][x].info, SQUARE_ROOM);
-		if (flag) sqinfo_on(c->squares[y][x].info, flag);
+		if (flag) square_flag_on(c, y, x, flag);
 		if (light)
-			sqinfo_on(c->squares[y][x].info, SQUARE_GLOW);
+			square_flag_on(c, y, x, SQUARE_GLOW);
 	}
 }
 
@@ -660,9 +660,9 @@ extern bool generate_starburst_room(struct chunk *c, int y1, int x1, int y2,
 								sqinfo_off(c->squares[y][x].info, SQUARE_ROOM);
 
 							if (light)
-								sqinfo_on(c->squares[y][x].info, SQUARE_GLOW);
+								square_flag_on(c, y, x, SQUARE_GLOW);
 							else
-								sqinfo_off(c->squares[y][x].info, SQUARE_GLOW);
+								square_flag_off(c, y, x, SQUARE_GLOW);
 						}
 
 						/* If new feature is non-floor passable terrain,
@@ -684,7 +684,7 @@ extern bool generate_starburst_room(struct chunk *c, int y1, int x1, int y2,
 
 							/* Light grid. */
 							if (light)
-								sqinfo_on(c->squares[y][x].info, SQUARE_GLOW);
+								square_flag_on(c, y, x, SQUARE_GLOW);
 						}
 					}
 
@@ -715,7 +715,7 @@ extern bool generate_starburst_room(struct chunk *c, int y1, int x1, int y2,
 
 						/* Illuminate if requested. */
 						if (light)
-							sqinfo_on(c->squares[yy][xx].info, SQUARE_GLOW);
+							square_flag_on(c, yy, xx, SQUARE_GLOW);
 
 						/* Look for dungeon granite. */
 						if (c->squares[yy][xx].feat == FEAT_GRANITE) {
@@ -1548,7 +1548,7 @@ bool build_nest(struct chunk *c, int y0, int x0)
 	alloc_obj = dun->pit_type->obj_rarity;
 	
 	/* Prepare allocation table */
-	get_mon_num_prep(mon_pit_hook);
+	get_mon_num_prep_cached(mon_pit_hook, dun->pit_type);
 
 	/* Pick some monster types */
 	for (i = 0; i < 64; i++) {
@@ -1667,7 +1667,7 @@ bool build_pit(struct chunk *c, int y0, int x0)
 	alloc_obj = dun->pit_type->obj_rarity;
 	
 	/* Prepare allocation table */
-	get_mon_num_prep(mon_pit_hook);
+	get_mon_num_prep_cached(mon_pit_hook, dun->pit_type);
 
 	/* Pick some monster types */
 	for (i = 0; i < 16; i++) {
@@ -1920,7 +1920,7 @@ static bool build_room_template(struct chunk *c, int y0, int x0, int ymax, int x
 			/* Part of a room */
 			sqinfo_on(c->squares[y][x].info, SQUARE_ROOM);
 			if (light)
-				sqinfo_on(c->squares[y][x].info, SQUARE_GLOW);
+				square_flag_on(c, y, x, SQUARE_GLOW);
 		}
 	}
 
@@ -2807,7 +2807,7 @@ bool build_room_of_chambers(struct chunk *c, int y0, int x0)
 					sqinfo_on(c->squares[yy][xx].info, SQUARE_ROOM);
 
 					/* Illuminate if requested. */
-					if (light) sqinfo_on(c->squares[yy][xx].info, SQUARE_GLOW);
+					if (light) square_flag_on(c, yy, xx, SQUARE_GLOW);
 				}
 			}
 		}
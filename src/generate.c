@@ -414,10 +414,6 @@ static struct parser *init_parse_room(void) {
 	return p;
 }
 
-static errr run_parse_room(struct parser *p) {
-	return parse_file_quit_not_found(p, "room_template");
-}
-
 static errr finish_parse_room(struct parser *p) {
 	room_templates = parser_priv(p);
 	parser_destroy(p);
@@ -435,6 +431,74 @@ static void cleanup_room(void)
 	}
 }
 
+/**
+ * Read the room templates back from their cache, in list order.
+ *
+ * This must match room_cache_write() and store every field of struct
+ * room_template; PARSE_CACHE_VERSION in parser.c must be bumped whenever
+ * either changes, or old caches will be misread.
+ */
+static bool room_cache_read(struct parser *p, struct parse_cache *c) {
+	struct room_template *head = NULL, **tail = &head;
+	u32b n = parse_cache_get_u32b(c);
+
+	while (n-- && parse_cache_ok(c)) {
+		struct room_template *t = mem_zalloc(sizeof(*t));
+
+		t->name = parse_cache_get_str(c);
+		t->text = parse_cache_get_str(c);
+		t->typ = parse_cache_get_byte(c);
+		t->rat = parse_cache_get_byte(c);
+		t->hgt = parse_cache_get_byte(c);
+		t->wid = parse_cache_get_byte(c);
+		t->dor = parse_cache_get_byte(c);
+		t->tval = parse_cache_get_byte(c);
+		*tail = t;
+		tail = &t->next;
+	}
+
+	if (!parse_cache_ok(c)) {
+		room_templates = head;
+		cleanup_room();
+		room_templates = NULL;
+		return false;
+	}
+	parser_setpriv(p, head);
+	return true;
+}
+
+static bool room_cache_write(struct parser *p, struct parse_cache *c)
+{
+	struct room_template *list = parser_priv(p);
+	struct room_template *t;
+	u32b n = 0;
+
+	for (t = list; t; t = t->next)
+		n++;
+	parse_cache_put_u32b(c, n);
+	for (t = list; t; t = t->next) {
+		parse_cache_put_str(c, t->name);
+		parse_cache_put_str(c, t->text);
+		parse_cache_put_byte(c, t->typ);
+		parse_cache_put_byte(c, t->rat);
+		parse_cache_put_byte(c, t->hgt);
+		parse_cache_put_byte(c, t->wid);
+		parse_cache_put_byte(c, t->dor);
+		parse_cache_put_byte(c, t->tval);
+	}
+	return true;
+}
+
+/**
+ * Load the room templates from their cache if it is current, or parse them
+ * and rewrite the cache; see room_cache_read() for keeping the two in step
+ */
+static errr run_parse_room(struct parser *p) {
+	static const char *sources[] = { "room_template", NULL };
+	return parse_file_cached(p, "room_template", sources, room_cache_read,
+							 room_cache_write);
+}
+
 static struct file_parser room_parser = {
 	"room_template",
 	init_parse_room,
@@ -561,10 +625,6 @@ struct parser *init_parse_vault(void) {
 	return p;
 }
 
-static errr run_parse_vault(struct parser *p) {
-	return parse_file_quit_not_found(p, "vault");
-}
-
 static errr finish_parse_vault(struct parser *p) {
 	vaults = parser_priv(p);
 	parser_destroy(p);
@@ -583,6 +643,75 @@ static void cleanup_vault(void)
 	}
 }
 
+/**
+ * Read the vaults back from their cache, in list order.
+ *
+ * This must match vault_cache_write() and store every field of struct vault;
+ * PARSE_CACHE_VERSION in parser.c must be bumped whenever either changes, or
+ * old caches will be misread.
+ */
+static bool vault_cache_read(struct parser *p, struct parse_cache *c) {
+	struct vault *head = NULL, **tail = &head;
+	u32b n = parse_cache_get_u32b(c);
+
+	while (n-- && parse_cache_ok(c)) {
+		struct vault *v = mem_zalloc(sizeof(*v));
+
+		v->name = parse_cache_get_str(c);
+		v->text = parse_cache_get_str(c);
+		v->typ = parse_cache_get_str(c);
+		v->rat = parse_cache_get_byte(c);
+		v->hgt = parse_cache_get_byte(c);
+		v->wid = parse_cache_get_byte(c);
+		v->min_lev = parse_cache_get_byte(c);
+		v->max_lev = parse_cache_get_byte(c);
+		*tail = v;
+		tail = &v->next;
+	}
+
+	if (!parse_cache_ok(c)) {
+		vaults = head;
+		cleanup_vault();
+		vaults = NULL;
+		return false;
+	}
+	parser_setpriv(p, head);
+	return true;
+}
+
+static bool vault_cache_write(struct parser *p, struct parse_cache *c)
+{
+	struct vault *list = parser_priv(p);
+	struct vault *v;
+	u32b n = 0;
+
+	for (v = list; v; v = v->next)
+		n++;
+	parse_cache_put_u32b(c, n);
+	for (v = list; v; v = v->next) {
+		parse_cache_put_str(c, v->name);
+		parse_cache_put_str(c, v->text);
+		parse_cache_put_str(c, v->typ);
+		parse_cache_put_byte(c, v->rat);
+		parse_cache_put_byte(c, v->hgt);
+		parse_cache_put_byte(c, v->wid);
+		parse_cache_put_byte(c, v->min_lev);
+		parse_cache_put_byte(c, v->max_lev);
+	}
+	return true;
+}
+
+/**
+ * Load the vaults from their cache if it is current, or parse them and
+ * rewrite the cache; see vault_cache_read() for keeping the two in step
+ */
+static errr run_parse_vault(struct parser *p) {
+	/* Vault depths default to the maximum depth from constants.txt */
+	static const char *sources[] = { "vault", "constants", NULL };
+	return parse_file_cached(p, "vault", sources, vault_cache_read,
+							 vault_cache_write);
+}
+
 static struct file_parser vault_parser = {
 	"vault",
 	init_parse_vault,
@@ -622,6 +751,15 @@ static void cleanup_template_parser(void)
 	cleanup_parser(&vault_parser);
 }
 
+/**
+ * Free the templates and the scratch space kept between levels
+ */
+static void cleanup_generate(void)
+{
+	cleanup_template_parser();
+	free_region_scratch();
+}
+
 
 /**
  * Place hidden squares that will be used to generate feeling
@@ -905,14 +1043,12 @@ void cave_generate(struct chunk **c, struct player *p)
 		}
 
 		/* Clear generation flags. */
-		for (y = 0; y < chunk->height; y++) {
-			for (x = 0; x < chunk->width; x++) {
-				sqinfo_off(chunk->squares[y][x].info, SQUARE_WALL_INNER);
-				sqinfo_off(chunk->squares[y][x].info, SQUARE_WALL_OUTER);
-				sqinfo_off(chunk->squares[y][x].info, SQUARE_WALL_SOLID);
+		cave_plane_wipe(chunk, PLANE_WALL_INNER);
+		cave_plane_wipe(chunk, PLANE_WALL_OUTER);
+		cave_plane_wipe(chunk, PLANE_WALL_SOLID);
+		for (y = 0; y < chunk->height; y++)
+			for (x = 0; x < chunk->width; x++)
 				sqinfo_off(chunk->squares[y][x].info, SQUARE_MON_RESTRICT);
-			}
-		}
 
 		/* Regenerate levels that overflow their maxima */
 		if (cave_monster_max(chunk) >= z_info->level_monster_max)
@@ -985,5 +1121,5 @@ void cave_generate(struct chunk **c, struct player *p)
 struct init_module generate_module = {
 	.name = "generate",
 	.init = run_template_parser,
-	.cleanup = cleanup_template_parser
+	.cleanup = cleanup_generate
 };
@@ -246,6 +246,7 @@ struct chunk *town_gen(struct player *p);
 struct chunk *classic_gen(struct player *p);
 struct chunk *labyrinth_gen(struct player *p);
 void ensure_connectedness(struct chunk *c);
+void free_region_scratch(void);
 struct chunk *cavern_gen(struct player *p);
 struct chunk *modified_gen(struct player *p);
 struct chunk *moria_gen(struct player *p);
@@ -261,11 +261,14 @@ static struct activation *findact(const char *act_name) {
 	return act;
 }
 
-static enum parser_error write_dummy_object_record(struct artifact *art, const char *name)
+/**
+ * Add an object kind with the given tval and name to the end of k_info, for
+ * a special artifact which has no kind of its own
+ */
+static struct object_kind *add_dummy_kind(int tval, const char *name)
 {
 	struct object_kind *temp, *dummy;
 	int i;
-	char mod_name[100];
 
 	/* Extend by 1 and realloc */
 	z_info->k_max += 1;
@@ -273,7 +276,7 @@ static enum parser_error write_dummy_object_record(struct artifact *art, const c
 
 	/* Copy if no errors */
 	if (!temp)
-		return PARSE_ERROR_INTERNAL;
+		return NULL;
 	else
 		k_info = temp;
 
@@ -282,12 +285,11 @@ static enum parser_error write_dummy_object_record(struct artifact *art, const c
 	memset(dummy, 0, sizeof(*dummy));
 
 	/* Copy the tval and base */
-	dummy->tval = art->tval;
+	dummy->tval = tval;
 	dummy->base = &kb_info[dummy->tval];
 
 	/* Make the name and index */
-	my_strcpy(mod_name, format("& %s~", name), sizeof(mod_name));
-	dummy->name = string_make(mod_name);
+	dummy->name = string_make(name);
 	dummy->kidx = z_info->k_max - 1;
 
 	/* Increase the sval count for this tval, set the new one to the max */
@@ -297,10 +299,7 @@ static enum parser_error write_dummy_object_record(struct artifact *art, const c
 			dummy->sval = kb_info[i].num_svals;
 			break;
 		}
-	if (i == TV_MAX) return PARSE_ERROR_INTERNAL;
-
-	/* Copy the sval to the artifact info */
-	art->sval = dummy->sval;
+	if (i == TV_MAX) return NULL;
 
 	/* Give the object default colours (these should be overwritten) */
 	dummy->d_char = '*';
@@ -309,6 +308,27 @@ static enum parser_error write_dummy_object_record(struct artifact *art, const c
 	/* Register this as an INSTA_ART object */
 	kf_on(dummy->kind_flags, KF_INSTA_ART);
 
+	/* k_info has moved and grown */
+	kind_lookup_init();
+
+	return dummy;
+}
+
+static enum parser_error write_dummy_object_record(struct artifact *art, const char *name)
+{
+	struct object_kind *dummy;
+	char mod_name[100];
+
+	/* Make the name */
+	my_strcpy(mod_name, format("& %s~", name), sizeof(mod_name));
+
+	dummy = add_dummy_kind(art->tval, mod_name);
+	if (!dummy)
+		return PARSE_ERROR_INTERNAL;
+
+	/* Copy the sval to the artifact info */
+	art->sval = dummy->sval;
+
 	return PARSE_ERROR_NONE;
 }
 
@@ -379,6 +399,239 @@ void add_game_slay(struct slay *s)
 	}
 }
 
+/**
+ * ------------------------------------------------------------------------
+ * Caches of parsed object data
+ *
+ * The object, activation, ego item and artifact records are stored in the
+ * user directory by parse_file_cached() and read back on later runs instead
+ * of parsing the text files.  Pointers to other game data are stored as
+ * indices and linked up again as the records are read, and the game brands
+ * and slays the parsers register are registered again in the order parsing
+ * would.  Each reader must match its writer; PARSE_CACHE_VERSION in
+ * parser.c must be bumped whenever either changes, or old caches will be
+ * misread.
+ * ------------------------------------------------------------------------ */
+
+/**
+ * Store a list of effects.  Dice are stored as strings, with the
+ * expressions bound to their variables, so the dice can be rebuilt by
+ * effect_cache_read() just as the parser built them; this fails if the
+ * dice can't be written out that way.
+ */
+static bool effect_cache_write(struct parse_cache *c, struct effect *effect)
+{
+	char buf[80];
+	int i;
+
+	for (; effect; effect = effect->next) {
+		const expression_t *expression;
+		const char *name;
+
+		parse_cache_put_byte(c, 1);
+		parse_cache_put_u32b(c, effect->index);
+		for (i = 0; i < 3; i++)
+			parse_cache_put_s32b(c, effect->params[i]);
+		if (!effect->dice) {
+			parse_cache_put_str(c, NULL);
+			continue;
+		}
+		if (!dice_to_string(effect->dice, buf, sizeof(buf)))
+			return false;
+		parse_cache_put_str(c, buf);
+
+		/* Variables, with any expressions bound to them */
+		for (i = 0; (name = dice_variable(effect->dice, i, &expression));
+			 i++) {
+			expression_base_value_f function;
+			const char *base = NULL;
+
+			parse_cache_put_byte(c, 1);
+			parse_cache_put_str(c, name);
+			if (!expression) {
+				parse_cache_put_byte(c, 0);
+				continue;
+			}
+			function = expression_get_base_value(expression);
+			if (function) {
+				base = spell_value_base_name(function);
+				if (!base)
+					return false;
+			}
+			if (!expression_to_string(expression, buf, sizeof(buf)))
+				return false;
+			parse_cache_put_byte(c, 1);
+			parse_cache_put_str(c, base);
+			parse_cache_put_str(c, buf);
+		}
+		parse_cache_put_byte(c, 0);
+	}
+	parse_cache_put_byte(c, 0);
+
+	return true;
+}
+
+/**
+ * Read back a list of effects stored by effect_cache_write(); on failure
+ * the effects read so far are left in the list, to be freed by the caller.
+ */
+static bool effect_cache_read(struct parse_cache *c, struct effect **list)
+{
+	struct effect **tail = list;
+	int i;
+
+	while (parse_cache_get_byte(c)) {
+		struct effect *effect = mem_zalloc(sizeof(*effect));
+		char *dice;
+		bool ok;
+
+		*tail = effect;
+		tail = &effect->next;
+
+		effect->index = parse_cache_get_u32b(c);
+		for (i = 0; i < 3; i++)
+			effect->params[i] = parse_cache_get_s32b(c);
+		if (effect->index >= EF_MAX)
+			return false;
+
+		dice = parse_cache_get_str(c);
+		if (!dice)
+			continue;
+		effect->dice = dice_new();
+		ok = dice_parse_string(effect->dice, dice);
+		string_free(dice);
+		if (!ok)
+			return false;
+
+		while (parse_cache_get_byte(c)) {
+			char *name = parse_cache_get_str(c);
+
+			if (parse_cache_get_byte(c)) {
+				char *base = parse_cache_get_str(c);
+				char *ops = parse_cache_get_str(c);
+				expression_t *expression = expression_new();
+				expression_base_value_f function = NULL;
+
+				if (base) {
+					function = spell_value_base_by_name(base);
+					ok = function != NULL;
+				}
+				expression_set_base_value(expression, function);
+				if (!name || !ops ||
+					expression_add_operations_string(expression, ops) < 0 ||
+					dice_bind_expression(effect->dice, name, expression) < 0)
+					ok = false;
+				expression_free(expression);
+				string_free(base);
+				string_free(ops);
+			}
+			string_free(name);
+			if (!ok)
+				return false;
+		}
+	}
+
+	return parse_cache_ok(c);
+}
+
+static void brand_cache_write(struct parse_cache *c, struct brand *b)
+{
+	for (; b; b = b->next) {
+		parse_cache_put_byte(c, 1);
+		parse_cache_put_str(c, b->name);
+		parse_cache_put_s32b(c, b->element);
+		parse_cache_put_s32b(c, b->multiplier);
+	}
+	parse_cache_put_byte(c, 0);
+}
+
+static struct brand *brand_cache_read(struct parse_cache *c)
+{
+	struct brand *head = NULL, **tail = &head;
+
+	while (parse_cache_get_byte(c)) {
+		struct brand *b = mem_zalloc(sizeof(*b));
+
+		b->name = parse_cache_get_str(c);
+		b->element = parse_cache_get_s32b(c);
+		b->multiplier = parse_cache_get_s32b(c);
+		*tail = b;
+		tail = &b->next;
+	}
+
+	return head;
+}
+
+/**
+ * Register a record's brands as parsing did, which added each to the front
+ * of the record's list
+ */
+static void brand_cache_register(struct brand *b)
+{
+	if (!b)
+		return;
+	brand_cache_register(b->next);
+	add_game_brand(b);
+}
+
+static void slay_cache_write(struct parse_cache *c, struct slay *s)
+{
+	for (; s; s = s->next) {
+		parse_cache_put_byte(c, 1);
+		parse_cache_put_str(c, s->name);
+		parse_cache_put_s32b(c, s->race_flag);
+		parse_cache_put_s32b(c, s->multiplier);
+	}
+	parse_cache_put_byte(c, 0);
+}
+
+static struct slay *slay_cache_read(struct parse_cache *c)
+{
+	struct slay *head = NULL, **tail = &head;
+
+	while (parse_cache_get_byte(c)) {
+		struct slay *s = mem_zalloc(sizeof(*s));
+
+		s->name = parse_cache_get_str(c);
+		s->race_flag = parse_cache_get_s32b(c);
+		s->multiplier = parse_cache_get_s32b(c);
+		*tail = s;
+		tail = &s->next;
+	}
+
+	return head;
+}
+
+static void slay_cache_register(struct slay *s)
+{
+	if (!s)
+		return;
+	slay_cache_register(s->next);
+	add_game_slay(s);
+}
+
+static void el_info_cache_write(struct parse_cache *c,
+								struct element_info *el_info)
+{
+	int i;
+
+	for (i = 0; i < ELEM_MAX; i++) {
+		parse_cache_put_s32b(c, el_info[i].res_level);
+		parse_cache_put_byte(c, el_info[i].flags);
+	}
+}
+
+static void el_info_cache_read(struct parse_cache *c,
+							   struct element_info *el_info)
+{
+	int i;
+
+	for (i = 0; i < ELEM_MAX; i++) {
+		el_info[i].res_level = parse_cache_get_s32b(c);
+		el_info[i].flags = parse_cache_get_byte(c);
+	}
+}
+
 /**
  * Find the default paths to all of our important sub-directories.
  *
@@ -1396,8 +1649,163 @@ struct parser *init_parse_object(void) {
 	return p;
 }
 
+static bool object_cache_write(struct parser *p, struct parse_cache *c)
+{
+	struct object_kind *k;
+	u32b n = 0;
+	int i;
+
+	for (k = parser_priv(p); k; k = k->next)
+		n++;
+	parse_cache_put_u32b(c, n);
+	for (k = parser_priv(p); k; k = k->next) {
+		parse_cache_put_str(c, k->name);
+		parse_cache_put_str(c, k->text);
+		parse_cache_put_byte(c, k->base ? 1 : 0);
+		parse_cache_put_u32b(c, k->kidx);
+		parse_cache_put_s32b(c, k->tval);
+		parse_cache_put_s32b(c, k->sval);
+		parse_cache_put_rand(c, k->pval);
+		parse_cache_put_rand(c, k->to_h);
+		parse_cache_put_rand(c, k->to_d);
+		parse_cache_put_rand(c, k->to_a);
+		parse_cache_put_s32b(c, k->ac);
+		parse_cache_put_s32b(c, k->dd);
+		parse_cache_put_s32b(c, k->ds);
+		parse_cache_put_s32b(c, k->weight);
+		parse_cache_put_s32b(c, k->cost);
+		parse_cache_put(c, k->flags, OF_SIZE);
+		parse_cache_put(c, k->kind_flags, KF_SIZE);
+		for (i = 0; i < OBJ_MOD_MAX; i++)
+			parse_cache_put_rand(c, k->modifiers[i]);
+		el_info_cache_write(c, k->el_info);
+		brand_cache_write(c, k->brands);
+		slay_cache_write(c, k->slays);
+		parse_cache_put_byte(c, k->d_attr);
+		parse_cache_put_u32b(c, k->d_char);
+		parse_cache_put_s32b(c, k->alloc_prob);
+		parse_cache_put_s32b(c, k->alloc_min);
+		parse_cache_put_s32b(c, k->alloc_max);
+		parse_cache_put_s32b(c, k->level);
+		if (!effect_cache_write(c, k->effect))
+			return false;
+		parse_cache_put_s32b(c, k->power);
+		parse_cache_put_str(c, k->effect_msg);
+		parse_cache_put_rand(c, k->time);
+		parse_cache_put_rand(c, k->charge);
+		parse_cache_put_s32b(c, k->gen_mult_prob);
+		parse_cache_put_rand(c, k->stack_size);
+	}
+
+	return true;
+}
+
+static void object_cache_free(struct object_kind *k)
+{
+	struct object_kind *next;
+
+	for (; k; k = next) {
+		next = k->next;
+		string_free(k->name);
+		mem_free(k->text);
+		mem_free(k->effect_msg);
+		free_brand(k->brands);
+		free_slay(k->slays);
+		free_effect(k->effect);
+		mem_free(k);
+	}
+}
+
+/**
+ * Register the object kinds with their bases, and their brands and slays,
+ * in file order, which is the reverse of the list's
+ */
+static void object_cache_register(struct object_kind *k)
+{
+	if (!k)
+		return;
+	object_cache_register(k->next);
+	if (k->base)
+		k->base->num_svals++;
+	brand_cache_register(k->brands);
+	slay_cache_register(k->slays);
+}
+
+/**
+ * Read the object kinds back from their cache, in list order; this must
+ * match object_cache_write() and store every field the parser sets
+ */
+static bool object_cache_read(struct parser *p, struct parse_cache *c)
+{
+	struct object_kind *head = NULL, **tail = &head;
+	u32b n = parse_cache_get_u32b(c);
+	bool ok = true;
+	int i;
+
+	while (n-- && ok && parse_cache_ok(c)) {
+		struct object_kind *k = mem_zalloc(sizeof(*k));
+		bool has_base;
+
+		*tail = k;
+		tail = &k->next;
+
+		k->name = parse_cache_get_str(c);
+		k->text = parse_cache_get_str(c);
+		has_base = parse_cache_get_byte(c) != 0;
+		k->kidx = parse_cache_get_u32b(c);
+		k->tval = parse_cache_get_s32b(c);
+		k->sval = parse_cache_get_s32b(c);
+		if (k->tval < 0 || k->tval >= TV_MAX) {
+			ok = false;
+			break;
+		}
+		if (has_base)
+			k->base = &kb_info[k->tval];
+		k->pval = parse_cache_get_rand(c);
+		k->to_h = parse_cache_get_rand(c);
+		k->to_d = parse_cache_get_rand(c);
+		k->to_a = parse_cache_get_rand(c);
+		k->ac = parse_cache_get_s32b(c);
+		k->dd = parse_cache_get_s32b(c);
+		k->ds = parse_cache_get_s32b(c);
+		k->weight = parse_cache_get_s32b(c);
+		k->cost = parse_cache_get_s32b(c);
+		parse_cache_get(c, k->flags, OF_SIZE);
+		parse_cache_get(c, k->kind_flags, KF_SIZE);
+		for (i = 0; i < OBJ_MOD_MAX; i++)
+			k->modifiers[i] = parse_cache_get_rand(c);
+		el_info_cache_read(c, k->el_info);
+		k->brands = brand_cache_read(c);
+		k->slays = slay_cache_read(c);
+		k->d_attr = parse_cache_get_byte(c);
+		k->d_char = parse_cache_get_u32b(c);
+		k->alloc_prob = parse_cache_get_s32b(c);
+		k->alloc_min = parse_cache_get_s32b(c);
+		k->alloc_max = parse_cache_get_s32b(c);
+		k->level = parse_cache_get_s32b(c);
+		ok = effect_cache_read(c, &k->effect);
+		k->power = parse_cache_get_s32b(c);
+		k->effect_msg = parse_cache_get_str(c);
+		k->time = parse_cache_get_rand(c);
+		k->charge = parse_cache_get_rand(c);
+		k->gen_mult_prob = parse_cache_get_s32b(c);
+		k->stack_size = parse_cache_get_rand(c);
+	}
+
+	if (!ok || !parse_cache_ok(c)) {
+		object_cache_free(head);
+		return false;
+	}
+
+	parser_setpriv(p, head);
+	object_cache_register(head);
+	return true;
+}
+
 static errr run_parse_object(struct parser *p) {
-	return parse_file_quit_not_found(p, "object");
+	static const char *sources[] = { "object", NULL };
+	return parse_file_cached(p, "object", sources, object_cache_read,
+							 object_cache_write);
 }
 
 static errr finish_parse_object(struct parser *p) {
@@ -1428,6 +1836,7 @@ static errr finish_parse_object(struct parser *p) {
 		mem_free(k);
 	}
 	z_info->k_max += 1;
+	kind_lookup_init();
 
 	/*objkinds = parser_priv(p); not used yet, when used, remove the mem_free(k); above */
 	parser_destroy(p);
@@ -1437,6 +1846,8 @@ static errr finish_parse_object(struct parser *p) {
 static void cleanup_object(void)
 {
 	int idx;
+
+	kind_lookup_free();
 	for (idx = 0; idx < z_info->k_max; idx++) {
 		string_free(k_info[idx].name);
 		mem_free(k_info[idx].text);
@@ -1636,8 +2047,71 @@ struct parser *init_parse_act(void) {
 	return p;
 }
 
+static bool act_cache_write(struct parser *p, struct parse_cache *c)
+{
+	struct activation *act;
+	u32b n = 0;
+
+	for (act = parser_priv(p); act; act = act->next)
+		n++;
+	parse_cache_put_u32b(c, n);
+	for (act = parser_priv(p); act; act = act->next) {
+		parse_cache_put_str(c, act->name);
+		parse_cache_put_byte(c, act->aim ? 1 : 0);
+		parse_cache_put_s32b(c, act->power);
+		if (!effect_cache_write(c, act->effect))
+			return false;
+		parse_cache_put_str(c, act->message);
+		parse_cache_put_str(c, act->desc);
+	}
+
+	return true;
+}
+
+/**
+ * Read the activations back from their cache, in list order; this must
+ * match act_cache_write() and store every field the parser sets
+ */
+static bool act_cache_read(struct parser *p, struct parse_cache *c)
+{
+	struct activation *head = NULL, **tail = &head, *next;
+	u32b n = parse_cache_get_u32b(c);
+	bool ok = true;
+
+	while (n-- && ok && parse_cache_ok(c)) {
+		struct activation *act = mem_zalloc(sizeof(*act));
+
+		*tail = act;
+		tail = &act->next;
+
+		act->name = parse_cache_get_str(c);
+		act->aim = parse_cache_get_byte(c) ? true : false;
+		act->power = parse_cache_get_s32b(c);
+		ok = effect_cache_read(c, &act->effect);
+		act->message = parse_cache_get_str(c);
+		act->desc = parse_cache_get_str(c);
+	}
+
+	if (!ok || !parse_cache_ok(c)) {
+		for (; head; head = next) {
+			next = head->next;
+			string_free(head->name);
+			mem_free(head->desc);
+			mem_free(head->message);
+			free_effect(head->effect);
+			mem_free(head);
+		}
+		return false;
+	}
+
+	parser_setpriv(p, head);
+	return true;
+}
+
 static errr run_parse_act(struct parser *p) {
-	return parse_file_quit_not_found(p, "activation");
+	static const char *sources[] = { "activation", NULL };
+	return parse_file_cached(p, "activation", sources, act_cache_read,
+							 act_cache_write);
 }
 
 static errr finish_parse_act(struct parser *p) {
@@ -1936,8 +2410,217 @@ struct parser *init_parse_artifact(void) {
 	return p;
 }
 
+/**
+ * The number of object kinds before artifact.txt added its dummy kinds
+ */
+static int artifact_k_base;
+
+static bool artifact_cache_write(struct parser *p, struct parse_cache *c)
+{
+	struct artifact *a;
+	u32b n = 0;
+	int i;
+
+	/* Dummy kinds, in the order they were added */
+	parse_cache_put_u32b(c, artifact_k_base);
+	parse_cache_put_u32b(c, z_info->k_max - artifact_k_base);
+	for (i = artifact_k_base; i < z_info->k_max; i++) {
+		parse_cache_put_s32b(c, k_info[i].tval);
+		parse_cache_put_str(c, k_info[i].name);
+	}
+
+	/* Special artifact graphics */
+	for (i = 0; i < z_info->k_max; i++) {
+		if (!kf_has(k_info[i].kind_flags, KF_INSTA_ART))
+			continue;
+		parse_cache_put_byte(c, 1);
+		parse_cache_put_u32b(c, i);
+		parse_cache_put_byte(c, k_info[i].d_attr);
+		parse_cache_put_u32b(c, k_info[i].d_char);
+	}
+	parse_cache_put_byte(c, 0);
+
+	for (a = parser_priv(p); a; a = a->next)
+		n++;
+	parse_cache_put_u32b(c, n);
+	for (a = parser_priv(p); a; a = a->next) {
+		parse_cache_put_str(c, a->name);
+		parse_cache_put_str(c, a->text);
+		parse_cache_put_u32b(c, a->aidx);
+		parse_cache_put_s32b(c, a->tval);
+		parse_cache_put_s32b(c, a->sval);
+		parse_cache_put_s32b(c, a->to_h);
+		parse_cache_put_s32b(c, a->to_d);
+		parse_cache_put_s32b(c, a->to_a);
+		parse_cache_put_s32b(c, a->ac);
+		parse_cache_put_s32b(c, a->dd);
+		parse_cache_put_s32b(c, a->ds);
+		parse_cache_put_s32b(c, a->weight);
+		parse_cache_put_s32b(c, a->cost);
+		parse_cache_put(c, a->flags, OF_SIZE);
+		for (i = 0; i < OBJ_MOD_MAX; i++)
+			parse_cache_put_s32b(c, a->modifiers[i]);
+		el_info_cache_write(c, a->el_info);
+		brand_cache_write(c, a->brands);
+		slay_cache_write(c, a->slays);
+		parse_cache_put_s32b(c, a->level);
+		parse_cache_put_s32b(c, a->alloc_prob);
+		parse_cache_put_s32b(c, a->alloc_min);
+		parse_cache_put_s32b(c, a->alloc_max);
+		parse_cache_put_u32b(c, a->activation ? a->activation->index : 0);
+		parse_cache_put_str(c, a->alt_msg);
+		parse_cache_put_rand(c, a->time);
+	}
+
+	return true;
+}
+
+static void artifact_cache_free(struct artifact *a)
+{
+	struct artifact *next;
+
+	for (; a; a = next) {
+		next = a->next;
+		string_free(a->name);
+		mem_free(a->alt_msg);
+		mem_free(a->text);
+		free_brand(a->brands);
+		free_slay(a->slays);
+		mem_free(a);
+	}
+}
+
+/**
+ * Register the artifacts' brands and slays in file order
+ */
+static void artifact_cache_register(struct artifact *a)
+{
+	if (!a)
+		return;
+	artifact_cache_register(a->next);
+	brand_cache_register(a->brands);
+	slay_cache_register(a->slays);
+}
+
+/**
+ * Read the artifacts back from their cache, in list order, along with the
+ * object kinds artifact.txt adds or changes; this must match
+ * artifact_cache_write() and store every field the parser sets
+ */
+static bool artifact_cache_read(struct parser *p, struct parse_cache *c)
+{
+	struct artifact *head = NULL, **tail = &head;
+	struct { int tval; char *name; } *dummies = NULL;
+	struct { u32b kidx; byte attr; wchar_t glyph; } *glyphs = NULL;
+	size_t num_glyphs = 0, glyphs_size = 0;
+	u32b base = parse_cache_get_u32b(c);
+	u32b num_dummies = parse_cache_get_u32b(c);
+	u32b n, i;
+	bool ok = parse_cache_ok(c) && base == (u32b)z_info->k_max &&
+		num_dummies <= 0xFFFF;
+	int j;
+
+	/* Dummy kinds */
+	if (ok)
+		dummies = mem_zalloc((num_dummies + 1) * sizeof(*dummies));
+	for (i = 0; ok && i < num_dummies; i++) {
+		dummies[i].tval = parse_cache_get_s32b(c);
+		dummies[i].name = parse_cache_get_str(c);
+		if (dummies[i].tval <= 0 || dummies[i].tval >= TV_MAX ||
+			kb_info[dummies[i].tval].tval != dummies[i].tval ||
+			!dummies[i].name)
+			ok = false;
+	}
+
+	/* Special artifact graphics */
+	while (ok && parse_cache_get_byte(c)) {
+		if (num_glyphs == glyphs_size) {
+			glyphs_size = glyphs_size ? 2 * glyphs_size : 64;
+			glyphs = mem_realloc(glyphs, glyphs_size * sizeof(*glyphs));
+		}
+		glyphs[num_glyphs].kidx = parse_cache_get_u32b(c);
+		glyphs[num_glyphs].attr = parse_cache_get_byte(c);
+		glyphs[num_glyphs].glyph = parse_cache_get_u32b(c);
+		if (glyphs[num_glyphs].kidx >= base + num_dummies)
+			ok = false;
+		num_glyphs++;
+	}
+
+	n = ok ? parse_cache_get_u32b(c) : 0;
+	while (n-- && ok && parse_cache_ok(c)) {
+		struct artifact *a = mem_zalloc(sizeof(*a));
+		u32b act;
+
+		*tail = a;
+		tail = &a->next;
+
+		a->name = parse_cache_get_str(c);
+		a->text = parse_cache_get_str(c);
+		a->aidx = parse_cache_get_u32b(c);
+		a->tval = parse_cache_get_s32b(c);
+		a->sval = parse_cache_get_s32b(c);
+		a->to_h = parse_cache_get_s32b(c);
+		a->to_d = parse_cache_get_s32b(c);
+		a->to_a = parse_cache_get_s32b(c);
+		a->ac = parse_cache_get_s32b(c);
+		a->dd = parse_cache_get_s32b(c);
+		a->ds = parse_cache_get_s32b(c);
+		a->weight = parse_cache_get_s32b(c);
+		a->cost = parse_cache_get_s32b(c);
+		parse_cache_get(c, a->flags, OF_SIZE);
+		for (j = 0; j < OBJ_MOD_MAX; j++)
+			a->modifiers[j] = parse_cache_get_s32b(c);
+		el_info_cache_read(c, a->el_info);
+		a->brands = brand_cache_read(c);
+		a->slays = slay_cache_read(c);
+		a->level = parse_cache_get_s32b(c);
+		a->alloc_prob = parse_cache_get_s32b(c);
+		a->alloc_min = parse_cache_get_s32b(c);
+		a->alloc_max = parse_cache_get_s32b(c);
+
+		/* Activations are linked by index */
+		act = parse_cache_get_u32b(c);
+		if (act >= (u32b)z_info->act_max)
+			ok = false;
+		else if (act)
+			a->activation = &activations[act];
+
+		a->alt_msg = parse_cache_get_str(c);
+		a->time = parse_cache_get_rand(c);
+	}
+	ok = ok && parse_cache_ok(c);
+
+	/* Add the dummy kinds and set the graphics */
+	for (i = 0; ok && i < num_dummies; i++)
+		if (!add_dummy_kind(dummies[i].tval, dummies[i].name))
+			ok = false;
+	for (i = 0; ok && i < num_glyphs; i++) {
+		k_info[glyphs[i].kidx].d_attr = glyphs[i].attr;
+		k_info[glyphs[i].kidx].d_char = glyphs[i].glyph;
+	}
+
+	for (i = 0; dummies && i < num_dummies; i++)
+		string_free(dummies[i].name);
+	mem_free(dummies);
+	mem_free(glyphs);
+
+	if (!ok) {
+		artifact_cache_free(head);
+		return false;
+	}
+
+	parser_setpriv(p, head);
+	artifact_cache_register(head);
+	return true;
+}
+
 static errr run_parse_artifact(struct parser *p) {
-	return parse_file_quit_not_found(p, "artifact");
+	/* Base kinds and activations are found by index */
+	static const char *sources[] = { "artifact", "object", "activation",
+									 NULL };
+	artifact_k_base = z_info->k_max;
+	return parse_file_cached(p, "artifact", sources, artifact_cache_read,
+							 artifact_cache_write);
 }
 
 static errr finish_parse_artifact(struct parser *p) {
@@ -1966,6 +2649,7 @@ static errr finish_parse_artifact(struct parser *p) {
 		mem_free(a);
 	}
 	z_info->a_max += 1;
+	artifact_lookup_init();
 
 	/* Now we're done with object kinds, record kinds for generic objects */
 	none = tval_find_idx("none");
@@ -1981,6 +2665,8 @@ static errr finish_parse_artifact(struct parser *p) {
 static void cleanup_artifact(void)
 {
 	int idx;
+
+	artifact_lookup_free();
 	for (idx = 0; idx < z_info->a_max; idx++) {
 		string_free(a_info[idx].name);
 		mem_free(a_info[idx].alt_msg);
@@ -3059,8 +3745,169 @@ struct parser *init_parse_ego(void) {
 	return p;
 }
 
+static bool ego_cache_write(struct parser *p, struct parse_cache *c)
+{
+	struct ego_item *e;
+	struct ego_poss_item *poss;
+	u32b n = 0;
+	int i;
+
+	for (e = parser_priv(p); e; e = e->next)
+		n++;
+	parse_cache_put_u32b(c, n);
+	for (e = parser_priv(p); e; e = e->next) {
+		parse_cache_put_str(c, e->name);
+		parse_cache_put_str(c, e->text);
+		parse_cache_put_u32b(c, e->eidx);
+		parse_cache_put_s32b(c, e->cost);
+		parse_cache_put(c, e->flags, OF_SIZE);
+		parse_cache_put(c, e->flags_off, OF_SIZE);
+		parse_cache_put(c, e->kind_flags, KF_SIZE);
+		for (i = 0; i < OBJ_MOD_MAX; i++) {
+			parse_cache_put_rand(c, e->modifiers[i]);
+			parse_cache_put_s32b(c, e->min_modifiers[i]);
+		}
+		el_info_cache_write(c, e->el_info);
+		brand_cache_write(c, e->brands);
+		slay_cache_write(c, e->slays);
+		parse_cache_put_s32b(c, e->level);
+		parse_cache_put_s32b(c, e->rarity);
+		parse_cache_put_s32b(c, e->rating);
+		parse_cache_put_s32b(c, e->alloc_prob);
+		parse_cache_put_s32b(c, e->alloc_min);
+		parse_cache_put_s32b(c, e->alloc_max);
+
+		/* Possible kinds, by index */
+		for (poss = e->poss_items; poss; poss = poss->next) {
+			parse_cache_put_byte(c, 1);
+			parse_cache_put_u32b(c, poss->kidx);
+		}
+		parse_cache_put_byte(c, 0);
+
+		parse_cache_put_rand(c, e->to_h);
+		parse_cache_put_rand(c, e->to_d);
+		parse_cache_put_rand(c, e->to_a);
+		parse_cache_put_s32b(c, e->min_to_h);
+		parse_cache_put_s32b(c, e->min_to_d);
+		parse_cache_put_s32b(c, e->min_to_a);
+		if (!effect_cache_write(c, e->effect))
+			return false;
+		parse_cache_put_str(c, e->effect_msg);
+		parse_cache_put_rand(c, e->time);
+	}
+
+	return true;
+}
+
+static void ego_cache_free(struct ego_item *e)
+{
+	struct ego_item *next;
+	struct ego_poss_item *poss, *pn;
+
+	for (; e; e = next) {
+		next = e->next;
+		string_free(e->name);
+		mem_free(e->text);
+		free_brand(e->brands);
+		free_slay(e->slays);
+		free_effect(e->effect);
+		mem_free(e->effect_msg);
+		for (poss = e->poss_items; poss; poss = pn) {
+			pn = poss->next;
+			mem_free(poss);
+		}
+		mem_free(e);
+	}
+}
+
+/**
+ * Register the ego items' brands and slays in file order
+ */
+static void ego_cache_register(struct ego_item *e)
+{
+	if (!e)
+		return;
+	ego_cache_register(e->next);
+	brand_cache_register(e->brands);
+	slay_cache_register(e->slays);
+}
+
+/**
+ * Read the ego items back from their cache, in list order; this must match
+ * ego_cache_write() and store every field the parser sets
+ */
+static bool ego_cache_read(struct parser *p, struct parse_cache *c)
+{
+	struct ego_item *head = NULL, **tail = &head;
+	u32b n = parse_cache_get_u32b(c);
+	bool ok = true;
+	int i;
+
+	while (n-- && ok && parse_cache_ok(c)) {
+		struct ego_item *e = mem_zalloc(sizeof(*e));
+		struct ego_poss_item **poss_tail = &e->poss_items;
+
+		*tail = e;
+		tail = &e->next;
+
+		e->name = parse_cache_get_str(c);
+		e->text = parse_cache_get_str(c);
+		e->eidx = parse_cache_get_u32b(c);
+		e->cost = parse_cache_get_s32b(c);
+		parse_cache_get(c, e->flags, OF_SIZE);
+		parse_cache_get(c, e->flags_off, OF_SIZE);
+		parse_cache_get(c, e->kind_flags, KF_SIZE);
+		for (i = 0; i < OBJ_MOD_MAX; i++) {
+			e->modifiers[i] = parse_cache_get_rand(c);
+			e->min_modifiers[i] = parse_cache_get_s32b(c);
+		}
+		el_info_cache_read(c, e->el_info);
+		e->brands = brand_cache_read(c);
+		e->slays = slay_cache_read(c);
+		e->level = parse_cache_get_s32b(c);
+		e->rarity = parse_cache_get_s32b(c);
+		e->rating = parse_cache_get_s32b(c);
+		e->alloc_prob = parse_cache_get_s32b(c);
+		e->alloc_min = parse_cache_get_s32b(c);
+		e->alloc_max = parse_cache_get_s32b(c);
+
+		while (parse_cache_get_byte(c)) {
+			struct ego_poss_item *poss = mem_zalloc(sizeof(*poss));
+
+			*poss_tail = poss;
+			poss_tail = &poss->next;
+			poss->kidx = parse_cache_get_u32b(c);
+			if (poss->kidx >= (u32b)z_info->k_max)
+				ok = false;
+		}
+
+		e->to_h = parse_cache_get_rand(c);
+		e->to_d = parse_cache_get_rand(c);
+		e->to_a = parse_cache_get_rand(c);
+		e->min_to_h = parse_cache_get_s32b(c);
+		e->min_to_d = parse_cache_get_s32b(c);
+		e->min_to_a = parse_cache_get_s32b(c);
+		if (!effect_cache_read(c, &e->effect))
+			ok = false;
+		e->effect_msg = parse_cache_get_str(c);
+		e->time = parse_cache_get_rand(c);
+	}
+
+	if (!ok || !parse_cache_ok(c)) {
+		ego_cache_free(head);
+		return false;
+	}
+
+	parser_setpriv(p, head);
+	ego_cache_register(head);
+	return true;
+}
+
 static errr run_parse_ego(struct parser *p) {
-	return parse_file_quit_not_found(p, "ego_item");
+	/* Possible kinds are stored by index */
+	static const char *sources[] = { "ego_item", "object", NULL };
+	return parse_file_cached(p, "ego_item", sources, ego_cache_read,
+							 ego_cache_write);
 }
 
 static errr finish_parse_ego(struct parser *p) {
@@ -4804,7 +5651,7 @@ void cleanup_angband(void)
 	/* Free the format() buffer */
 	vformat_kill();
 
-	/* Free the directories */
+	/* Free the directories, so that init_file_paths() can be run again */
 	string_free(ANGBAND_DIR_GAMEDATA);
 	string_free(ANGBAND_DIR_CUSTOMIZE);
 	string_free(ANGBAND_DIR_HELP);
@@ -4817,4 +5664,11 @@ void cleanup_angband(void)
 	string_free(ANGBAND_DIR_SAVE);
 	string_free(ANGBAND_DIR_SCORES);
 	string_free(ANGBAND_DIR_INFO);
+	ANGBAND_DIR_GAMEDATA = ANGBAND_DIR_CUSTOMIZE = ANGBAND_DIR_HELP = NULL;
+	ANGBAND_DIR_SCREENS = ANGBAND_DIR_FONTS = ANGBAND_DIR_TILES = NULL;
+	ANGBAND_DIR_SOUNDS = ANGBAND_DIR_ICONS = ANGBAND_DIR_USER = NULL;
+	ANGBAND_DIR_SAVE = ANGBAND_DIR_SCORES = ANGBAND_DIR_INFO = NULL;
+
+	/* Give the allocator's free blocks back to the system */
+	mem_trim();
 }
@@ -133,7 +133,9 @@ extern char *ANGBAND_DIR_SAVE;
 extern char *ANGBAND_DIR_SCORES;
 extern char *ANGBAND_DIR_INFO;
 
+extern struct parser *init_parse_act(void);
 extern struct parser *init_parse_artifact(void);
+extern struct parser *init_parse_body(void);
 extern struct parser *init_parse_class(void);
 extern struct parser *init_parse_ego(void);
 extern struct parser *init_parse_feat(void);
@@ -339,30 +339,31 @@ int rd_randomizer(void)
 {
 	int i;
 	u32b noop;
+	struct rng_state *rng = Rand_context();
 
 	/* current value for the simple RNG */
-	rd_u32b(&Rand_value);
+	rd_u32b(&rng->value);
 
 	/* state index */
-	rd_u32b(&state_i);
+	rd_u32b(&rng->state_i);
 
 	/* for safety, make sure state_i < RAND_DEG */
-	state_i = state_i % RAND_DEG;
+	rng->state_i = rng->state_i % RAND_DEG;
     
 	/* RNG variables */
-	rd_u32b(&z0);
-	rd_u32b(&z1);
-	rd_u32b(&z2);
+	rd_u32b(&rng->z0);
+	rd_u32b(&rng->z1);
+	rd_u32b(&rng->z2);
     
 	/* RNG state */
 	for (i = 0; i < RAND_DEG; i++)
-		rd_u32b(&STATE[i]);
+		rd_u32b(&rng->state[i]);
 
 	/* NULL padding */
 	for (i = 0; i < 59 - RAND_DEG; i++)
 		rd_u32b(&noop);
 
-	Rand_quick = false;
+	rng->quick = false;
 
 	return 0;
 }
@@ -479,6 +480,7 @@ int rd_monster_memory(void)
 		/* Look for the next monster */
 		rd_string(buf, sizeof(buf));
 	}
+	mon_uniques_changed();
 
 	return 0;
 }
@@ -1195,6 +1197,11 @@ static int rd_dungeon_aux(struct chunk **c)
 		}
 	}
 
+	/* Move the flags held in bit planes out of the info */
+	for (y = 0; y < c1->height; y++)
+		for (x = 0; x < c1->width; x++)
+			square_set_info(c1, y, x, c1->squares[y][x].info);
+
 	/* Run length decoding of dungeon data */
 	for (x = y = 0; y < c1->height; ) {
 		/* Grab RLE info */
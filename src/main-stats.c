@@ -22,6 +22,7 @@
 
 #include "buildid.h"
 #include "game-world.h"
+#include "generate.h"
 #include "init.h"
 #include "main.h"
 #include "mon-make.h"
@@ -41,6 +42,9 @@
 #include "store.h"
 #include <stddef.h>
 #include <time.h>
+#ifdef UNIX
+#include <sys/wait.h>
+#endif
 
 #define OBJ_FEEL_MAX	 11
 #define MON_FEEL_MAX 	 10
@@ -52,6 +56,7 @@
 #define TOP_POWER		999
 #define TOP_MOD 		 25
 #define RUNS_PER_CHECKPOINT	10000
+#define STATS_SHARD_MAGIC	0x53544154
 
 /* For ref, e_max is 128, a_max is 136, r_max is ~650,
 	ORIGIN_STATS is 14, OF_MAX is ~120 */
@@ -65,7 +70,12 @@
 static int randarts = 0;
 static int no_selling = 0;
 static u32b num_runs = 1;
+static int num_jobs = 1;
+static int worker = 0;
+static u32b seed_base;
+static bool seed_given = false;
 static bool quiet = false;
+static bool silent = false;	/* For workers that leave reporting to the first */
 static int nextkey = 0;
 static int running_stats = 0;
 static char *ANGBAND_DIR_STATS;
@@ -99,6 +109,147 @@ static struct level_data {
 	struct wearables_data *wearables[ORIGIN_STATS];
 } level_data[LEVEL_MAX];
 
+/**
+ * The per-level count tables, each with the number of key columns that
+ * follow its level and count columns
+ */
+enum {
+	ST_MONSTERS,
+	ST_OBJ_FEELINGS,
+	ST_MON_FEELINGS,
+	ST_GOLD,
+	ST_ARTIFACTS,
+	ST_CONSUMABLES,
+	ST_WEAR_COUNT,
+	ST_WEAR_DICE,
+	ST_WEAR_AC,
+	ST_WEAR_HIT,
+	ST_WEAR_DAM,
+	ST_WEAR_EGOS,
+	ST_WEAR_FLAGS,
+	ST_WEAR_MODS,
+	ST_MAX
+};
+
+static const struct {
+	const char *name;
+	int keys;
+} stats_tables[ST_MAX] = {
+	{ "monsters", 1 },
+	{ "obj_feelings", 1 },
+	{ "mon_feelings", 1 },
+	{ "gold", 1 },
+	{ "artifacts", 2 },
+	{ "consumables", 2 },
+	{ "wearables_count", 2 },
+	{ "wearables_dice", 4 },
+	{ "wearables_ac", 3 },
+	{ "wearables_hit", 3 },
+	{ "wearables_dam", 3 },
+	{ "wearables_egos", 3 },
+	{ "wearables_flags", 3 },
+	{ "wearables_mods", 4 }
+};
+
+static sqlite3_stmt *stats_insert[ST_MAX];
+
+/**
+ * A count that has changed since the last checkpoint, and its row
+ */
+struct stats_delta {
+	void *counter;	/* u32b, or long long for gold */
+	int table;
+	int level;
+	int key[4];
+};
+
+#define DELTAS_INIT	4096
+
+static struct stats_delta *deltas;
+static size_t delta_n = 0;
+static size_t delta_alloc = 0;
+
+/* Open-addressed index from counter address to deltas[] entry + 1 */
+static size_t *delta_index;
+static size_t delta_index_size = 0;
+
+/**
+ * Hash slot for a counter's address
+ */
+static size_t stats_delta_slot(const void *counter)
+{
+	size_t mask = delta_index_size - 1;
+	size_t i = (size_t)(((uintptr_t)counter >> 2) * 2654435761u) & mask;
+
+	while (delta_index[i] && deltas[delta_index[i] - 1].counter != counter)
+		i = (i + 1) & mask;
+
+	return i;
+}
+
+/**
+ * Add a counter to those changed since the last checkpoint, with the row
+ * of the table it belongs in.  Keys beyond those the table has are ignored.
+ */
+static void stats_delta_add(void *counter, int table, int level, int k0,
+							int k1, int k2, int k3)
+{
+	struct stats_delta *d;
+	size_t slot;
+
+	slot = stats_delta_slot(counter);
+	if (delta_index[slot]) return;
+
+	if (delta_n == delta_alloc) {
+		delta_alloc *= 2;
+		deltas = mem_realloc(deltas, delta_alloc * sizeof(*deltas));
+	}
+
+	d = &deltas[delta_n++];
+	d->counter = counter;
+	d->table = table;
+	d->level = level;
+	d->key[0] = k0;
+	d->key[1] = k1;
+	d->key[2] = k2;
+	d->key[3] = k3;
+
+	/* Keep the index at most half full */
+	if (2 * delta_n > delta_index_size) {
+		size_t i;
+
+		mem_free(delta_index);
+		delta_index_size *= 2;
+		delta_index = mem_zalloc(delta_index_size * sizeof(size_t));
+		for (i = 0; i < delta_n; i++)
+			delta_index[stats_delta_slot(deltas[i].counter)] = i + 1;
+	} else {
+		delta_index[slot] = delta_n;
+	}
+}
+
+/**
+ * Note that a counter has changed
+ */
+static void stats_note(void *counter, int table, int level, int k0, int k1,
+					   int k2, int k3)
+{
+	/* Workers hand in everything through their shards instead */
+	if (num_jobs > 1) return;
+
+	stats_delta_add(counter, table, level, k0, k1, k2, k3);
+}
+
+/**
+ * Bump a count and note the change
+ */
+static void stats_count(u32b *counter, int table, int level, int k0, int k1,
+						int k2, int k3)
+{
+	(*counter)++;
+	stats_note(counter, table, level, k0, k1, k2, k3);
+}
+
 static void create_indices()
 {
 	int i;
@@ -126,6 +277,11 @@ static void alloc_memory()
 {
 	int i, j, k, l;
 
+	delta_alloc = DELTAS_INIT;
+	deltas = mem_zalloc(delta_alloc * sizeof(*deltas));
+	delta_index_size = 2 * DELTAS_INIT;
+	delta_index = mem_zalloc(delta_index_size * sizeof(size_t));
+
 	for (i = 0; i < LEVEL_MAX; i++) {
 		level_data[i].monsters = mem_zalloc(z_info->r_max * sizeof(u32b));
 /*		level_data[i].vaults = mem_zalloc(z_info->v_max * sizeof(u32b));
@@ -170,6 +326,8 @@ static void free_stats_memory(void)
 			mem_free(level_data[i].wearables[j]);
 		}
 	}
+	mem_free(deltas);
+	mem_free(delta_index);
 	mem_free(consumables_index);
 	mem_free(wearables_index);
 	string_free(ANGBAND_DIR_STATS);
@@ -178,6 +336,9 @@ static void free_stats_memory(void)
 /* Copied from birth.c:generate_player() */
 static void generate_player_for_stats()
 {
+	struct player_body *body;
+	int i;
+
 	OPT(birth_randarts) = randarts;
 	OPT(birth_no_selling) = no_selling;
 	OPT(birth_stacking) = true;
@@ -188,6 +349,16 @@ static void generate_player_for_stats()
 	player->race = races;  /* Human   */
 	player->class = classes; /* Warrior */
 
+	/* A body of the player's own, as player_embody() makes at birth */
+	body = &bodies[player->race->body];
+	player->body = *body;
+	player->body.name = string_make(body->name);
+	player->body.slots = mem_zalloc(body->count * sizeof(struct equip_slot));
+	for (i = 0; i < body->count; i++) {
+		player->body.slots[i].type = body->slots[i].type;
+		player->body.slots[i].name = string_make(body->slots[i].name);
+	}
+
 	/* Level 1 */
 	player->max_lev = player->lev = 1;
 
@@ -212,18 +383,24 @@ static void generate_player_for_stats()
 	player->history = get_history(player->race->history);
 }
 
-static void initialize_character(void)
+/**
+ * Set up the character for the given run.  Each run has its own stream,
+ * split from the seed for the whole stats job, so that runs made by
+ * different workers never share a stream and the job can be reproduced
+ * with -S.
+ */
+static void initialize_character(u32b run)
 {
-	u32b seed;
+	int i;
 
-	if (!quiet) {
+	if (!quiet && !silent) {
 		printf(" [I  ]\b\b\b\b\b\b");
 		fflush(stdout);
 	}
 
-	seed = (time(NULL));
-	Rand_quick = false;
-	Rand_state_init(seed);
+	/* Start the whole stream afresh, not just its table, so that the run
+	 * goes the same way whichever worker makes it */
+	rng_state_split(Rand_context(), seed_base, run);
 
 	player_init(player);
 	generate_player_for_stats();
@@ -236,6 +413,10 @@ static void initialize_character(void)
 		do_randart(seed_randart, true);
 	}
 
+	/* Have store_reset() pick owners afresh, rather than away from the last
+	 * run's, which would tie this run's stream to the one before */
+	for (i = 0; i < MAX_STORES; i++)
+		stores[i].owner = NULL;
 	store_reset();
 	flavor_init();
 	player->upkeep->playing = true;
@@ -250,12 +431,15 @@ static void kill_all_monsters(int level)
 	for (i = cave_monster_max(cave) - 1; i >= 1; i--) {
 		struct monster *mon = cave_monster(cave, i);
 
-		level_data[level].monsters[mon->race->ridx]++;
+		stats_count(&level_data[level].monsters[mon->race->ridx], ST_MONSTERS,
+					level, mon->race->ridx, 0, 0, 0);
 
 		monster_death(mon, true);
 
-		if (rf_has(mon->race->flags, RF_UNIQUE))
+		if (rf_has(mon->race->flags, RF_UNIQUE)) {
 			mon->race->max_num = 0;
+			mon_uniques_changed();
+		}
 	}
 }
 
@@ -263,7 +447,7 @@ static void unkill_uniques(void)
 {
 	int i;
 
-	if (!quiet) {
+	if (!quiet && !silent) {
 		printf(" [U  ]\b\b\b\b\b\b");
 		fflush(stdout);
 	}
@@ -274,13 +458,14 @@ static void unkill_uniques(void)
 		if (rf_has(race->flags, RF_UNIQUE))
 			race->max_num = 1;
 	}
+	mon_uniques_changed();
 }
 
 static void reset_artifacts(void)
 {
 	int i;
 
-	if (!quiet) {
+	if (!quiet && !silent) {
 		printf(" [R  ]\b\b\b\b\b\b");
 		fflush(stdout);
 	}
@@ -303,39 +488,61 @@ static void log_all_objects(int level)
 
 /*				o_power = object_power(obj, false, NULL, true); */
 
+				int origin = obj->origin;
+				int kidx = obj->kind->kidx;
+
 				/* Capture gold amounts */
-				if (tval_is_money(obj))
-					level_data[level].gold[obj->origin] += obj->pval;
+				if (tval_is_money(obj)) {
+					level_data[level].gold[origin] += obj->pval;
+					stats_note(&level_data[level].gold[origin], ST_GOLD, level,
+							   origin, 0, 0, 0);
+				}
 
 				/* Capture artifact drops */
 				if (obj->artifact)
-					level_data[level].artifacts[obj->origin][obj->artifact->aidx]++;
+					stats_count(&level_data[level].artifacts[origin][obj->artifact->aidx],
+								ST_ARTIFACTS, level, obj->artifact->aidx,
+								origin, 0, 0);
 
 				/* Capture kind details */
 				if (tval_has_variable_power(obj)) {
 					struct wearables_data *w
-						= &level_data[level].wearables[obj->origin][wearables_index[obj->kind->kidx]];
-
-					w->count++;
-					w->dice[MIN(obj->dd, TOP_DICE - 1)][MIN(obj->ds, TOP_SIDES - 1)]++;
-					w->ac[MIN(MAX(obj->ac + obj->to_a, 0), TOP_AC - 1)]++;
-					w->hit[MIN(MAX(obj->to_h, 0), TOP_PLUS - 1)]++;
-					w->dam[MIN(MAX(obj->to_d, 0), TOP_PLUS - 1)]++;
+						= &level_data[level].wearables[origin][wearables_index[kidx]];
+					int dd = MIN(obj->dd, TOP_DICE - 1);
+					int ds = MIN(obj->ds, TOP_SIDES - 1);
+					int ac = MIN(MAX(obj->ac + obj->to_a, 0), TOP_AC - 1);
+					int hit = MIN(MAX(obj->to_h, 0), TOP_PLUS - 1);
+					int dam = MIN(MAX(obj->to_d, 0), TOP_PLUS - 1);
+
+					stats_count(&w->count, ST_WEAR_COUNT, level, kidx, origin,
+								0, 0);
+					stats_count(&w->dice[dd][ds], ST_WEAR_DICE, level, kidx,
+								origin, dd, ds);
+					stats_count(&w->ac[ac], ST_WEAR_AC, level, kidx, origin,
+								ac, 0);
+					stats_count(&w->hit[hit], ST_WEAR_HIT, level, kidx, origin,
+								hit, 0);
+					stats_count(&w->dam[dam], ST_WEAR_DAM, level, kidx, origin,
+								dam, 0);
 
 					/* Capture egos */
 					if (obj->ego)
-						w->egos[obj->ego->eidx]++;
+						stats_count(&w->egos[obj->ego->eidx], ST_WEAR_EGOS,
+									level, kidx, origin, obj->ego->eidx, 0);
 					/* Capture object flags */
 					for (i = of_next(obj->flags, FLAG_START); i != FLAG_END;
 							i = of_next(obj->flags, i + 1))
-						w->flags[i]++;
+						stats_count(&w->flags[i], ST_WEAR_FLAGS, level, kidx,
+									origin, i, 0);
 					/* Capture object modifiers */
 					for (i = 0; i < OBJ_MOD_MAX; i++) {
-						int p = obj->modifiers[i];
-						w->modifiers[MIN(MAX(p, 0), TOP_MOD - 1)][i]++;
+						int p = MIN(MAX(obj->modifiers[i], 0), TOP_MOD - 1);
+						stats_count(&w->modifiers[p][i], ST_WEAR_MODS, level,
+									kidx, origin, p, i);
 					}
 				} else
-					level_data[level].consumables[obj->origin][consumables_index[obj->kind->kidx]]++;
+					stats_count(&level_data[level].consumables[origin][consumables_index[kidx]],
+								ST_CONSUMABLES, level, kidx, origin, 0, 0);
 			}
 		}
 	}
@@ -352,7 +559,7 @@ static void descend_dungeon(void)
 
 	for (level = 1; level < LEVEL_MAX; level++)
 	{
-		if (!quiet) {
+		if (!quiet && !silent) {
 			clock_t now = clock();
 			if (now - last > wait) {
 				printf(" [%3d]\b\b\b\b\b\b", level);
@@ -367,8 +574,12 @@ static void descend_dungeon(void)
 		/* Store level feelings */
 		obj_f = cave->feeling / 10;
 		mon_f = cave->feeling - (10 * obj_f);
-		level_data[level].obj_feelings[MIN(obj_f, OBJ_FEEL_MAX - 1)]++;
-		level_data[level].mon_feelings[MIN(mon_f, MON_FEEL_MAX - 1)]++;
+		obj_f = MIN(obj_f, OBJ_FEEL_MAX - 1);
+		mon_f = MIN(mon_f, MON_FEEL_MAX - 1);
+		stats_count(&level_data[level].obj_feelings[obj_f], ST_OBJ_FEELINGS,
+					level, obj_f, 0, 0, 0);
+		stats_count(&level_data[level].mon_feelings[mon_f], ST_MON_FEELINGS,
+					level, mon_f, 0, 0, 0);
 
 		kill_all_monsters(level);
 		log_all_objects(level);
@@ -917,6 +1128,29 @@ static int stats_dump_info(void)
 	return stats_db_exec("COMMIT;");
 }
 
+/**
+ * Prepare the insert statement for each count table, to be reused for
+ * every checkpoint
+ */
+static int stats_prep_inserts(void)
+{
+	char sql_buf[256];
+	int i, j, err;
+
+	for (i = 0; i < ST_MAX; i++) {
+		my_strcpy(sql_buf, format("INSERT INTO %s VALUES(?,?",
+								  stats_tables[i].name), sizeof(sql_buf));
+		for (j = 0; j < stats_tables[i].keys; j++)
+			my_strcat(sql_buf, ",?", sizeof(sql_buf));
+		my_strcat(sql_buf, ");", sizeof(sql_buf));
+
+		err = stats_db_stmt_prep(&stats_insert[i], sql_buf);
+		if (err) return err;
+	}
+
+	return SQLITE_OK;
+}
+
 /**
  * Open the database connection and create the database tables.
  * All count tables will contain a level column (INTEGER) and a
@@ -1090,66 +1324,17 @@ static bool stats_prep_db(void)
 	err = stats_dump_info();
 	if (err) return false;
 
-	return true;
-}
-
-/**
- * Find the offset of the given member of the level_data struct. Not elegant.
- */
-static int stats_level_data_offsetof(const char *member)
-{
-	if (streq(member, "monsters"))
-		return offsetof(struct level_data, monsters);
-	else if (streq(member, "obj_feelings"))
-		return offsetof(struct level_data, obj_feelings);
-	else if (streq(member, "mon_feelings"))
-		return offsetof(struct level_data, mon_feelings);
-	else if (streq(member, "gold"))
-		return offsetof(struct level_data, gold);
-	else if (streq(member, "artifacts"))
-		return offsetof(struct level_data, artifacts);
-	else if (streq(member, "consumables"))
-		return offsetof(struct level_data, consumables);
-	else if (streq(member, "wearables"))
-		return offsetof(struct level_data, wearables);
-		
-	/* We should not get to this point. */
-	assert(0);
-}
+	err = stats_prep_inserts();
+	if (err) return false;
 
-/**
- * Find the offset of the given member of the wearables_data struct. Not 
- * elegant.
- */
-static int stats_wearables_data_offsetof(const char *member)
-{
-	if (streq(member, "count"))
-		return offsetof(struct wearables_data, count);
-	else if (streq(member, "dice"))
-		return offsetof(struct wearables_data, dice);
-	else if (streq(member, "ac"))
-		return offsetof(struct wearables_data, ac);
-	else if (streq(member, "hit"))
-		return offsetof(struct wearables_data, hit);
-	else if (streq(member, "dam"))
-		return offsetof(struct wearables_data, dam);
-	else if (streq(member, "egos"))
-		return offsetof(struct wearables_data, egos);
-	else if (streq(member, "flags"))
-		return offsetof(struct wearables_data, flags);
-	else if (streq(member, "mods"))
-		return offsetof(struct wearables_data, modifiers);
-		
-	/* We should not get to this point. */
-	assert(0);
+	return true;
 }
 
 /**
- * Given a pointer to a dynamically allocated array and a value, look up
- * the index with that value; e.g. given wearables_index[k_idx], return k_idx.
+ * Look up the index with the given value in a dynamically allocated array;
+ * e.g. given wearables_index[k_idx], return k_idx.
  * If not found, return -1 * value.
  */
-
 static int stats_lookup_index(const int *index, int max_idx, int value)
 {
 	int idx;
@@ -1161,272 +1346,426 @@ static int stats_lookup_index(const int *index, int max_idx, int value)
 	return -1 * value;
 }
 
-static int stats_write_db_level_data(const char *table, int max_idx)
+/**
+ * Finalize the insert statements and close the database
+ */
+static void stats_close_db(void)
 {
-	char sql_buf[256];
-	sqlite3_stmt *sql_stmt;
-	int err, level, i, offset;
-
-	strnfmt(sql_buf, 256, "INSERT INTO %s VALUES(?,?,?);", table);
-	err = stats_db_stmt_prep(&sql_stmt, sql_buf);
-	if (err) return err;
-
-	offset = stats_level_data_offsetof(table);
+	int i;
 
-	for (level = 1; level < LEVEL_MAX; level++)
-		for (i = 0; i < max_idx; i++) {
-	/* This arcane expression finds the value of 
-			 * level_data[level].<table>[i] */
-			u32b count;
-			if (streq(table, "gold"))
-				count = *((long long *)((byte *)&level_data[level] + offset) + i);
-			else
-				count = *((u32b *)((byte *)&level_data[level] + offset) + i);
+	for (i = 0; i < ST_MAX; i++) {
+		sqlite3_finalize(stats_insert[i]);
+		stats_insert[i] = NULL;
+	}
 
-			if (!count) continue;
+	stats_db_close();
+}
 
-			err = stats_db_bind_ints(sql_stmt, 3, 0,
-				level, count, i);
-			if (err) return err;
+/**
+ * Note every non-zero count, so that the next checkpoint writes the lot;
+ * used after adding in the workers' shards
+ */
+static void stats_note_all(void)
+{
+	int level, origin, idx, k_idx, i, j;
+
+	for (level = 1; level < LEVEL_MAX; level++) {
+		struct level_data *ld = &level_data[level];
+
+		for (i = 0; i < z_info->r_max; i++)
+			if (ld->monsters[i])
+				stats_delta_add(&ld->monsters[i], ST_MONSTERS, level, i,
+								0, 0, 0);
+		for (i = 0; i < OBJ_FEEL_MAX; i++)
+			if (ld->obj_feelings[i])
+				stats_delta_add(&ld->obj_feelings[i], ST_OBJ_FEELINGS, level,
+								i, 0, 0, 0);
+		for (i = 0; i < MON_FEEL_MAX; i++)
+			if (ld->mon_feelings[i])
+				stats_delta_add(&ld->mon_feelings[i], ST_MON_FEELINGS, level,
+								i, 0, 0, 0);
+
+		for (origin = 0; origin < ORIGIN_STATS; origin++) {
+			if (ld->gold[origin])
+				stats_delta_add(&ld->gold[origin], ST_GOLD, level, origin,
+								0, 0, 0);
+			for (i = 0; i < z_info->a_max; i++)
+				if (ld->artifacts[origin][i])
+					stats_delta_add(&ld->artifacts[origin][i], ST_ARTIFACTS,
+									level, i, origin, 0, 0);
+			for (idx = 1; idx < consumable_count + 1; idx++) {
+				if (!ld->consumables[origin][idx]) continue;
+				k_idx = stats_lookup_index(consumables_index, z_info->k_max,
+										   idx);
+				stats_delta_add(&ld->consumables[origin][idx], ST_CONSUMABLES,
+								level, k_idx, origin, 0, 0);
+			}
 
-			STATS_DB_STEP_RESET(sql_stmt)
+			for (idx = 1; idx < wearable_count + 1; idx++) {
+				struct wearables_data *w = &ld->wearables[origin][idx];
+
+				if (!w->count) continue;
+				k_idx = stats_lookup_index(wearables_index, z_info->k_max,
+										   idx);
+
+				stats_delta_add(&w->count, ST_WEAR_COUNT, level, k_idx,
+								origin, 0, 0);
+				for (i = 0; i < TOP_DICE; i++)
+					for (j = 0; j < TOP_SIDES; j++)
+						if (w->dice[i][j])
+							stats_delta_add(&w->dice[i][j], ST_WEAR_DICE,
+											level, k_idx, origin, i, j);
+				for (i = 0; i < TOP_AC; i++)
+					if (w->ac[i])
+						stats_delta_add(&w->ac[i], ST_WEAR_AC, level, k_idx,
+										origin, i, 0);
+				for (i = 0; i < TOP_PLUS; i++) {
+					if (w->hit[i])
+						stats_delta_add(&w->hit[i], ST_WEAR_HIT, level, k_idx,
+										origin, i, 0);
+					if (w->dam[i])
+						stats_delta_add(&w->dam[i], ST_WEAR_DAM, level, k_idx,
+										origin, i, 0);
+				}
+				for (i = 0; i < z_info->e_max; i++)
+					if (w->egos[i])
+						stats_delta_add(&w->egos[i], ST_WEAR_EGOS, level,
+										k_idx, origin, i, 0);
+				for (i = 0; i < OF_MAX; i++)
+					if (w->flags[i])
+						stats_delta_add(&w->flags[i], ST_WEAR_FLAGS, level,
+										k_idx, origin, i, 0);
+				for (i = 0; i < TOP_MOD; i++)
+					for (j = 0; j < OBJ_MOD_MAX + 1; j++)
+						if (w->modifiers[i][j])
+							stats_delta_add(&w->modifiers[i][j], ST_WEAR_MODS,
+											level, k_idx, origin, i, j);
+			}
 		}
-
-	return sqlite3_finalize(sql_stmt);
+	}
 }
 
-static int stats_write_db_level_data_items(const char *table, int max_idx, 
-	bool translate_consumables)
+/**
+ * Write the row for one changed count
+ */
+static int stats_write_delta(const struct stats_delta *d)
 {
-	char sql_buf[256];
-	sqlite3_stmt *sql_stmt;
-	int err, level, origin, i, offset;
+	sqlite3_stmt *sql_stmt = stats_insert[d->table];
+	int keys = stats_tables[d->table].keys;
+	int err, i;
+
+	/* Two-dimensional tables leave out their [0][0] entries */
+	if (keys == 4 && !d->key[2] && !d->key[3])
+		return SQLITE_OK;
 
-	strnfmt(sql_buf, 256, "INSERT INTO %s VALUES(?,?,?,?);", table);
-	err = stats_db_stmt_prep(&sql_stmt, sql_buf);
+	err = sqlite3_bind_int(sql_stmt, 1, d->level);
 	if (err) return err;
 
-	offset = stats_level_data_offsetof(table);
+	if (d->table == ST_GOLD)
+		err = sqlite3_bind_int64(sql_stmt, 2, *(long long *)d->counter);
+	else
+		err = sqlite3_bind_int(sql_stmt, 2, *(u32b *)d->counter);
+	if (err) return err;
 
-	for (level = 1; level < LEVEL_MAX; level++)
-		for (origin = 0; origin < ORIGIN_STATS; origin++)
-			for (i = 0; i < max_idx; i++) {
-				/* This arcane expression finds the value of 
-				 * level_data[level].<table>[origin][i] */
-				u32b count = ((u32b **)((byte *)&level_data[level] + offset))[origin][i];
-				if (!count) continue;
-				
-				err = stats_db_bind_ints(sql_stmt, 4, 0, level, count, translate_consumables ? stats_lookup_index(consumables_index, z_info->k_max, i) : i, origin);
-				if (err) return err;
+	for (i = 0; i < keys; i++) {
+		err = sqlite3_bind_int(sql_stmt, 3 + i, d->key[i]);
+		if (err) return err;
+	}
 
-				STATS_DB_STEP_RESET(sql_stmt)
-			}
+	STATS_DB_STEP_RESET(sql_stmt)
 
-	return sqlite3_finalize(sql_stmt);
+	return SQLITE_OK;
 }
 
-static int stats_write_db_wearables_count(void)
+/**
+ * Write the counts that have changed since the last checkpoint, replacing
+ * their old rows, in a single transaction
+ */
+static int stats_write_db(u32b run)
 {
-	sqlite3_stmt *sql_stmt;
-	int err, level, origin, k_idx, idx;
+	char sql_buf[256];
+	size_t i;
+	int err;
 
-	err = stats_db_stmt_prep(&sql_stmt, 
-		"INSERT INTO wearables_count VALUES(?,?,?,?);");
+	/* Wrap entire write into a transaction */
+	err = stats_db_exec("BEGIN TRANSACTION;");
 	if (err) return err;
 
-	for (level = 1; level < LEVEL_MAX; level++)
-		for (origin = 0; origin < ORIGIN_STATS; origin++)
-			for (idx = 0; idx < wearable_count + 1; idx++) {
-				u32b count = level_data[level].wearables[origin][idx].count;
-				/* Skip if object did not appear */
-				if (!count) continue;
-
-				k_idx = stats_lookup_index(wearables_index, 
-					z_info->k_max, idx);
+	strnfmt(sql_buf, 256, 
+		"INSERT OR REPLACE INTO metadata VALUES('runs', %d);", run);
+	err = stats_db_exec(sql_buf);
+	if (err) return err;
 
-				/* Skip if pile */
-				if (! k_idx) continue;
+	for (i = 0; i < delta_n; i++) {
+		err = stats_write_delta(&deltas[i]);
+		if (err) return err;
+	}
 
-				err = stats_db_bind_ints(sql_stmt, 4, 0,
-					level, count, k_idx, origin);
-				if (err) return err;
+	/* Commit transaction */
+	err = stats_db_exec("COMMIT;");
+	if (err) return err;
 
-				STATS_DB_STEP_RESET(sql_stmt)
-			}
+	/* Start the next checkpoint's changes afresh */
+	delta_n = 0;
+	memset(delta_index, 0, delta_index_size * sizeof(size_t));
 
-	return sqlite3_finalize(sql_stmt);
+	return SQLITE_OK;
 }
 
 /**
- * Unfortunately, the arcane expression used to find the value of an array 
- * member of a struct differs depending on whether the member is declared
- * as an array or as a pointer. Pass in true if the member is an array, and
- * false if the member is a pointer.
+ * A shard file is the worker's accumulators walked in a fixed order, with
+ * runs of zero counts skipped: each record is the number of zero counts
+ * passed over, followed by the next non-zero count.
  */
-static int stats_write_db_wearables_array(const char *field, int max_val, bool array_p)
+struct stats_shard {
+	ang_file *f;
+	bool merge;		/* Adding a shard in, rather than writing one out */
+	bool ok;
+	u32b gap;		/* Zero counts skipped since the last record */
+	long long next;	/* Count in the pending record, when merging */
+};
+
+static void stats_shard_record(struct stats_shard *sh)
 {
-	char sql_buf[256];
-	sqlite3_stmt *sql_stmt;
-	int err, level, origin, idx, k_idx, i, offset;
+	if (!sh->ok) return;
+
+	if (sh->merge) {
+		if (file_read(sh->f, (char *)&sh->gap, sizeof(sh->gap)) !=
+			(int)sizeof(sh->gap) ||
+			file_read(sh->f, (char *)&sh->next, sizeof(sh->next)) !=
+			(int)sizeof(sh->next))
+			sh->ok = false;
+	} else {
+		sh->ok = file_write(sh->f, (char *)&sh->gap, sizeof(sh->gap)) &&
+			file_write(sh->f, (char *)&sh->next, sizeof(sh->next));
+		sh->gap = 0;
+	}
+}
 
-	strnfmt(sql_buf, 256, "INSERT INTO wearables_%s VALUES(?,?,?,?,?);", field);
-	err = stats_db_stmt_prep(&sql_stmt, sql_buf);
-	if (err) return err;
+/**
+ * Pass a single count through the shard, returning the amount to add to it
+ */
+static long long stats_shard_value(struct stats_shard *sh, long long value)
+{
+	long long add;
+
+	if (!sh->merge) {
+		if (value) {
+			sh->next = value;
+			stats_shard_record(sh);
+		} else {
+			sh->gap++;
+		}
+		return 0;
+	}
 
-	offset = stats_wearables_data_offsetof(field);
+	if (!sh->ok) return 0;
 
-	for (level = 1; level < LEVEL_MAX; level++)
-		for (origin = 0; origin < ORIGIN_STATS; origin++)
-			for (idx = 0; idx < wearable_count + 1; idx++) {
-				k_idx = stats_lookup_index(wearables_index, 
-					z_info->k_max, idx);
-
-				/* Skip if pile */
-				if (! k_idx) continue;
-
-				for (i = 0; i < max_val; i++) {
-					/* This arcane expression finds the value of
-					 * level_data[level].wearables[origin][idx].<field>[i] */
-					u32b count;
-					if (array_p)
-						count = ((u32b *)((byte *)&level_data[level].wearables[origin][idx] + offset))[i];
-					else
-						count = ((u32b *)*((u32b **)((byte *)&level_data[level].wearables[origin][idx] + offset)))[i];
-
-					if (!count) continue;
-
-					err = stats_db_bind_ints(sql_stmt, 5, 0,
-						level, count, k_idx, origin, i);
-					if (err) return err;
-
-					STATS_DB_STEP_RESET(sql_stmt)
-				}
-			}
+	if (sh->gap) {
+		sh->gap--;
+		return 0;
+	}
 
-	return sqlite3_finalize(sql_stmt);
+	add = sh->next;
+	stats_shard_record(sh);
+	return add;
 }
 
 /**
- * Unfortunately, the arcane expression used to find the value of an array 
- * member of a struct differs depending on whether the member is declared
- * as an array or as a pointer. Pass in true if the member is an array, and
- * false if the member is a pointer.
+ * Counts are only stored to when there is something to add, so that writing
+ * a shard doesn't copy every page a forked worker shares with its parent
  */
-static int stats_write_db_wearables_2d_array(const char *field, 
-	int max_val1, int max_val2, bool array_p)
+static void stats_shard_counts(struct stats_shard *sh, u32b *counts, size_t n)
 {
-	char sql_buf[256];
-	sqlite3_stmt *sql_stmt;
-	int err, level, origin, idx, k_idx, i, j, offset;
+	size_t i;
 
-	strnfmt(sql_buf, 256, "INSERT INTO wearables_%s VALUES(?,?,?,?,?,?);",
-			field);
-	err = stats_db_stmt_prep(&sql_stmt, sql_buf);
-	if (err) return err;
+	for (i = 0; i < n; i++) {
+		long long add = stats_shard_value(sh, counts[i]);
 
-	offset = stats_wearables_data_offsetof(field);
-
-	for (level = 1; level < LEVEL_MAX; level++)
-		for (origin = 0; origin < ORIGIN_STATS; origin++)
-			for (idx = 0; idx < wearable_count + 1; idx++) {
-				k_idx = stats_lookup_index(wearables_index, 
-					z_info->k_max, idx);
+		if (add) counts[i] += add;
+	}
+}
 
-				/* Skip if pile */
-				if (! k_idx) continue;
+/**
+ * Write all the level_data accumulators to a shard, or add a shard back
+ * into them.  The shard starts with a header recording the table sizes the
+ * accumulators were made with, and ends with a record past the last count.
+ */
+static bool stats_shard_io(ang_file *f, bool merge)
+{
+	u32b header[6], check[6];
+	struct stats_shard sh = { f, merge, true, 0, 0 };
+	int i, j, k, l;
 
-				for (i = 0; i < max_val1; i++)
-					for (j = 0; j < max_val2; j++) {
-						/* This arcane expression finds the value of
-				 		* level_data[level].wearables[origin][idx].<field>[i][j]
-						*/
-						u32b count;
+	header[0] = STATS_SHARD_MAGIC;
+	header[1] = z_info->r_max;
+	header[2] = z_info->a_max;
+	header[3] = z_info->e_max;
+	header[4] = consumable_count;
+	header[5] = wearable_count;
+
+	if (merge) {
+		if (file_read(f, (char *)check, sizeof(check)) != (int)sizeof(check))
+			return false;
+		if (memcmp(header, check, sizeof(header)))
+			return false;
+		stats_shard_record(&sh);
+	} else if (!file_write(f, (char *)header, sizeof(header))) {
+		return false;
+	}
 
-						if (i == 0 && j == 0) continue;
+	for (i = 0; i < LEVEL_MAX; i++) {
+		struct level_data *ld = &level_data[i];
 
-						if (array_p)
-							count = ((u32b *)((byte *)&level_data[level].wearables[origin][idx] + offset))[i * max_val2 + j];
-						else
-							count = *(*((u32b **)((byte *)&level_data[level].wearables[origin][idx] + offset) + i) + j);
+		stats_shard_counts(&sh, ld->monsters, z_info->r_max);
+		stats_shard_counts(&sh, ld->obj_feelings, OBJ_FEEL_MAX);
+		stats_shard_counts(&sh, ld->mon_feelings, MON_FEEL_MAX);
+		for (j = 0; j < ORIGIN_STATS; j++) {
+			long long add = stats_shard_value(&sh, ld->gold[j]);
 
-						if (!count) continue;
+			if (add) ld->gold[j] += add;
+		}
 
-						err = stats_db_bind_ints(sql_stmt, 6, 0,
-							level, count, k_idx, origin, 
-							i, j);
-						if (err) return err;
+		for (j = 0; j < ORIGIN_STATS; j++) {
+			stats_shard_counts(&sh, ld->artifacts[j], z_info->a_max);
+			stats_shard_counts(&sh, ld->consumables[j], consumable_count + 1);
 
-						STATS_DB_STEP_RESET(sql_stmt)
-					}
+			for (k = 0; k < wearable_count + 1; k++) {
+				struct wearables_data *w = &ld->wearables[j][k];
+
+				stats_shard_counts(&sh, &w->count, 1);
+				stats_shard_counts(&sh, &w->dice[0][0], TOP_DICE * TOP_SIDES);
+				stats_shard_counts(&sh, w->ac, TOP_AC);
+				stats_shard_counts(&sh, w->hit, TOP_PLUS);
+				stats_shard_counts(&sh, w->dam, TOP_PLUS);
+				stats_shard_counts(&sh, w->egos, z_info->e_max);
+				stats_shard_counts(&sh, w->flags, OF_MAX);
+				for (l = 0; l < TOP_MOD; l++)
+					stats_shard_counts(&sh, w->modifiers[l], OBJ_MOD_MAX + 1);
 			}
+		}
+	}
 
-	return sqlite3_finalize(sql_stmt);
+	/* Write the closing record, or check we have arrived at it */
+	if (merge)
+		return sh.ok && !sh.gap && !sh.next;
+
+	sh.next = 0;
+	stats_shard_record(&sh);
+	return sh.ok;
 }
 
-static int stats_write_db(u32b run)
+/**
+ * Get the path of the given worker's shard file
+ */
+static void stats_shard_path(char *buf, size_t len, int which)
 {
-	char sql_buf[256];
-	int err;
+	char name[32];
 
-	/* Wrap entire write into a transaction */
-	err = stats_db_exec("BEGIN TRANSACTION;");
-	if (err) return err;
+	strnfmt(name, sizeof(name), "shard-%d.dat", which);
+	path_build(buf, len, ANGBAND_DIR_STATS, name);
+}
 
-	strnfmt(sql_buf, 256, 
-		"INSERT OR REPLACE INTO metadata VALUES('runs', %d);", run);
-	err = stats_db_exec(sql_buf);
-	if (err) return err;
+/**
+ * Write this worker's accumulators out to its shard file
+ */
+static bool stats_write_shard(void)
+{
+	char path[1024];
+	ang_file *f;
+	bool ok;
 
-	err = stats_write_db_level_data("monsters", z_info->r_max);
-	if (err) return err;
+	stats_shard_path(path, sizeof(path), worker);
+	f = file_open(path, MODE_WRITE, FTYPE_RAW);
+	if (!f) return false;
 
-	err = stats_write_db_level_data("obj_feelings", OBJ_FEEL_MAX);
-	if (err) return err;
+	ok = stats_shard_io(f, false);
+	return file_close(f) && ok;
+}
 
-	err = stats_write_db_level_data("mon_feelings", MON_FEEL_MAX);
-	if (err) return err;
+/**
+ * Add the given worker's shard into the accumulators, then remove it
+ */
+static bool stats_merge_shard(int which)
+{
+	char path[1024];
+	ang_file *f;
+	bool ok;
 
-	err = stats_write_db_level_data("gold", ORIGIN_STATS);
-	if (err) return err;
+	stats_shard_path(path, sizeof(path), which);
+	f = file_open(path, MODE_READ, -1);
+	if (!f) return false;
 
-	err = stats_write_db_level_data_items("artifacts", z_info->a_max, 
-		false);
-	if (err) return err;
+	ok = stats_shard_io(f, true);
+	file_close(f);
+	file_delete(path);
 
-	err = stats_write_db_level_data_items("consumables", 
-		consumable_count + 1, true);
-	if (err) return err;
+	return ok;
+}
 
-	err = stats_write_db_wearables_count();
-	if (err) return err;
+/**
+ * Get the path of the file a worker leaves to say why it failed
+ */
+static void stats_failure_path(char *buf, size_t len, int which)
+{
+	char name[32];
 
-	err = stats_write_db_wearables_2d_array("dice", TOP_DICE, TOP_SIDES, true);
-	if (err) return err;
+	strnfmt(name, sizeof(name), "shard-%d.failed", which);
+	path_build(buf, len, ANGBAND_DIR_STATS, name);
+}
 
-	err = stats_write_db_wearables_array("ac", TOP_AC, true);
-	if (err) return err;
+/**
+ * Leave word of why this worker is giving up, and stop at once, without
+ * running any exit handlers inherited from the parent
+ */
+static void stats_worker_fail(const char *why)
+{
+	char path[1024];
+	ang_file *f;
 
-	err = stats_write_db_wearables_array("hit", TOP_PLUS, true);
-	if (err) return err;
+	fflush(stdout);
+	stats_failure_path(path, sizeof(path), worker);
+	f = file_open(path, MODE_WRITE, FTYPE_TEXT);
+	if (f) {
+		file_putf(f, "%s\n", why);
+		file_close(f);
+	}
+	_exit(1);
+}
 
-	err = stats_write_db_wearables_array("dam", TOP_PLUS, true);
-	if (err) return err;
+/**
+ * A worker which quits, for whatever reason (including a caught signal),
+ * has failed: only the end of stats_run_workers() leaves with a shard
+ */
+static void stats_worker_quit(const char *str)
+{
+	stats_worker_fail(str ? str : "quit before finishing its runs");
+}
 
-	err = stats_write_db_wearables_array("egos", z_info->e_max, false);
-	if (err) return err;
+static void stats_worker_exit(void)
+{
+	stats_worker_fail("exited before finishing its runs");
+}
 
-	err = stats_write_db_wearables_array("flags", OF_MAX, true);
-	if (err) return err;
+/**
+ * Check whether the given worker left word that it failed, and if so get
+ * the reason and clear the word away
+ */
+static bool stats_worker_failed(int which, char *why, size_t len)
+{
+	char path[1024];
+	ang_file *f;
 
-	err = stats_write_db_wearables_2d_array("mods", TOP_MOD, OBJ_MOD_MAX + 1,
-											false);
-	if (err) return err;
+	stats_failure_path(path, sizeof(path), which);
+	f = file_open(path, MODE_READ, FTYPE_TEXT);
+	if (!f) return false;
 
-	/* Commit transaction */
-	err = stats_db_exec("COMMIT;");
-	if (err) return err;
+	if (!file_getl(f, why, len))
+		my_strcpy(why, "unknown reason", len);
+	file_close(f);
+	file_delete(path);
 
-	return SQLITE_OK;
+	return true;
 }
 
 /**
@@ -1465,19 +1804,180 @@ void progress_bar(u32b run, time_t start) {
 
 static void stats_cleanup_angband_run(void)
 {
-	if (player->history) mem_free(player->history);
+	int i;
+	struct chunk *town = chunk_find_name("Town");
+
+	/* Clear the last level's monsters while they still count against their
+	 * races, rather than after player_init() has zeroed the counts */
+	wipe_mon_list(cave, player);
+
+	/* Forget the town, so that the next run builds its own */
+	if (town) {
+		chunk_list_remove("Town");
+		cave_free(town);
+	}
+
+	/* Leave nothing for cleanup_player() to free a second time */
+	mem_free(player->history);
+	player->history = NULL;
+	for (i = 0; i < player->body.count; i++)
+		string_free(player->body.slots[i].name);
+	mem_free(player->body.slots);
+	string_free(player->body.name);
+	memset(&player->body, 0, sizeof(player->body));
+}
+
+/**
+ * Make this process's share of the runs, which is every num_jobs'th run
+ * starting with the worker's own, checkpointing as we go: to the database
+ * when running alone, to the worker's shard otherwise.
+ */
+static void stats_do_runs(struct artifact *a_info_save)
+{
+	u32b run, done = 0;
+	unsigned int i;
+	int err;
+	time_t start = time(NULL);
+
+	for (run = worker + 1; run <= num_runs; run += num_jobs) {
+		if (!quiet && !silent) progress_bar(run - 1, start);
+
+		if (randarts)
+			for (i = 0; i < z_info->a_max; i++)
+				memcpy(&a_info[i], &a_info_save[i], sizeof(struct artifact));
+
+		initialize_character(run);
+		unkill_uniques();
+		reset_artifacts();
+		descend_dungeon();
+		stats_cleanup_angband_run();
+		done++;
+
+		/* Checkpoint every so many runs */
+		if (done % RUNS_PER_CHECKPOINT == 0) {
+			if (num_jobs > 1) {
+				if (!stats_write_shard())
+					quit_fmt("Problems writing stats shard %d!", worker);
+			} else {
+				err = stats_write_db(run);
+				if (err) {
+					stats_close_db();
+					quit_fmt("Problems writing to database!  sqlite3 errno %d.",
+							 err);
+				}
+			}
+		}
+
+		/* The first worker makes one run in every num_jobs */
+		if (quiet && !silent && run >= 1000 && run % 1000 < (u32b)num_jobs) {
+			printf("Finished %d runs.\n", run - run % 1000);
+			fflush(stdout);
+		}
+	}
+
+	if (!quiet && !silent) progress_bar(num_runs, start);
 }
 
+#ifdef UNIX
+/**
+ * Fork a worker per job, each of which makes its share of the runs and
+ * leaves its accumulators in a shard file; then add the shards together,
+ * in worker order, into this process's accumulators.
+ */
+static void stats_run_workers(struct artifact *a_info_save)
+{
+	pid_t *pids = mem_zalloc(num_jobs * sizeof(pid_t));
+	char reason[1024];
+	int i, failed = -1;
+
+	/* Don't let the workers inherit anything still buffered */
+	fflush(stdout);
+
+	for (i = 0; i < num_jobs; i++) {
+		char path[1024];
+		pid_t pid;
+
+		/* Clear out word of any failure left by an earlier job */
+		stats_failure_path(path, sizeof(path), i);
+		file_delete(path);
+
+		pid = fork();
+
+		if (pid < 0) quit("Couldn't fork stats worker!");
+
+		if (pid == 0) {
+			/* Only the first worker reports progress */
+			worker = i;
+			silent = worker > 0;
+
+			/* However the worker stops, the parent will hear why */
+			quit_aux = stats_worker_quit;
+			atexit(stats_worker_exit);
+
+			stats_do_runs(a_info_save);
+			if (!stats_write_shard())
+				stats_worker_fail("couldn't write its shard");
+			fflush(stdout);
+
+			/* Skip the parent's exit handlers */
+			_exit(0);
+		}
+
+		pids[i] = pid;
+	}
+
+	/* Wait for every worker before reporting the first to fail */
+	for (i = 0; i < num_jobs; i++) {
+		char why[1024];
+		int status;
+
+		if (waitpid(pids[i], &status, 0) < 0) {
+			my_strcpy(why, "lost track of it", sizeof(why));
+		} else if (!stats_worker_failed(i, why, sizeof(why))) {
+			if (WIFEXITED(status) && !WEXITSTATUS(status)) continue;
+			if (WIFSIGNALED(status))
+				strnfmt(why, sizeof(why), "killed by signal %d",
+						WTERMSIG(status));
+			else
+				strnfmt(why, sizeof(why), "exited with status %d",
+						WEXITSTATUS(status));
+		}
+
+		if (failed < 0) {
+			failed = i;
+			my_strcpy(reason, why, sizeof(reason));
+		}
+	}
+	if (failed >= 0) {
+		for (i = 0; i < num_jobs; i++) {
+			char path[1024];
+
+			stats_shard_path(path, sizeof(path), i);
+			file_delete(path);
+		}
+		quit_fmt("Stats worker %d failed: %s", failed, reason);
+	}
+
+	if (!quiet) {
+		printf("\nMerging %d shards...", num_jobs);
+		fflush(stdout);
+	}
+
+	for (i = 0; i < num_jobs; i++)
+		if (!stats_merge_shard(i))
+			quit_fmt("Couldn't merge stats shard %d!", i);
+
+	mem_free(pids);
+}
+#endif
+
 static errr run_stats(void)
 {
-	u32b run;
-	struct artifact *a_info_save;
+	struct artifact *a_info_save = NULL;
 	unsigned int i;
 	int err;
 	bool status; 
 
-	time_t start;
-
 	prep_output_dir();
 	create_indices();
 	alloc_memory();
@@ -1494,49 +1994,29 @@ static errr run_stats(void)
 	status = stats_prep_db();
 	if (!status) quit("Couldn't prepare database!");
 
+	if (!seed_given)
+		seed_base = time(NULL);
 	if (!quiet) {
-		printf("Beginning %d runs...\n", num_runs);
+		printf("Beginning %d runs (seed %u, %d jobs)...\n", num_runs,
+			   seed_base, num_jobs);
 		fflush(stdout);
 	}
 
-	start = time(NULL);
-	for (run = 1; run <= num_runs; run++) {
-		if (!quiet) progress_bar(run - 1, start);
-
-		if (randarts)
-			for (i = 0; i < z_info->a_max; i++)
-				memcpy(&a_info[i], &a_info_save[i], sizeof(struct artifact));
-
-		initialize_character();
-		unkill_uniques();
-		reset_artifacts();
-		descend_dungeon();
-		stats_cleanup_angband_run();
-
-		/* Checkpoint every so many runs */
-		if (run % RUNS_PER_CHECKPOINT == 0) {
-			err = stats_write_db(run);
-			if (err) {
-				stats_db_close();
-				quit_fmt("Problems writing to database!  sqlite3 errno %d.",
-						 err);
-			}
-		}
-
-		if (quiet && run % 1000 == 0) {
-			printf("Finished %d runs.\n", run);
-			fflush(stdout);
-		}
-	}
+#ifdef UNIX
+	if (num_jobs > 1) {
+		stats_run_workers(a_info_save);
+		stats_note_all();
+	} else
+#endif
+		stats_do_runs(a_info_save);
 
 	if (!quiet) {
-		progress_bar(num_runs, start);
 		printf("\nSaving the data...\n");
 		fflush(stdout);
 	}
 
-	err = stats_write_db(run);
-	stats_db_close();
+	err = stats_write_db(num_runs);
+	stats_close_db();
 	if (err) quit_fmt("Problems writing to database!  sqlite3 errno %d.", err);
 
 	if (randarts)
@@ -1670,17 +2150,20 @@ static void term_data_link(int i) {
 	angband_term[i] = t;
 }
 
-const char help_stats[] = "Stats mode, subopts -q(uiet) -r(andarts) -n(# of runs) -s(no selling)";
+const char help_stats[] = "Stats mode, subopts -q(uiet) -r(andarts) -n(# of runs) -s(no selling) -j(# of jobs) -S(eed)";
 
 /**
  * Usage:
  *
- * angband -mstats -- [-q] [-r] [-nNNNN] [-s]
+ * angband -mstats -- [-q] [-r] [-nNNNN] [-s] [-jNN] [-SNNNN]
  *
  *   -q      Quiet mode (turn off progress messages)
  *   -r      Turn on randarts
  *   -nNNNN  Make NNNN runs through the dungeon (default: 1)
  *   -s      Turn on no-selling
+ *   -jNN    Share the runs between NN worker processes (default: 1)
+ *   -SNNNN  Seed the whole job with NNNN, so it can be run again
+ *           (default: the time)
  */
 
 errr init_stats(int argc, char *argv[]) {
@@ -1704,6 +2187,21 @@ errr init_stats(int argc, char *argv[]) {
 			no_selling = 1;
 			continue;
 		}
+		if (prefix(argv[i], "-S")) {
+			seed_base = strtoul(&argv[i][2], NULL, 0);
+			seed_given = true;
+			continue;
+		}
+		if (prefix(argv[i], "-j")) {
+			num_jobs = MAX(atoi(&argv[i][2]), 1);
+#ifndef UNIX
+			if (num_jobs > 1) {
+				printf("init-stats: -j needs fork(), running one job\n");
+				num_jobs = 1;
+			}
+#endif
+			continue;
+		}
 		printf("init-stats: bad argument '%s'\n", argv[i]);
 	}
 
@@ -918,8 +918,282 @@ struct parser *init_parse_monster(void) {
 	return p;
 }
 
+/**
+ * Store the monster races.  Bases are stored by name, and drops and mimicked
+ * objects by kind or artifact index, to be linked up again by
+ * monster_cache_read().
+ */
+static bool monster_cache_write(struct parser *p, struct parse_cache *c)
+{
+	struct monster_race *r;
+	u32b n = 0;
+
+	for (r = parser_priv(p); r; r = r->next)
+		n++;
+	parse_cache_put_u32b(c, n);
+	for (r = parser_priv(p); r; r = r->next) {
+		struct monster_blow *b;
+		struct monster_drop *d;
+		struct monster_friends *f;
+		struct monster_friends_base *fb;
+		struct monster_mimic *m;
+
+		parse_cache_put_u32b(c, r->ridx);
+		parse_cache_put_str(c, r->name);
+		parse_cache_put_str(c, r->text);
+		parse_cache_put_str(c, r->plural);
+		parse_cache_put_str(c, r->base ? r->base->name : NULL);
+		parse_cache_put_s32b(c, r->avg_hp);
+		parse_cache_put_s32b(c, r->ac);
+		parse_cache_put_s32b(c, r->sleep);
+		parse_cache_put_s32b(c, r->aaf);
+		parse_cache_put_s32b(c, r->speed);
+		parse_cache_put_s32b(c, r->mexp);
+		parse_cache_put_s32b(c, r->power);
+		parse_cache_put_s32b(c, r->scaled_power);
+		parse_cache_put_s32b(c, r->freq_innate);
+		parse_cache_put_s32b(c, r->freq_spell);
+		parse_cache_put(c, r->flags, RF_SIZE);
+		parse_cache_put(c, r->spell_flags, RSF_SIZE);
+		parse_cache_put_s32b(c, r->level);
+		parse_cache_put_s32b(c, r->rarity);
+		parse_cache_put_byte(c, r->d_attr);
+		parse_cache_put_u32b(c, r->d_char);
+
+		for (b = r->blow; b; b = b->next) {
+			parse_cache_put_byte(c, 1);
+			parse_cache_put_s32b(c, b->method);
+			parse_cache_put_s32b(c, b->effect);
+			parse_cache_put_rand(c, b->dice);
+		}
+		parse_cache_put_byte(c, 0);
+
+		for (d = r->drops; d; d = d->next) {
+			parse_cache_put_byte(c, 1);
+			parse_cache_put_u32b(c, d->kind ? d->kind->kidx : 0);
+			parse_cache_put_u32b(c, d->artifact ? d->artifact->aidx : 0);
+			parse_cache_put_u32b(c, d->percent_chance);
+			parse_cache_put_u32b(c, d->min);
+			parse_cache_put_u32b(c, d->max);
+		}
+		parse_cache_put_byte(c, 0);
+
+		for (f = r->friends; f; f = f->next) {
+			parse_cache_put_byte(c, 1);
+			parse_cache_put_str(c, f->name);
+			parse_cache_put_u32b(c, f->percent_chance);
+			parse_cache_put_u32b(c, f->number_dice);
+			parse_cache_put_u32b(c, f->number_side);
+		}
+		parse_cache_put_byte(c, 0);
+
+		for (fb = r->friends_base; fb; fb = fb->next) {
+			parse_cache_put_byte(c, 1);
+			parse_cache_put_str(c, fb->base->name);
+			parse_cache_put_u32b(c, fb->percent_chance);
+			parse_cache_put_u32b(c, fb->number_dice);
+			parse_cache_put_u32b(c, fb->number_side);
+		}
+		parse_cache_put_byte(c, 0);
+
+		for (m = r->mimic_kinds; m; m = m->next) {
+			parse_cache_put_byte(c, 1);
+			parse_cache_put_u32b(c, m->kind->kidx);
+		}
+		parse_cache_put_byte(c, 0);
+	}
+
+	return true;
+}
+
+static void monster_cache_free(struct monster_race *r)
+{
+	struct monster_race *next;
+
+	for (; r; r = next) {
+		struct monster_blow *b = r->blow;
+		struct monster_drop *d = r->drops;
+		struct monster_friends *f = r->friends;
+		struct monster_friends_base *fb = r->friends_base;
+		struct monster_mimic *m = r->mimic_kinds;
+
+		while (b) {
+			struct monster_blow *bn = b->next;
+			mem_free(b);
+			b = bn;
+		}
+		while (d) {
+			struct monster_drop *dn = d->next;
+			mem_free(d);
+			d = dn;
+		}
+		while (f) {
+			struct monster_friends *fn = f->next;
+			string_free(f->name);
+			mem_free(f);
+			f = fn;
+		}
+		while (fb) {
+			struct monster_friends_base *fbn = fb->next;
+			mem_free(fb);
+			fb = fbn;
+		}
+		while (m) {
+			struct monster_mimic *mn = m->next;
+			mem_free(m);
+			m = mn;
+		}
+		next = r->next;
+		string_free(r->plural);
+		string_free(r->text);
+		string_free(r->name);
+		mem_free(r);
+	}
+}
+
+/**
+ * Look up a monster base stored by name, noting if it has gone
+ */
+static struct monster_base *monster_cache_base(struct parse_cache *c,
+											   bool *ok)
+{
+	char *name = parse_cache_get_str(c);
+	struct monster_base *base = name ? lookup_monster_base(name) : NULL;
+
+	if (name && !base)
+		*ok = false;
+	string_free(name);
+	return base;
+}
+
+/**
+ * Read the monster races back from their cache, in list order; this must
+ * match monster_cache_write() and store every field the parser sets.
+ * PARSE_CACHE_VERSION in parser.c must be bumped whenever either changes.
+ */
+static bool monster_cache_read(struct parser *p, struct parse_cache *c)
+{
+	struct monster_race *head = NULL, **tail = &head;
+	u32b n = parse_cache_get_u32b(c);
+	bool ok = true;
+
+	while (n-- && ok && parse_cache_ok(c)) {
+		struct monster_race *r = mem_zalloc(sizeof(*r));
+		struct monster_blow **b_tail = &r->blow;
+		struct monster_drop **d_tail = &r->drops;
+		struct monster_friends **f_tail = &r->friends;
+		struct monster_friends_base **fb_tail = &r->friends_base;
+		struct monster_mimic **m_tail = &r->mimic_kinds;
+
+		*tail = r;
+		tail = &r->next;
+
+		r->ridx = parse_cache_get_u32b(c);
+		r->name = parse_cache_get_str(c);
+		r->text = parse_cache_get_str(c);
+		r->plural = parse_cache_get_str(c);
+		r->base = monster_cache_base(c, &ok);
+		r->avg_hp = parse_cache_get_s32b(c);
+		r->ac = parse_cache_get_s32b(c);
+		r->sleep = parse_cache_get_s32b(c);
+		r->aaf = parse_cache_get_s32b(c);
+		r->speed = parse_cache_get_s32b(c);
+		r->mexp = parse_cache_get_s32b(c);
+		r->power = parse_cache_get_s32b(c);
+		r->scaled_power = parse_cache_get_s32b(c);
+		r->freq_innate = parse_cache_get_s32b(c);
+		r->freq_spell = parse_cache_get_s32b(c);
+		parse_cache_get(c, r->flags, RF_SIZE);
+		parse_cache_get(c, r->spell_flags, RSF_SIZE);
+		r->level = parse_cache_get_s32b(c);
+		r->rarity = parse_cache_get_s32b(c);
+		r->d_attr = parse_cache_get_byte(c);
+		r->d_char = parse_cache_get_u32b(c);
+
+		while (parse_cache_get_byte(c)) {
+			struct monster_blow *b = mem_zalloc(sizeof(*b));
+
+			*b_tail = b;
+			b_tail = &b->next;
+			b->method = parse_cache_get_s32b(c);
+			b->effect = parse_cache_get_s32b(c);
+			b->dice = parse_cache_get_rand(c);
+		}
+
+		/* Drops are linked by kind or artifact index */
+		while (parse_cache_get_byte(c)) {
+			struct monster_drop *d = mem_zalloc(sizeof(*d));
+			u32b kidx = parse_cache_get_u32b(c);
+			u32b aidx = parse_cache_get_u32b(c);
+
+			*d_tail = d;
+			d_tail = &d->next;
+			if (kidx >= (u32b)z_info->k_max || aidx >= (u32b)z_info->a_max)
+				ok = false;
+			else {
+				d->kind = kidx ? &k_info[kidx] : NULL;
+				d->artifact = aidx ? &a_info[aidx] : NULL;
+			}
+			d->percent_chance = parse_cache_get_u32b(c);
+			d->min = parse_cache_get_u32b(c);
+			d->max = parse_cache_get_u32b(c);
+		}
+
+		/* Friends keep their names until finish_parse_monster() */
+		while (parse_cache_get_byte(c)) {
+			struct monster_friends *f = mem_zalloc(sizeof(*f));
+
+			*f_tail = f;
+			f_tail = &f->next;
+			f->name = parse_cache_get_str(c);
+			f->percent_chance = parse_cache_get_u32b(c);
+			f->number_dice = parse_cache_get_u32b(c);
+			f->number_side = parse_cache_get_u32b(c);
+			if (!f->name)
+				ok = false;
+		}
+
+		while (parse_cache_get_byte(c)) {
+			struct monster_friends_base *fb = mem_zalloc(sizeof(*fb));
+
+			*fb_tail = fb;
+			fb_tail = &fb->next;
+			fb->base = monster_cache_base(c, &ok);
+			fb->percent_chance = parse_cache_get_u32b(c);
+			fb->number_dice = parse_cache_get_u32b(c);
+			fb->number_side = parse_cache_get_u32b(c);
+			if (!fb->base)
+				ok = false;
+		}
+
+		while (parse_cache_get_byte(c)) {
+			struct monster_mimic *m = mem_zalloc(sizeof(*m));
+			u32b kidx = parse_cache_get_u32b(c);
+
+			*m_tail = m;
+			m_tail = &m->next;
+			if (kidx >= (u32b)z_info->k_max)
+				ok = false;
+			else
+				m->kind = &k_info[kidx];
+		}
+	}
+
+	if (!ok || !parse_cache_ok(c)) {
+		monster_cache_free(head);
+		return false;
+	}
+
+	parser_setpriv(p, head);
+	return true;
+}
+
 static errr run_parse_monster(struct parser *p) {
-	return parse_file_quit_not_found(p, "monster");
+	/* Objects are linked by index, and area of action uses max_sight */
+	static const char *sources[] = { "monster", "monster_base", "object",
+									 "artifact", "constants", NULL };
+	return parse_file_cached(p, "monster", sources, monster_cache_read,
+							 monster_cache_write);
 }
 
 static errr finish_parse_monster(struct parser *p) {
@@ -988,6 +1262,7 @@ static errr finish_parse_monster(struct parser *p) {
 		mem_free(r);
 	}
 	z_info->r_max += 1;
+	monster_lookup_init();
 
 	/* Convert friend names into race pointers */
 	for (i = 0; i < z_info->r_max; i++) {
@@ -1027,6 +1302,8 @@ static void cleanup_monster(void)
 {
 	int ridx;
 
+	monster_lookup_free();
+
 	for (ridx = 0; ridx < z_info->r_max; ridx++) {
 		struct monster_race *r = &r_info[ridx];
 		struct monster_drop *d;
@@ -39,6 +39,44 @@ s16b num_repro;
 static s16b alloc_race_size;
 static struct alloc_entry *alloc_race_table;
 
+/**
+ * The "prob3" pass of the monster allocation table for one depth, kept until
+ * the restriction, the unique population, the depth cap or the season change
+ */
+struct race_alloc_cache {
+	long *cumul;		/* Running total of prob3 over the table */
+	long total;			/* Total of prob3 at or above this depth */
+	u32b prep_gen;		/* Restriction generation it was built under */
+	u32b unique_gen;	/* Unique population generation it was built under */
+	int depth_cap;		/* Player depth, for RF_FORCE_DEPTH */
+	bool seasonal;		/* Whether seasonal monsters were allowed */
+	bool valid;
+};
+
+/**
+ * A restriction of the monster allocation table (the "prob2" pass), with
+ * its own allocation caches.  The first view is the unrestricted table, the
+ * second is for restrictions which must be worked out afresh every time, and
+ * the rest hold restrictions remembered by get_mon_num_prep_cached().
+ */
+struct race_alloc_view {
+	bool (*hook)(struct monster_race *race);
+	const void *key;	/* What the hook depends on besides the race */
+	bool *allowed;		/* Which table entries pass the hook */
+	u32b prep_gen;		/* Bumped whenever allowed changes */
+	u32b last_used;		/* For replacing the least recently used view */
+	struct race_alloc_cache *cache;		/* One per depth, filled on demand */
+};
+
+#define RACE_ALLOC_VIEWS 16
+#define RACE_VIEW_ALL 0
+#define RACE_VIEW_SCRATCH 1
+
+static struct race_alloc_view race_alloc_views[RACE_ALLOC_VIEWS];
+static struct race_alloc_view *race_alloc_view;
+static u32b race_view_clock;
+static u32b race_unique_gen;
+
 static void init_race_allocs(void) {
 	int i;
 	struct monster_race *race;
@@ -116,12 +154,287 @@ static void init_race_allocs(void) {
 	}
 	mem_free(aux);
 	mem_free(num);
+
+	/* Views of the table, each with an allocation cache per depth */
+	for (i = 0; i < RACE_ALLOC_VIEWS; i++) {
+		struct race_alloc_view *view = &race_alloc_views[i];
+
+		view->allowed = mem_zalloc(alloc_race_size * sizeof(bool));
+		view->cache = mem_zalloc(z_info->max_depth *
+								 sizeof(struct race_alloc_cache));
+	}
+
+	/* Start out unrestricted */
+	for (i = 0; i < alloc_race_size; i++)
+		race_alloc_views[RACE_VIEW_ALL].allowed[i] = true;
+	race_alloc_view = &race_alloc_views[RACE_VIEW_ALL];
 }
 
 static void cleanup_race_allocs(void) {
+	int i, j;
+
+	for (i = 0; i < RACE_ALLOC_VIEWS; i++) {
+		struct race_alloc_view *view = &race_alloc_views[i];
+
+		for (j = 0; j < z_info->max_depth; j++)
+			mem_free(view->cache[j].cumul);
+		mem_free(view->cache);
+		mem_free(view->allowed);
+		memset(view, 0, sizeof(*view));
+	}
+	race_alloc_view = NULL;
 	mem_free(alloc_race_table);
 }
 
+/**
+ * Enter a newly placed monster in the turn order.  Monsters are placed
+ * waiting for their turn, unless they are being restored from a savefile
+ * after acting in the current game turn; MFLAG_HANDLED is only kept in the
+ * savefile, the bitmaps are used in play.
+ */
+void mon_schedule_add(struct chunk *c, struct monster *mon)
+{
+	int word = mon->midx / MON_WORD_BITS;
+	u64b bit = (u64b)1 << (mon->midx % MON_WORD_BITS);
+
+	c->mon_live[word] |= bit;
+	if (mflag_has(mon->mflag, MFLAG_HANDLED)) {
+		mflag_off(mon->mflag, MFLAG_HANDLED);
+		c->mon_waiting[word] &= ~bit;
+		c->mon_handled_energy = MAX(c->mon_handled_energy, mon->energy);
+	} else {
+		c->mon_waiting[word] |= bit;
+		c->mon_waiting_energy = MAX(c->mon_waiting_energy, mon->energy);
+	}
+}
+
+/**
+ * Take a monster list slot out of the turn order
+ */
+static void mon_schedule_remove(struct chunk *c, int m_idx)
+{
+	u64b bit = (u64b)1 << (m_idx % MON_WORD_BITS);
+
+	c->mon_live[m_idx / MON_WORD_BITS] &= ~bit;
+	c->mon_waiting[m_idx / MON_WORD_BITS] &= ~bit;
+}
+
+/**
+ * Note that a monster has had its turn for this game turn
+ */
+void mon_schedule_done(struct chunk *c, struct monster *mon)
+{
+	c->mon_waiting[mon->midx / MON_WORD_BITS] &=
+		~((u64b)1 << (mon->midx % MON_WORD_BITS));
+	c->mon_handled_energy = MAX(c->mon_handled_energy, mon->energy);
+}
+
+/**
+ * Check whether a monster has had its turn for this game turn
+ */
+bool mon_is_handled(struct chunk *c, int m_idx)
+{
+	u64b bit = (u64b)1 << (m_idx % MON_WORD_BITS);
+
+	return (c->mon_live[m_idx / MON_WORD_BITS] & bit) &&
+		!(c->mon_waiting[m_idx / MON_WORD_BITS] & bit);
+}
+
+/**
+ * Find the highest indexed monster below m_idx which is still waiting for
+ * its turn, or 0 if there is none
+ */
+int mon_schedule_prev(struct chunk *c, int m_idx)
+{
+	int i = m_idx - 1, word, bit;
+	u64b bits;
+
+	if (i < 1) return 0;
+
+	/* Only look at the bits below m_idx in its own word */
+	word = i / MON_WORD_BITS;
+	bits = c->mon_waiting[word] &
+		(~(u64b)0 >> (MON_WORD_BITS - 1 - i % MON_WORD_BITS));
+	while (!bits) {
+		if (!word) return 0;
+		bits = c->mon_waiting[--word];
+	}
+
+	/* Take the highest bit */
+	bit = MON_WORD_BITS - 1;
+	while (!(bits & ((u64b)1 << bit))) bit--;
+	return word * MON_WORD_BITS + bit;
+}
+
+/**
+ * Start a new game turn, with every monster waiting for its turn
+ */
+void mon_schedule_reset(struct chunk *c)
+{
+	int words = (cave_monster_max(c) + MON_WORD_BITS - 1) / MON_WORD_BITS;
+
+	memcpy(c->mon_waiting, c->mon_live, words * sizeof(u64b));
+	c->mon_waiting_energy = MAX(c->mon_waiting_energy, c->mon_handled_energy);
+	c->mon_handled_energy = 0;
+}
+
+/**
+ * The region of the map a grid belongs to
+ */
+static int mon_region_of(struct chunk *c, int y, int x)
+{
+	return (y >> MON_REGION_SHIFT) * c->mon_region_wid +
+		(x >> MON_REGION_SHIFT);
+}
+
+/**
+ * Enter a placed monster in the list for its region of the map, and in the
+ * light carriers if it has a light
+ */
+void mon_index_add(struct chunk *c, struct monster *mon)
+{
+	int region = mon_region_of(c, mon->fy, mon->fx);
+	int first = c->mon_region[region];
+
+	c->mon_region_prev[mon->midx] = 0;
+	c->mon_region_next[mon->midx] = first;
+	if (first) c->mon_region_prev[first] = mon->midx;
+	c->mon_region[region] = mon->midx;
+
+	if (rf_has(mon->race->flags, RF_HAS_LIGHT))
+		c->mon_light[mon->midx / MON_WORD_BITS] |=
+			(u64b)1 << (mon->midx % MON_WORD_BITS);
+}
+
+/**
+ * Take a monster out of the list for the region of the map containing (y, x)
+ */
+static void mon_index_unlink(struct chunk *c, int m_idx, int y, int x)
+{
+	int prev = c->mon_region_prev[m_idx];
+	int next = c->mon_region_next[m_idx];
+
+	if (prev)
+		c->mon_region_next[prev] = next;
+	else
+		c->mon_region[mon_region_of(c, y, x)] = next;
+	if (next) c->mon_region_prev[next] = prev;
+}
+
+/**
+ * Take a monster out of the spatial index before it leaves its slot
+ */
+static void mon_index_remove(struct chunk *c, struct monster *mon)
+{
+	mon_index_unlink(c, mon->midx, mon->fy, mon->fx);
+	c->mon_light[mon->midx / MON_WORD_BITS] &=
+		~((u64b)1 << (mon->midx % MON_WORD_BITS));
+}
+
+/**
+ * Set a monster's location, keeping the spatial index up to date
+ */
+void mon_index_move(struct chunk *c, struct monster *mon, int y, int x)
+{
+	if (mon_region_of(c, y, x) != mon_region_of(c, mon->fy, mon->fx)) {
+		mon_index_unlink(c, mon->midx, mon->fy, mon->fx);
+		mon->fy = y;
+		mon->fx = x;
+		mon_index_add(c, mon);
+	} else {
+		mon->fy = y;
+		mon->fx = x;
+	}
+}
+
+static int cmp_midx(const void *a, const void *b)
+{
+	return *(const s16b *)a - *(const s16b *)b;
+}
+
+/**
+ * Find the monsters in the rectangle from (y1, x1) to (y2, x2) inclusive.
+ *
+ * \param found receives the indices of the monsters, in increasing order, so
+ * has to have room for every monster on the level; c->mon_found will do for
+ * callers that are finished with the results before the next query
+ * \return the number of monsters found
+ */
+int mon_index_rect(struct chunk *c, int y1, int x1, int y2, int x2,
+				   s16b *found)
+{
+	int ry, rx, n = 0;
+
+	y1 = MAX(y1, 0);
+	x1 = MAX(x1, 0);
+	y2 = MIN(y2, c->height - 1);
+	x2 = MIN(x2, c->width - 1);
+	if (y1 > y2 || x1 > x2) return 0;
+
+	for (ry = y1 >> MON_REGION_SHIFT; ry <= y2 >> MON_REGION_SHIFT; ry++) {
+		for (rx = x1 >> MON_REGION_SHIFT; rx <= x2 >> MON_REGION_SHIFT;
+			 rx++) {
+			int m_idx = c->mon_region[ry * c->mon_region_wid + rx];
+
+			for (; m_idx; m_idx = c->mon_region_next[m_idx]) {
+				struct monster *mon = cave_monster(c, m_idx);
+
+				if (mon->fy < y1 || mon->fy > y2) continue;
+				if (mon->fx < x1 || mon->fx > x2) continue;
+				found[n++] = m_idx;
+			}
+		}
+	}
+
+	/* Callers see the monsters in the same order as a scan of the list */
+	sort(found, n, sizeof(*found), cmp_midx);
+	return n;
+}
+
+/**
+ * Find the monsters no further than distance r from (y, x); see
+ * mon_index_rect()
+ */
+int mon_index_radius(struct chunk *c, int y, int x, int r, s16b *found)
+{
+	int i, n = 0;
+	int count = mon_index_rect(c, y - r, x - r, y + r, x + r, found);
+
+	for (i = 0; i < count; i++) {
+		struct monster *mon = cave_monster(c, found[i]);
+
+		if (distance(y, x, mon->fy, mon->fx) <= r)
+			found[n++] = found[i];
+	}
+
+	return n;
+}
+
+/**
+ * Find the lowest indexed light-carrying monster above m_idx, or 0 if there
+ * is none
+ */
+int mon_index_next_light(struct chunk *c, int m_idx)
+{
+	int i = m_idx + 1, word, bit;
+	int words = (cave_monster_max(c) + MON_WORD_BITS - 1) / MON_WORD_BITS;
+	u64b bits;
+
+	/* Only look at the bits from i up in its own word */
+	word = i / MON_WORD_BITS;
+	if (word >= words) return 0;
+	bits = c->mon_light[word] & (~(u64b)0 << (i % MON_WORD_BITS));
+	while (!bits) {
+		if (++word >= words) return 0;
+		bits = c->mon_light[word];
+	}
+
+	/* Take the lowest bit */
+	bit = 0;
+	while (!(bits & ((u64b)1 << bit))) bit++;
+	return word * MON_WORD_BITS + bit;
+}
+
 /**
  * Deletes a monster by index.
  *
@@ -144,6 +457,7 @@ void delete_monster_idx(int m_idx)
 
 	/* Hack -- Reduce the racial counter */
 	mon->race->cur_num--;
+	if (rf_has(mon->race->flags, RF_UNIQUE)) mon_uniques_changed();
 
 	/* Hack -- count the number of "reproducers" */
 	if (rf_has(mon->race->flags, RF_MULTIPLY)) num_repro--;
@@ -176,13 +490,16 @@ void delete_monster_idx(int m_idx)
 
 	/* Delete mimicked objects */
 	if (mon->mimicked_obj) {
-		square_excise_object(cave, y, x, mon->mimicked_obj);
+		square_excise_object(cave, mon->mimicked_obj->iy,
+							 mon->mimicked_obj->ix, mon->mimicked_obj);
 		delist_object(cave, mon->mimicked_obj);
 		object_delete(&mon->mimicked_obj);
 	}
 
 	/* Wipe the Monster */
+	mon_index_remove(cave, mon);
 	memset(mon, 0, sizeof(struct monster));
+	mon_schedule_remove(cave, m_idx);
 
 	/* Count monsters */
 	cave->mon_cnt--;
@@ -225,6 +542,9 @@ static void compact_monsters_aux(int i1, int i2)
 	/* Update the cave */
 	cave->squares[y][x].mon = i2;
 	
+	/* Leave its place in the spatial index */
+	mon_index_remove(cave, mon);
+
 	/* Update midx */
 	mon->midx = i2;
 
@@ -244,9 +564,16 @@ static void compact_monsters_aux(int i1, int i2)
 	if (player->upkeep->health_who == mon)
 		player->upkeep->health_who = cave_monster(cave, i2);
 
+	/* Move its place in the turn order */
+	if (mon_is_handled(cave, i1))
+		mflag_on(mon->mflag, MFLAG_HANDLED);
+	mon_schedule_remove(cave, i1);
+
 	/* Hack -- move monster */
 	memcpy(cave_monster(cave, i2), cave_monster(cave, i1),
 		   sizeof(struct monster));
+	mon_schedule_add(cave, cave_monster(cave, i2));
+	mon_index_add(cave, cave_monster(cave, i2));
 
 	/* Hack -- wipe hole */
 	memset(cave_monster(cave, i1), 0, sizeof(struct monster));
@@ -373,6 +700,7 @@ void wipe_mon_list(struct chunk *c, struct player *p)
 
 		/* Reduce the racial counter */
 		mon->race->cur_num--;
+		if (rf_has(mon->race->flags, RF_UNIQUE)) mon_uniques_changed();
 
 		/* Monster is gone */
 		c->squares[mon->fy][mon->fx].mon = 0;
@@ -381,6 +709,17 @@ void wipe_mon_list(struct chunk *c, struct player *p)
 		memset(mon, 0, sizeof(struct monster));
 	}
 
+	/* Nobody is left to take a turn */
+	memset(c->mon_live, 0, (cave_monster_max(c) + MON_WORD_BITS - 1)
+		   / MON_WORD_BITS * sizeof(u64b));
+	memset(c->mon_waiting, 0, (cave_monster_max(c) + MON_WORD_BITS - 1)
+		   / MON_WORD_BITS * sizeof(u64b));
+	memset(c->mon_light, 0, (cave_monster_max(c) + MON_WORD_BITS - 1)
+		   / MON_WORD_BITS * sizeof(u64b));
+	memset(c->mon_region, 0, c->mon_region_count * sizeof(s16b));
+	c->mon_waiting_energy = 0;
+	c->mon_handled_energy = 0;
+
 	/* Reset "cave->mon_max" */
 	c->mon_max = 1;
 
@@ -446,64 +785,227 @@ s16b mon_pop(struct chunk *c)
 }
 
 
+/**
+ * Work out which entries of the allocation table pass a restriction
+ */
+static void race_alloc_view_fill(struct race_alloc_view *view,
+		bool (*get_mon_num_hook)(struct monster_race *race), const void *key)
+{
+	int i;
+
+	for (i = 0; i < alloc_race_size; i++)
+		view->allowed[i] =
+			(*get_mon_num_hook)(&r_info[alloc_race_table[i].index]);
+	view->hook = get_mon_num_hook;
+	view->key = key;
+
+	/* Cached allocations for this view are now stale */
+	view->prep_gen++;
+}
+
 /**
  * Apply a "monster restriction function" to the "monster allocation table".
  * This way, we can use get_mon_num() to get a level-appropriate monster that
  * satisfies certain conditions (such as belonging to a particular monster
  * family).
+ *
+ * Lifting the restriction (with a NULL hook) costs nothing, and leaves the
+ * unrestricted allocation caches as they were.
  */
 void get_mon_num_prep(bool (*get_mon_num_hook)(struct monster_race *race))
+{
+	/* No restriction */
+	if (!get_mon_num_hook) {
+		race_alloc_view = &race_alloc_views[RACE_VIEW_ALL];
+		return;
+	}
+
+	/* Test every monster */
+	race_alloc_view = &race_alloc_views[RACE_VIEW_SCRATCH];
+	race_alloc_view_fill(race_alloc_view, get_mon_num_hook, NULL);
+}
+
+/**
+ * Apply a monster restriction function which depends only on the race and
+ * on what `key` stands for (a summon type, a pit profile and so on), like
+ * get_mon_num_prep().  The restriction and the allocation caches built
+ * under it are remembered, so that preparing it again with the same key
+ * is cheap.
+ *
+ * Hooks which use the RNG or other changing state must not be cached.
+ */
+void get_mon_num_prep_cached(bool (*get_mon_num_hook)(struct monster_race *race),
+							 const void *key)
 {
 	int i;
+	struct race_alloc_view *view = NULL;
+
+	if (!get_mon_num_hook) {
+		get_mon_num_prep(NULL);
+		return;
+	}
+
+	/* Look for the restriction, or else the least recently used view */
+	for (i = RACE_VIEW_SCRATCH + 1; i < RACE_ALLOC_VIEWS; i++) {
+		struct race_alloc_view *try = &race_alloc_views[i];
+
+		if (try->hook == get_mon_num_hook && try->key == key) {
+			view = try;
+			break;
+		}
+		if (!view || try->last_used < view->last_used)
+			view = try;
+	}
+
+	/* Test every monster if it was not there */
+	if (view->hook != get_mon_num_hook || view->key != key)
+		race_alloc_view_fill(view, get_mon_num_hook, key);
+
+	view->last_used = ++race_view_clock;
+	race_alloc_view = view;
+}
 
-	/* Scan the allocation table */
+/**
+ * Whether seasonal monsters may appear, only consulting the calendar again
+ * once the day has changed
+ */
+static bool mon_season_allowed(void)
+{
+	static time_t next_check = 0;
+	static bool allowed = false;
+	time_t cur_time = time(NULL);
+
+	if (cur_time >= next_check) {
+		struct tm *date = localtime(&cur_time);
+
+		/* No seasonal monsters outside of Christmas */
+		allowed = (date->tm_mon == 11 && date->tm_mday >= 24 &&
+				   date->tm_mday <= 26);
+
+		/* Look again at midnight */
+		next_check = cur_time + (23 - date->tm_hour) * 3600L +
+			(59 - date->tm_min) * 60L + (60 - date->tm_sec);
+	}
+
+	return allowed;
+}
+
+/**
+ * Note that a unique has been placed, removed, killed or revived, so that
+ * the allocation caches built under the old unique population are rebuilt.
+ * Anything changing cur_num or max_num of a unique race must call this.
+ */
+void mon_uniques_changed(void)
+{
+	race_unique_gen++;
+}
+
+/**
+ * Get the allocation cache for the given level, rebuilding the "prob3" pass
+ * of the allocation table if anything it depends on has changed.
+ */
+static const struct race_alloc_cache *get_mon_num_cache(int level)
+{
+	int i;
+	long total = 0L;
+	bool seasonal = mon_season_allowed();
+	struct race_alloc_view *view = race_alloc_view;
+	struct race_alloc_cache *cache;
+
+	/* Every race is shallower than max_depth (init_race_allocs() groups
+	 * them by level in an array of that size), so any deeper level picks
+	 * from exactly the same entries and can share the deepest cache */
+	level = MIN(MAX(level, 0), z_info->max_depth - 1);
+	cache = &view->cache[level];
+
+	/* Reuse the cache if possible */
+	if (cache->valid && cache->prep_gen == view->prep_gen &&
+		cache->unique_gen == race_unique_gen &&
+		cache->depth_cap == player->depth && cache->seasonal == seasonal)
+		return cache;
+
+	if (!cache->cumul)
+		cache->cumul = mem_zalloc(alloc_race_size * sizeof(long));
+
+	/* Process probabilities */
 	for (i = 0; i < alloc_race_size; i++) {
 		alloc_entry *entry = &alloc_race_table[i];
+		struct monster_race *race = &r_info[entry->index];
+		int prob = view->allowed[i] ? entry->prob1 : 0;
 
-		/* Accept monsters which pass the restriction, if any */
-		if (!get_mon_num_hook || (*get_mon_num_hook)(&r_info[entry->index]))
-			entry->prob2 = entry->prob1;
+		/* Monsters are sorted by depth */
+		if (entry->level > level) break;
 
-		/* Do not use this monster */
-		else
-			entry->prob2 = 0;
+		/* No town monsters in dungeon */
+		if ((level > 0) && (entry->level <= 0))
+			prob = 0;
+
+		/* No seasonal monsters outside of Christmas */
+		else if (rf_has(race->flags, RF_SEASONAL) && !seasonal)
+			prob = 0;
+
+		/* Only one copy of a a unique must be around at the same time */
+		else if (rf_has(race->flags, RF_UNIQUE) &&
+				 race->cur_num >= race->max_num)
+			prob = 0;
+
+		/* Some monsters never appear out of depth */
+		else if (rf_has(race->flags, RF_FORCE_DEPTH) &&
+				 race->level > player->depth)
+			prob = 0;
+
+		/* Total */
+		total += prob;
+		cache->cumul[i] = total;
 	}
 
-	return;
+	/* Entries past this depth can never be picked */
+	for (; i < alloc_race_size; i++)
+		cache->cumul[i] = total;
+
+	cache->total = total;
+	cache->prep_gen = view->prep_gen;
+	cache->unique_gen = race_unique_gen;
+	cache->depth_cap = player->depth;
+	cache->seasonal = seasonal;
+	cache->valid = true;
+
+	return cache;
 }
 
 /**
- * Helper function for get_mon_num(). Scans the prepared monster allocation
- * table and picks a random monster. Returns the index of a monster in
- * `table`.
+ * Helper function for get_mon_num(). Picks a random monster from the
+ * prepared allocation cache, by binary search for the first entry whose
+ * running total exceeds the random value.
  */
-static struct monster_race *get_mon_race_aux(long total,
-											 const alloc_entry *table)
+static struct monster_race *get_mon_race_aux(const struct race_alloc_cache *cache)
 {
-	int i;
+	int low = 0, high = alloc_race_size - 1;
 
 	/* Pick a monster */
-	long value = randint0(total);
+	long value = randint0(cache->total);
 
 	/* Find the monster */
-	for (i = 0; i < alloc_race_size; i++) {
-		/* Found the entry */
-		if (value < table[i].prob3) break;
+	while (low < high) {
+		int mid = (low + high) / 2;
 
-		/* Decrement */
-		value -= table[i].prob3;
+		if (value < cache->cumul[mid])
+			high = mid;
+		else
+			low = mid + 1;
 	}
-	
-	return &r_info[table[i].index];
+
+	return &r_info[alloc_race_table[low].index];
 }
 
 /**
  * Chooses a monster race that seems "appropriate" to the given level
  *
- * This function uses the "prob2" field of the "monster allocation table",
- * and various local information, to calculate the "prob3" field of the
- * same table, which is then used to choose an "appropriate" monster, in
- * a relatively efficient manner.
+ * This function uses the current restriction of the "monster allocation
+ * table", and various local information, to calculate the "prob3" pass of
+ * the same table, which is then used to choose an "appropriate" monster, in
+ * a relatively efficient manner.  The result of that calculation is cached
+ * per depth until something it depends on changes.
  *
  * Note that "town" monsters will *only* be created in the town, and
  * "normal" monsters will *never* be created in the town, unless the
@@ -521,63 +1023,23 @@ static struct monster_race *get_mon_race_aux(long total,
  */
 struct monster_race *get_mon_num(int level)
 {
-	int i, p;
-
-	long total;
+	int p;
 
 	struct monster_race *race;
 
-	alloc_entry *table = alloc_race_table;
+	const struct race_alloc_cache *cache;
 
 	/* Occasionally produce a nastier monster in the dungeon */
 	if (level > 0 && one_in_(z_info->ood_monster_chance))
 		level += MIN(level / 4 + 2, z_info->ood_monster_amount);
 
-	total = 0L;
-
-	/* Process probabilities */
-	for (i = 0; i < alloc_race_size; i++) {
-		time_t cur_time = time(NULL);
-		struct tm *date = localtime(&cur_time);
-
-		/* Monsters are sorted by depth */
-		if (table[i].level > level) break;
-
-		/* Default */
-		table[i].prob3 = 0;
-
-		/* No town monsters in dungeon */
-		if ((level > 0) && (table[i].level <= 0)) continue;
-
-		/* Get the chosen monster */
-		race = &r_info[table[i].index];
-
-		/* No seasonal monsters outside of Christmas */
-		if (rf_has(race->flags, RF_SEASONAL) && 
-			!(date->tm_mon == 11 && date->tm_mday >= 24 && date->tm_mday <= 26))
-			continue;
-
-		/* Only one copy of a a unique must be around at the same time */
-		if (rf_has(race->flags, RF_UNIQUE) && 
-				race->cur_num >= race->max_num)
-			continue;
-
-		/* Some monsters never appear out of depth */
-		if (rf_has(race->flags, RF_FORCE_DEPTH) && race->level > player->depth)
-			continue;
-
-		/* Accept */
-		table[i].prob3 = table[i].prob2;
-
-		/* Total */
-		total += table[i].prob3;
-	}
+	cache = get_mon_num_cache(level);
 
 	/* No legal monsters */
-	if (total <= 0) return NULL;
+	if (cache->total <= 0) return NULL;
 
 	/* Pick a monster */
-	race = get_mon_race_aux(total, table);
+	race = get_mon_race_aux(cache);
 
 	/* Try for a "harder" monster once (50%) or twice (10%) */
 	p = randint0(100);
@@ -586,7 +1048,7 @@ struct monster_race *get_mon_num(int level)
 		struct monster_race *old = race;
 
 		/* Pick a new monster */
-		race = get_mon_race_aux(total, table);
+		race = get_mon_race_aux(cache);
 
 		/* Keep the deepest one */
 		if (race->level < old->level) race = old;
@@ -597,7 +1059,7 @@ struct monster_race *get_mon_num(int level)
 		struct monster_race *old = race;
 
 		/* Pick a monster */
-		race = get_mon_race_aux(total, table);
+		race = get_mon_race_aux(cache);
 
 		/* Keep the deepest one */
 		if (race->level < old->level) race = old;
@@ -779,11 +1241,13 @@ s16b place_monster(struct chunk *c, int y, int x, struct monster *mon,
 
 	/* Set the ID */
 	new_mon->midx = m_idx;
+	mon_schedule_add(c, new_mon);
 
 	/* Set the location */
 	c->squares[y][x].mon = new_mon->midx;
 	new_mon->fy = y;
 	new_mon->fx = x;
+	mon_index_add(c, new_mon);
 	assert(square_monster(c, y, x) == new_mon);
 
 	update_mon(new_mon, c, true);
@@ -793,6 +1257,7 @@ s16b place_monster(struct chunk *c, int y, int x, struct monster *mon,
 
 	/* Count racial occurrences */
 	new_mon->race->cur_num++;
+	if (rf_has(new_mon->race->flags, RF_UNIQUE)) mon_uniques_changed();
 
 	/* Create the monster's drop, if any */
 	if (origin)
@@ -1227,7 +1692,7 @@ bool place_new_monster(struct chunk *c, int y, int x, struct monster_race *race,
 		place_monster_base = friends_base->base;
 
 		/* Prepare allocation table */
-		get_mon_num_prep(place_monster_base_okay);
+		get_mon_num_prep_cached(place_monster_base_okay, place_monster_base);
 
 		/* Pick a random race */
 		friends_race = get_mon_num(race->level);
@@ -1351,9 +1816,15 @@ void monster_death(struct monster *mon, bool stats)
 	bool visible = (mflag_has(mon->mflag, MFLAG_VISIBLE) ||
 					rf_has(mon->race->flags, RF_UNIQUE));
 
-	/* Delete any mimicked objects */
-	if (mon->mimicked_obj)
+	/* Delete any mimicked objects, which are still on the floor where the
+	 * mimic was placed (it may have been moved since) */
+	if (mon->mimicked_obj) {
+		struct object *mimicked = mon->mimicked_obj;
+
+		square_excise_object(cave, mimicked->iy, mimicked->ix, mimicked);
+		delist_object(cave, mon->mimicked_obj);
 		object_delete(&mon->mimicked_obj);
+	}
 
 	/* Drop objects being carried */
 	while (obj) {
@@ -1506,6 +1977,7 @@ bool mon_take_hit(struct monster *mon, int dam, bool *fear, const char *note)
 		if (rf_has(mon->race->flags, RF_UNIQUE)) {
 			char unique_name[80];
 			mon->race->max_num = 0;
+			mon_uniques_changed();
 
 			/* 
 			 * This gets the correct name if we slay an invisible 
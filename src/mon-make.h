@@ -25,8 +25,22 @@ void delete_monster_idx(int m_idx);
 void delete_monster(int y, int x);
 void compact_monsters(int num_to_compact);
 void wipe_mon_list(struct chunk *c, struct player *p);
+void mon_schedule_add(struct chunk *c, struct monster *mon);
+void mon_schedule_done(struct chunk *c, struct monster *mon);
+bool mon_is_handled(struct chunk *c, int m_idx);
+int mon_schedule_prev(struct chunk *c, int m_idx);
+void mon_schedule_reset(struct chunk *c);
+void mon_index_add(struct chunk *c, struct monster *mon);
+void mon_index_move(struct chunk *c, struct monster *mon, int y, int x);
+int mon_index_rect(struct chunk *c, int y1, int x1, int y2, int x2,
+				   s16b *found);
+int mon_index_radius(struct chunk *c, int y, int x, int r, s16b *found);
+int mon_index_next_light(struct chunk *c, int m_idx);
 s16b mon_pop(struct chunk *c);
+void mon_uniques_changed(void);
 void get_mon_num_prep(bool (*get_mon_num_hook)(struct monster_race *race));
+void get_mon_num_prep_cached(bool (*get_mon_num_hook)(struct monster_race *race),
+							 const void *key);
 struct monster_race *get_mon_num(int level);
 s16b place_monster(struct chunk *c, int y, int x, struct monster *mon,
 				   byte origin);
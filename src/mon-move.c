@@ -1147,8 +1147,8 @@ static bool process_monster_can_move(struct chunk *c, struct monster *mon,
 		if (square_isview(c, ny, nx))
 			player->upkeep->update |= (PU_UPDATE_VIEW | PU_MONSTERS);
 
-		/* Fully update the flow since terrain changed */
-		player->upkeep->update |= (PU_FORGET_FLOW | PU_UPDATE_FLOW);
+		/* Update the flow around the new opening */
+		player->upkeep->update |= (PU_UPDATE_FLOW);
 
 		return true;
 	}
@@ -1556,95 +1556,117 @@ static void regen_monster(struct monster *mon)
 
 
 /**
- * Process all the "live" monsters, once per game turn.
- *
- * During each game turn, we scan through the list of all the "live" monsters,
- * (backwards, so we can excise any "freshly dead" monsters), energizing each
- * monster, and allowing fully energized monsters to move, attack, pass, etc.
- *
- * This function and its children are responsible for a considerable fraction
- * of the processor time in normal situations, greater if the character is
- * resting.
+ * Give one monster its turn in the current game turn: regenerate it every
+ * so often, give it energy, and let it act if it had enough to move.  The
+ * caller has already checked it has at least the minimum energy.
  */
-void process_monsters(struct chunk *c, int minimum_energy)
+void process_monster_turn(struct chunk *c, struct monster *mon)
 {
-	int i;
 	int mspeed;
 
-	/* Only process some things every so often */
-	bool regen = false;
+	/* Does this monster have enough energy to move? */
+	bool moving = mon->energy >= z_info->move_energy ? true : false;
 
 	/* Regenerate hitpoints and mana every 100 game turns */
 	if (turn % 100 == 0)
-		regen = true;
+		regen_monster(mon);
 
-	/* Process the monsters (backwards) */
-	for (i = cave_monster_max(c) - 1; i >= 1; i--)
-	{
-		struct monster *mon;
-		bool moving;
-
-		/* Handle "leaving" */
-		if (player->is_dead || player->upkeep->generate_level) break;
+	/* Calculate the net speed */
+	mspeed = mon->mspeed;
+	if (mon->m_timed[MON_TMD_FAST])
+		mspeed += 10;
+	if (mon->m_timed[MON_TMD_SLOW])
+		mspeed -= 10;
 
-		/* Get a 'live' monster */
-		mon = cave_monster(c, i);
-		if (!mon->race) continue;
+	/* Give this monster some energy */
+	mon->energy += turn_energy(mspeed);
 
-		/* Ignore monsters that have already been handled */
-		if (mflag_has(mon->mflag, MFLAG_HANDLED))
-			continue;
+	/* Use up "some" energy */
+	if (moving)
+		mon->energy -= z_info->move_energy;
 
-		/* Not enough energy to move yet */
-		if (mon->energy < minimum_energy) continue;
+	/* Prevent reprocessing */
+	mon_schedule_done(c, mon);
 
-		/* Does this monster have enough energy to move? */
-		moving = mon->energy >= z_info->move_energy ? true : false;
+	/* End the turn of monsters without enough energy to move */
+	if (!moving)
+		return;
 
-		/* Prevent reprocessing */
-		mflag_on(mon->mflag, MFLAG_HANDLED);
+	/* Mimics lie in wait */
+	if (is_mimicking(mon)) return;
 
-		/* Handle monster regeneration if requested */
-		if (regen)
-			regen_monster(mon);
+	/* Check if the monster is active */
+	if (monster_check_active(c, mon)) {
+		/* Process timed effects - skip turn if necessary */
+		if (process_monster_timed(c, mon))
+			return;
 
-		/* Calculate the net speed */
-		mspeed = mon->mspeed;
-		if (mon->m_timed[MON_TMD_FAST])
-			mspeed += 10;
-		if (mon->m_timed[MON_TMD_SLOW])
-			mspeed -= 10;
+		/* Set this monster to be the current actor */
+		c->mon_current = mon->midx;
 
-		/* Give this monster some energy */
-		mon->energy += turn_energy(mspeed);
+		/* Process the monster */
+		process_monster(c, mon);
 
-		/* End the turn of monsters without enough energy to move */
-		if (!moving)
-			continue;
+		/* Monster is no longer current */
+		c->mon_current = -1;
+	}
+}
 
-		/* Use up "some" energy */
-		mon->energy -= z_info->move_energy;
+/**
+ * Process all the "live" monsters, once per game turn.
+ *
+ * During each game turn, we scan through the list of all the "live" monsters,
+ * (backwards, so we can excise any "freshly dead" monsters), energizing each
+ * monster, and allowing fully energized monsters to move, attack, pass, etc.
+ *
+ * Only monsters still waiting for their turn are visited, found from the
+ * cave's turn order bitmap; if none of them can have minimum_energy, as is
+ * usual before a player turn, the list is not looked at at all.
+ *
+ * This function and its children are responsible for a considerable fraction
+ * of the processor time in normal situations, greater if the character is
+ * resting.
+ */
+void process_monsters(struct chunk *c, int minimum_energy)
+{
+	int i;
+	byte old_energy, skipped_energy = 0;
 
-		/* Mimics lie in wait */
-		if (is_mimicking(mon)) continue;
+	/* Nobody has the energy to move before the player */
+	if (minimum_energy > c->mon_waiting_energy) {
+		player->upkeep->update |= PU_MONSTERS;
+		return;
+	}
 
-		/* Check if the monster is active */
-		if (monster_check_active(c, mon)) {
-			/* Process timed effects - skip turn if necessary */
-			if (process_monster_timed(c, mon))
-				continue;
+	/* Monsters placed from now on raise the bound again */
+	old_energy = c->mon_waiting_energy;
+	c->mon_waiting_energy = 0;
 
-			/* Set this monster to be the current actor */
-			c->mon_current = i;
+	/* Process the monsters (backwards) */
+	for (i = mon_schedule_prev(c, cave_monster_max(c)); i >= 1;
+		 i = mon_schedule_prev(c, i))
+	{
+		/* Get a 'live' monster which has not yet been handled */
+		struct monster *mon = cave_monster(c, i);
 
-			/* Process the monster */
-			process_monster(c, mon);
+		/* Handle "leaving" */
+		if (player->is_dead || player->upkeep->generate_level) {
+			skipped_energy = old_energy;
+			break;
+		}
 
-			/* Monster is no longer current */
-			c->mon_current = -1;
+		/* Not enough energy to move yet */
+		if (mon->energy < minimum_energy) {
+			skipped_energy = MAX(skipped_energy, mon->energy);
+			continue;
 		}
+
+		process_monster_turn(c, mon);
 	}
 
+	/* Those left waiting have no more energy than those we passed over */
+	c->mon_waiting_energy = MAX(c->mon_waiting_energy, skipped_energy);
+
 	/* Update monster visibility after this */
 	/* XXX This may not be necessary */
 	player->upkeep->update |= PU_MONSTERS;
@@ -1657,15 +1679,6 @@ void process_monsters(struct chunk *c, int minimum_energy)
  */
 void reset_monsters(void)
 {
-	int i;
-	struct monster *mon;
-
-	/* Process the monsters (backwards) */
-	for (i = cave_monster_max(cave) - 1; i >= 1; i--) {
-		/* Access the monster */
-		mon = cave_monster(cave, i);
-
-		/* Monster is ready to go again */
-		mflag_off(mon->mflag, MFLAG_HANDLED);
-	}
+	/* Monsters are ready to go again */
+	mon_schedule_reset(cave);
 }
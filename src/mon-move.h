@@ -20,6 +20,7 @@
 
 
 bool multiply_monster(const struct monster *m);
+void process_monster_turn(struct chunk *c, struct monster *mon);
 void process_monsters(struct chunk *c, int minimum_energy);
 void reset_monsters(void);
 
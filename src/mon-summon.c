@@ -253,8 +253,10 @@ int summon_specific(int y1, int x1, int lev, int type, bool delay, bool call)
 		return (call_monster(y, x));
 	}
 
-	/* Prepare allocation table */
-	get_mon_num_prep(summon_specific_okay);
+	/* Prepare allocation table; kin summons depend on the summoner's base */
+	get_mon_num_prep_cached(summon_specific_okay, type == S_KIN ?
+							(const void *)kin_base :
+							(const void *)&summon_info[type]);
 
 	/* Pick a monster, using the level calculation */
 	race = get_mon_num((player->depth + lev) / 2 + 5);
@@ -35,6 +35,62 @@
 #include "player-util.h"
 
 
+/**
+ * Index of monster names, built when the monster data is loaded
+ */
+static int *race_name_index;	/* ridx + 1 of each name, or 0 */
+static size_t race_name_size;
+
+/**
+ * Find the index slot holding the race with the given name, or the empty
+ * slot where it would go
+ */
+static size_t race_name_slot(const char *name)
+{
+	size_t mask = race_name_size - 1;
+	size_t i = djb2_hash(name) & mask;
+
+	while (race_name_index[i] &&
+		   !streq(r_info[race_name_index[i] - 1].name, name))
+		i = (i + 1) & mask;
+
+	return i;
+}
+
+/**
+ * Build the monster name index
+ */
+void monster_lookup_init(void)
+{
+	int i;
+
+	monster_lookup_free();
+
+	race_name_size = 16;
+	while (race_name_size < 2 * (size_t)z_info->r_max)
+		race_name_size *= 2;
+	race_name_index = mem_zalloc(race_name_size * sizeof(int));
+
+	for (i = 0; i < z_info->r_max; i++) {
+		size_t slot;
+
+		if (!r_info[i].name) continue;
+		slot = race_name_slot(r_info[i].name);
+		if (!race_name_index[slot])
+			race_name_index[slot] = i + 1;
+	}
+}
+
+/**
+ * Free the monster name index
+ */
+void monster_lookup_free(void)
+{
+	mem_free(race_name_index);
+	race_name_index = NULL;
+	race_name_size = 0;
+}
+
 /**
  * Returns the monster with the given name. If no monster has the exact name
  * given, returns the first monster with the given name as a (case-insensitive)
@@ -44,6 +100,12 @@ struct monster_race *lookup_monster(const char *name)
 {
 	int i;
 	struct monster_race *closest = NULL;
+
+	/* Test for equality */
+	if (race_name_index) {
+		i = race_name_index[race_name_slot(name)];
+		if (i) return &r_info[i - 1];
+	}
 	
 	/* Look for it */
 	for (i = 0; i < z_info->r_max; i++) {
@@ -52,7 +114,7 @@ struct monster_race *lookup_monster(const char *name)
 			continue;
 
 		/* Test for equality */
-		if (streq(name, race->name))
+		if (!race_name_index && streq(name, race->name))
 			return race;
 
 		/* Test for close matches */
@@ -479,8 +541,7 @@ void monster_swap(int y1, int x1, int y2, int x2)
 		mon = cave_monster(cave, m1);
 
 		/* Move monster */
-		mon->fy = y2;
-		mon->fx = x2;
+		mon_index_move(cave, mon, y2, x2);
 
 		/* Update monster */
 		update_mon(mon, cave, true);
@@ -517,8 +578,7 @@ void monster_swap(int y1, int x1, int y2, int x2)
 		mon = cave_monster(cave, m2);
 
 		/* Move monster */
-		mon->fy = y1;
-		mon->fx = x1;
+		mon_index_move(cave, mon, y1, x1);
 
 		/* Update monster */
 		update_mon(mon, cave, true);
@@ -22,6 +22,8 @@
 #include "monster.h"
 
 /** Functions **/
+void monster_lookup_init(void);
+void monster_lookup_free(void);
 struct monster_race *lookup_monster(const char *name);
 struct monster_base *lookup_monster_base(const char *name);
 bool monster_is_nonliving(struct monster_race *race);
@@ -875,6 +875,7 @@ void update_player_object_knowledge(struct player *p)
 	if (cave)
 		autoinscribe_ground();
 	autoinscribe_pack();
+	p->upkeep->update |= (PU_BONUS);
 	event_signal(EVENT_INVENTORY);
 	event_signal(EVENT_EQUIPMENT);
 }
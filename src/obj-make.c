@@ -32,13 +32,37 @@
 /** Arrays holding an index of objects to generate for a given level */
 static u32b *obj_total;
 static byte *obj_alloc;
+static u32b *obj_cumul;
 
 static u32b *obj_total_great;
 static byte *obj_alloc_great;
+static u32b *obj_cumul_great;
+
+/** Object kinds in tval order, with running totals within each tval */
+static s16b *obj_tval_kinds;
+static int obj_tval_first[TV_MAX + 1];
+static u32b *obj_tval_cumul;
+static u32b *obj_tval_cumul_great;
 
 static s16b alloc_ego_size = 0;
 static alloc_entry *alloc_ego_table;
 
+/** The ego item table entries which can apply to each object kind */
+static s16b *ego_kind_list;
+static int *ego_kind_first;
+static int ego_kind_size;
+
+/** Running totals, within each kind's entries, of the ego items which are in
+ * depth at each level; levels past ego_max_level have none */
+static u32b *ego_kind_cumul;
+static int ego_max_level;
+
+/** The entries of each kind which can be out of depth, deepest first, and
+ * room for those which pass their out of depth roll */
+static s16b *ego_ood_list;
+static int *ego_ood_first;
+static s16b *ego_ood_passed;
+
 struct money {
 	char *name;
 	int type;
@@ -47,6 +71,18 @@ struct money {
 static struct money *money_type;
 static int num_money_types;
 
+/**
+ * Check whether an ego item table entry can be picked at a level without
+ * rolling for being out of depth
+ */
+static bool ego_in_depth(const struct alloc_entry *entry, int level)
+{
+	const struct ego_item *ego = &e_info[entry->index];
+
+	return (level >= entry->level) && (level >= ego->alloc_min) &&
+		(level <= ego->alloc_max);
+}
+
 static void init_obj_make(void) {
 	int i, item, lev;
 	int k_max = z_info->k_max;
@@ -55,6 +91,9 @@ static void init_obj_make(void) {
 	s16b *num;
 	s16b *aux;
 	int *money_svals;
+	int tval, pos, n;
+	int *kind_pos, *kind_last;
+	struct ego_poss_item *poss;
 
 	/*** Initialize object allocation info ***/
 
@@ -90,6 +129,51 @@ static void init_obj_make(void) {
 		}
 	}
 
+	/* Running totals for picking an object by binary search */
+	obj_cumul = mem_zalloc((z_info->max_obj_depth + 1) * k_max * sizeof(u32b));
+	obj_cumul_great = mem_zalloc((z_info->max_obj_depth + 1) * k_max
+								 * sizeof(u32b));
+	for (lev = 0; lev <= z_info->max_obj_depth; lev++) {
+		u32b total = 0, total_great = 0;
+
+		for (item = 1; item < k_max; item++) {
+			total += obj_alloc[(lev * k_max) + item];
+			total_great += obj_alloc_great[(lev * k_max) + item];
+			obj_cumul[(lev * k_max) + item] = total;
+			obj_cumul_great[(lev * k_max) + item] = total_great;
+		}
+	}
+
+	/* Sort the object kinds by tval, keeping index order within each tval */
+	obj_tval_kinds = mem_zalloc(k_max * sizeof(s16b));
+	for (tval = 0, pos = 0; tval < TV_MAX; tval++) {
+		obj_tval_first[tval] = pos;
+		for (item = 1; item < k_max; item++)
+			if (k_info[item].tval == tval)
+				obj_tval_kinds[pos++] = item;
+	}
+	obj_tval_first[TV_MAX] = pos;
+
+	/* Running totals within each tval */
+	obj_tval_cumul = mem_zalloc((z_info->max_obj_depth + 1) * k_max
+								* sizeof(u32b));
+	obj_tval_cumul_great = mem_zalloc((z_info->max_obj_depth + 1) * k_max
+									  * sizeof(u32b));
+	for (lev = 0; lev <= z_info->max_obj_depth; lev++) {
+		for (tval = 0; tval < TV_MAX; tval++) {
+			u32b total = 0, total_great = 0;
+
+			for (pos = obj_tval_first[tval]; pos < obj_tval_first[tval + 1];
+				 pos++) {
+				item = obj_tval_kinds[pos];
+				total += obj_alloc[(lev * k_max) + item];
+				total_great += obj_alloc_great[(lev * k_max) + item];
+				obj_tval_cumul[(lev * k_max) + pos] = total;
+				obj_tval_cumul_great[(lev * k_max) + pos] = total_great;
+			}
+		}
+	}
+
 	/*** Initialize ego-item allocation info ***/
 
 	num = mem_zalloc((z_info->max_obj_depth + 1) * sizeof(s16b));
@@ -155,6 +239,89 @@ static void init_obj_make(void) {
 	mem_free(aux);
 	mem_free(num);
 
+	/* List the ego items which can apply to each kind, in table order.
+	 * Cursed ego items are not generated for now.  Each ego item's possible
+	 * kinds are walked once, and a kind listed twice is only counted once. */
+	ego_kind_first = mem_zalloc((k_max + 1) * sizeof(int));
+	kind_pos = mem_zalloc(k_max * sizeof(int));
+	kind_last = mem_zalloc(k_max * sizeof(int));
+	for (i = 0; i < alloc_ego_size; i++) {
+		ego = &e_info[alloc_ego_table[i].index];
+		if (cursed_p(ego->flags)) continue;
+		for (poss = ego->poss_items; poss; poss = poss->next) {
+			if (kind_last[poss->kidx] == i + 1) continue;
+			kind_last[poss->kidx] = i + 1;
+			ego_kind_first[poss->kidx + 1]++;
+		}
+	}
+	for (item = 0; item < k_max; item++) {
+		ego_kind_first[item + 1] += ego_kind_first[item];
+		kind_pos[item] = ego_kind_first[item];
+		kind_last[item] = 0;
+	}
+	n = ego_kind_first[k_max];
+	ego_kind_list = mem_zalloc((n + 1) * sizeof(s16b));
+	for (i = 0; i < alloc_ego_size; i++) {
+		ego = &e_info[alloc_ego_table[i].index];
+		if (cursed_p(ego->flags)) continue;
+		for (poss = ego->poss_items; poss; poss = poss->next) {
+			if (kind_last[poss->kidx] == i + 1) continue;
+			kind_last[poss->kidx] = i + 1;
+			ego_kind_list[kind_pos[poss->kidx]++] = i;
+		}
+	}
+	mem_free(kind_last);
+	mem_free(kind_pos);
+	ego_kind_size = n;
+
+	/* Total the in-depth ego items of each kind at each level */
+	for (ego_max_level = 0, i = 0; i < alloc_ego_size; i++) {
+		ego = &e_info[alloc_ego_table[i].index];
+		ego_max_level = MAX(ego_max_level, ego->alloc_max);
+	}
+	ego_kind_cumul = mem_zalloc((ego_max_level + 1) * (n + 1) * sizeof(u32b));
+	for (lev = 0; lev <= ego_max_level; lev++) {
+		u32b *cumul = &ego_kind_cumul[lev * (n + 1)];
+
+		for (item = 0; item < k_max; item++) {
+			u32b total = 0;
+
+			for (pos = ego_kind_first[item]; pos < ego_kind_first[item + 1];
+				 pos++) {
+				table = &alloc_ego_table[ego_kind_list[pos]];
+				if (ego_in_depth(table, lev))
+					total += table->prob2;
+				cumul[pos] = total;
+			}
+		}
+	}
+
+	/* List the entries of each kind which may roll for being out of depth,
+	 * keeping them in order of decreasing minimum depth */
+	ego_ood_first = mem_zalloc((k_max + 1) * sizeof(int));
+	ego_ood_list = mem_zalloc((n + 1) * sizeof(s16b));
+	ego_ood_passed = mem_zalloc((n + 1) * sizeof(s16b));
+	for (n = 0, item = 0; item < k_max; item++) {
+		ego_ood_first[item] = n;
+		for (pos = ego_kind_first[item]; pos < ego_kind_first[item + 1];
+			 pos++) {
+			int j = ego_kind_list[pos];
+
+			ego = &e_info[alloc_ego_table[j].index];
+			if (ego->alloc_min <= alloc_ego_table[j].level) continue;
+
+			/* Insert it after those with the same or a greater minimum */
+			for (i = n++; i > ego_ood_first[item]; i--) {
+				struct ego_item *prev =
+					&e_info[alloc_ego_table[ego_ood_list[i - 1]].index];
+				if (prev->alloc_min >= ego->alloc_min) break;
+				ego_ood_list[i] = ego_ood_list[i - 1];
+			}
+			ego_ood_list[i] = j;
+		}
+	}
+	ego_ood_first[k_max] = n;
+
 	/*** Initialize money info ***/
 
 	/* Count the money types and make a list */
@@ -178,7 +345,18 @@ static void cleanup_obj_make(void) {
 		string_free(money_type[i].name);
 	}
 	mem_free(money_type);
+	mem_free(ego_ood_passed);
+	mem_free(ego_ood_list);
+	mem_free(ego_ood_first);
+	mem_free(ego_kind_cumul);
+	mem_free(ego_kind_list);
+	mem_free(ego_kind_first);
 	mem_free(alloc_ego_table);
+	mem_free(obj_tval_cumul_great);
+	mem_free(obj_tval_cumul);
+	mem_free(obj_tval_kinds);
+	mem_free(obj_cumul_great);
+	mem_free(obj_cumul);
 	mem_free(obj_total_great);
 	mem_free(obj_total);
 	mem_free(obj_alloc_great);
@@ -272,63 +450,73 @@ static int random_high_resist(struct object *obj, int *resist)
 
 /**
  * Select an ego-item that fits the object's tval and sval.
+ *
+ * The ego items listed for the object's kind which are in depth are weighed
+ * up from the running totals made at startup.  Only those which are out of
+ * depth roll to be allowed, deepest first, so the random numbers drawn are
+ * not those of a walk over the whole ego item table, though the chance of
+ * each ego item being picked is the same.
  */
 static struct ego_item *ego_find_random(struct object *obj, int level)
 {
-	int i, ood_chance;
-	long total = 0L;
+	int kidx = obj->kind->kidx;
+	int first = ego_kind_first[kidx];
+	int last = ego_kind_first[kidx + 1];
+	int i, passed = 0;
+	u32b in_depth = 0, total;
+	const u32b *cumul;
 
 	alloc_entry *table = alloc_ego_table;
-	struct ego_item *ego;
-	struct ego_poss_item *poss;
 
-	/* Go through all possible ego items and find ones which fit this item */
-	for (i = 0; i < alloc_ego_size; i++) {
-		/* Reset any previous probability of this type being picked */
-		table[i].prob3 = 0;
-
-		if (level < table[i].level)
-			continue;
+	if (level < 0 || level > ego_max_level)
+		return NULL;
 
-		/* Access the ego item */
-		ego = &e_info[table[i].index];
-        
-        /* enforce maximum */
-        if (level > ego->alloc_max) continue;
-        
-        /* roll for Out of Depth (ood) */
-        if (level < ego->alloc_min){
-            ood_chance = MAX(2, (ego->alloc_min - level) / 3);
-            if (!one_in_(ood_chance)) continue;
-        }
+	/* The in-depth ego items for this kind */
+	cumul = &ego_kind_cumul[level * (ego_kind_size + 1)];
+	if (last > first)
+		in_depth = cumul[last - 1];
 
-		/* XXX Ignore cursed items for now */
-		if (cursed_p(ego->flags)) continue;
+	/* Roll for the out of depth ones, stopping at the first in depth */
+	for (i = ego_ood_first[kidx]; i < ego_ood_first[kidx + 1]; i++) {
+		int j = ego_ood_list[i];
+		struct ego_item *ego = &e_info[table[j].index];
 
-		for (poss = ego->poss_items; poss; poss = poss->next)
-			if (poss->kidx == obj->kind->kidx) {
-				table[i].prob3 = table[i].prob2;
-				break;
-			}
+		if (level >= ego->alloc_min) break;
+		if (level < table[j].level || level > ego->alloc_max) continue;
+		if (!one_in_(MAX(2, (ego->alloc_min - level) / 3))) continue;
 
-		/* Total */
-		total += table[i].prob3;
+		ego_ood_passed[passed++] = j;
 	}
 
-	if (total) {
-		long value = randint0(total);
-		for (i = 0; i < alloc_ego_size; i++) {
-			/* Found the entry */
-			if (value < table[i].prob3) break;
+	total = in_depth;
+	for (i = 0; i < passed; i++)
+		total += table[ego_ood_passed[i]].prob2;
+	if (!total)
+		return NULL;
 
-			/* Decrement */
-			value = value - table[i].prob3;
-		}
+	total = randint0(total);
+	if (total < in_depth) {
+		/* Find the first entry whose running total is past the value */
+		int low = first, high = last - 1;
+
+		while (low < high) {
+			int mid = (low + high) / 2;
 
-		return &e_info[table[i].index];
+			if (cumul[mid] > total)
+				high = mid;
+			else
+				low = mid + 1;
+		}
+		return &e_info[table[ego_kind_list[low]].index];
 	}
 
-	return NULL;
+	/* One of those which passed their out of depth roll */
+	total -= in_depth;
+	for (i = 0; i < passed - 1; i++) {
+		if (total < (u32b)table[ego_ood_passed[i]].prob2) break;
+		total -= table[ego_ood_passed[i]].prob2;
+	}
+	return &e_info[table[ego_ood_passed[i]].index];
 }
 
 
@@ -963,45 +1151,64 @@ bool kind_is_good(const struct object_kind *kind)
 }
 
 
+/**
+ * Find the first of the running totals cumul[first] to cumul[last - 1] which
+ * exceeds value, by binary search; returns last if there is none.
+ */
+static size_t obj_alloc_search(const u32b *cumul, size_t first, size_t last,
+							   u32b value)
+{
+	size_t low = first, high = last;
+
+	while (low < high) {
+		size_t mid = (low + high) / 2;
+
+		if (value < cumul[mid])
+			high = mid;
+		else
+			low = mid + 1;
+	}
+
+	return low;
+}
+
 /**
  * Choose an object kind of a given tval given a dungeon level.
  */
 static struct object_kind *get_obj_num_by_kind(int level, bool good, int tval)
 {
 	/* This is the base index into obj_alloc for this dlev */
-	size_t ind, item;
-	u32b value;
-	int total = 0;
-	byte *objects = good ? obj_alloc_great : obj_alloc;
+	size_t ind, first, last, pos;
+	u32b value, total;
+	u32b *cumul = good ? obj_tval_cumul_great : obj_tval_cumul;
 
-	/* Pick an object */
-	ind = level * z_info->k_max;
+	/* No items of that tval */
+	if ((tval < 0) || (tval >= TV_MAX)) return NULL;
+	first = obj_tval_first[tval];
+	last = obj_tval_first[tval + 1];
+	if (first == last) return NULL;
 
-	/* Get new total */
-	for (item = 1; item < z_info->k_max; item++)
-		if (objkind_byid(item)->tval == tval)
-			total += objects[ind + item];
+	/* Get the total */
+	ind = level * z_info->k_max;
+	total = cumul[ind + last - 1];
 
 	/* No appropriate items of that tval */
 	if (!total) return NULL;
 	
 	value = randint0(total);
-	
-	for (item = 1; item < z_info->k_max; item++)
-		if (objkind_byid(item)->tval == tval) {
-			if (value < objects[ind + item]) break;
-
-			value -= objects[ind + item];
-		}
+	pos = obj_alloc_search(cumul + ind, first, last, value);
 
 	/* Return the item index */
-	return objkind_byid(item);
+	return objkind_byid(obj_tval_kinds[pos]);
 }
 
 /**
  * Choose an object kind given a dungeon level to choose it for.
  * If tval = 0, we can choose an object of any type.
  * Otherwise we can only choose one of the given tval.
+ *
+ * Kinds are found by binary search of the running totals of their
+ * probabilities made at startup.
  */
 struct object_kind *get_obj_num(int level, bool good, int tval)
 {
@@ -1026,22 +1233,11 @@ struct object_kind *get_obj_num(int level, bool good, int tval)
 	
 	if (!good) {
 		value = randint0(obj_total[level]);
-		for (item = 1; item < z_info->k_max; item++) {
-			/* Found it */
-			if (value < obj_alloc[ind + item]) break;
-
-			/* Decrement */
-			value -= obj_alloc[ind + item];
-		}
+		item = obj_alloc_search(obj_cumul + ind, 1, z_info->k_max, value);
 	} else {
 		value = randint0(obj_total_great[level]);
-		for (item = 1; item < z_info->k_max; item++) {
-			/* Found it */
-			if (value < obj_alloc_great[ind + item]) break;
-
-			/* Decrement */
-			value -= obj_alloc_great[ind + item];
-		}
+		item = obj_alloc_search(obj_cumul_great + ind, 1, z_info->k_max,
+								value);
 	}
 
 	/* Return the item index */
@@ -226,34 +226,101 @@ void object_lists_check_integrity(void)
 	}
 }
 
+#define OBJ_FREE_BITS 64
+
+/**
+ * Note that an object list slot may now be free.  Slots past those the
+ * bitmap was built for are picked up when it is rebuilt.
+ */
+static void object_slot_note_free(struct chunk *c, int i)
+{
+	int word = i / OBJ_FREE_BITS;
+
+	if (!c || !c->obj_free || i >= c->obj_free_max) return;
+	c->obj_free[word] |= (u64b)1 << (i % OBJ_FREE_BITS);
+	if (word < c->obj_free_first)
+		c->obj_free_first = word;
+}
+
+/**
+ * Mark object list slots from first up to obj_max as possibly free, growing
+ * the bitmap to cover them
+ */
+static void object_slots_add(struct chunk *c, int first)
+{
+	int i, words = c->obj_max / OBJ_FREE_BITS + 1;
+	int old_words = c->obj_free ? c->obj_free_max / OBJ_FREE_BITS + 1 : 0;
+
+	if (first <= 1) old_words = 0;
+	c->obj_free = mem_realloc(c->obj_free, words * sizeof(u64b));
+	if (words > old_words)
+		memset(c->obj_free + old_words, 0,
+			   (words - old_words) * sizeof(u64b));
+	c->obj_free_max = c->obj_max;
+	for (i = first; i < c->obj_max; i++)
+		if (!c->objects[i])
+			object_slot_note_free(c, i);
+}
+
+/**
+ * Check whether an object list slot can take a new object; on the current
+ * level the slot must be empty in the known list as well
+ */
+static bool object_slot_is_free(struct chunk *c, int i)
+{
+	if (c->objects[i]) return false;
+	if ((c == cave) && cave_k->objects[i]) return false;
+	return true;
+}
+
 /**
  * Enter an object in the list of objects for the current level/chunk.  This
- * function is robust against listing of duplicates or non-objects
+ * function is robust against listing of duplicates or non-objects.
+ *
+ * Objects go in the lowest free slot, found from a bitmap of slots which may
+ * be free; the bitmap is rebuilt whenever the list has been resized by other
+ * code (level generation and loading fill in the list directly).
  */
 void list_object(struct chunk *c, struct object *obj)
 {
-	int i, newsize;
+	int i, word, words, old_max, newsize;
 
 	/* Check for duplicates and objects already deleted or combined */
 	if (!obj) return;
-	for (i = 1; i < c->obj_max; i++)
-		if (c->objects[i] == obj)
-			return;
+	if (obj->oidx && (obj->oidx < c->obj_max) && (c->objects[obj->oidx] == obj))
+		return;
+
+	/* Bring the free slot bitmap up to date */
+	if (c->obj_free_max != c->obj_max) {
+		c->obj_free_first = 0;
+		object_slots_add(c, 1);
+	}
 
 	/* Put objects in holes in the object list */
-	for (i = 1; i < c->obj_max; i++) {
-		/* If there is a known object, skip this slot */
-		if ((c == cave) && cave_k->objects[i]) continue;
-
-		/* Put the object in a hole */
-		if (c->objects[i] == NULL) {
-			c->objects[i] = obj;
-			obj->oidx = i;
-			return;
+	words = c->obj_max / OBJ_FREE_BITS + 1;
+	for (word = c->obj_free_first; word < words; word++) {
+		while (c->obj_free[word]) {
+			u64b bits = c->obj_free[word];
+
+			/* Take the lowest possibly free slot off the bitmap */
+			i = 0;
+			while (!(bits & ((u64b)1 << i))) i++;
+			c->obj_free[word] = bits & (bits - 1);
+			i += word * OBJ_FREE_BITS;
+
+			/* Put the object in a hole */
+			if (object_slot_is_free(c, i)) {
+				c->obj_free_first = word;
+				c->objects[i] = obj;
+				obj->oidx = i;
+				return;
+			}
 		}
 	}
+	c->obj_free_first = words;
 
 	/* Extend the list */
+	old_max = c->obj_max;
 	newsize = (c->obj_max + OBJECT_LIST_INCR + 1) * sizeof(struct object*);
 	c->objects = mem_realloc(c->objects, newsize);
 	c->objects[c->obj_max] = obj;
@@ -261,6 +328,7 @@ void list_object(struct chunk *c, struct object *obj)
 	for (i = c->obj_max + 1; i <= c->obj_max + OBJECT_LIST_INCR; i++)
 		c->objects[i] = NULL;
 	c->obj_max += OBJECT_LIST_INCR;
+	object_slots_add(c, old_max + 1);
 
 	/* If we're on the current level, extend the known list */
 	if (c == cave) {
@@ -284,6 +352,11 @@ void delist_object(struct chunk *c, struct object *obj)
 	if ((c == cave) && cave_k->objects[obj->oidx]) return;
 
 	c->objects[obj->oidx] = NULL;
+	object_slot_note_free(c, obj->oidx);
+
+	/* Freeing a known object's slot may free the real object's slot */
+	if (c == cave_k)
+		object_slot_note_free(cave, obj->oidx);
 	obj->oidx = 0;
 }
 
@@ -334,12 +407,17 @@ void object_delete(struct object **obj_address)
 
 	/* Remove from any lists */
 	if (cave_k && cave_k->objects && obj->oidx
-		&& (obj == cave_k->objects[obj->oidx]))
+		&& (obj == cave_k->objects[obj->oidx])) {
 		cave_k->objects[obj->oidx] = NULL;
+		object_slot_note_free(cave_k, obj->oidx);
+		object_slot_note_free(cave, obj->oidx);
+	}
 
 	if (cave && cave->objects && obj->oidx
-		&& (obj == cave->objects[obj->oidx]))
+		&& (obj == cave->objects[obj->oidx])) {
 		cave->objects[obj->oidx] = NULL;
+		object_slot_note_free(cave, obj->oidx);
+	}
 
 	mem_free(obj);
 	*obj_address = NULL;
@@ -393,6 +471,9 @@ bool object_stackable(const struct object *obj1, const struct object *obj2,
 	/* Hack -- identical items cannot be stacked */
 	if (obj1 == obj2) return false;
 
+	/* A mimic's object has to stay the one object it points to */
+	if (obj1->mimicking_m_idx || obj2->mimicking_m_idx) return false;
+
 	/* Require identical object kinds */
 	if (obj1->kind != obj2->kind) return false;
 
@@ -961,6 +1042,13 @@ static void drop_find_grid(struct object *drop, int *y, int *x)
 			best_y = randint0(cave->height);
 			best_x = randint0(cave->width);
 		}
+
+		/* Bouncing can take us off the level */
+		if (!square_in_bounds_fully(cave, best_y, best_x)) {
+			best_y = *y;
+			best_x = *x;
+			continue;
+		}
 		if (square_canputitem(cave, best_y, best_x)) {
 			*y = best_y;
 			*x = best_x;
@@ -987,6 +1075,7 @@ void drop_near(struct chunk *c, struct object *dropped, int chance, int y,
 	char o_name[80];
 	int best_y = y;
 	int best_x = x;
+	bool shown;
 
 	/* Only called in the current level */
 	assert(c == cave);
@@ -1000,14 +1089,13 @@ void drop_near(struct chunk *c, struct object *dropped, int chance, int y,
 		return;
 	}
 
-	/* Find the best grid and drop the item, destroying if there's no space */
+	/* Find the best grid and drop the item, destroying if there's no space;
+	 * the object may be absorbed into a pile, so look at it beforehand */
 	drop_find_grid(dropped, &best_y, &best_x);
+	shown = verbose && !ignore_item_ok(dropped);
 	if (floor_carry(c, best_y, best_x, dropped, false)) {
 		sound(MSG_DROP);
-		if (verbose &&
-			(c->squares[best_y][best_x].mon < 0) &&
-			c->objects[dropped->oidx] &&
-			!ignore_item_ok(dropped))
+		if (shown && (c->squares[best_y][best_x].mon < 0))
 			msg("You feel something roll beneath your feet.");
 	} else {
 		floor_carry_fail(dropped, false);
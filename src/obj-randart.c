@@ -2867,6 +2867,7 @@ static errr do_randart_aux(bool full)
 
 	/* Generate random names */
 	if ((result = init_names()) != 0) return (result);
+	artifact_lookup_init();
 
 	/* Randomize the artifacts */
 	if (full)
@@ -2886,10 +2887,11 @@ static errr do_randart_aux(bool full)
 errr do_randart(u32b randart_seed, bool full)
 {
 	errr err;
+	struct rng_state randart_rng, *old_rng;
 
 	/* Prepare to use the Angband "simple" RNG. */
-	Rand_value = randart_seed;
-	Rand_quick = true;
+	rng_state_init_quick(&randart_rng, randart_seed);
+	old_rng = Rand_set_context(&randart_rng);
 
 	/* Only do all the following if full randomization requested */
 	if (full) {
@@ -2948,7 +2950,7 @@ errr do_randart(u32b randart_seed, bool full)
 	}
 
 	/* When done, resume use of the Angband "complex" RNG. */
-	Rand_quick = false;
+	Rand_set_context(old_rng);
 
 	return (err);
 }
@@ -152,12 +152,11 @@ void flavor_reset_fixed(void)
 void flavor_init(void)
 {
 	int i, j;
+	struct rng_state flavor_rng, *old_rng;
 
-	/* Hack -- Use the "simple" RNG */
-	Rand_quick = true;
-
-	/* Hack -- Induce consistant flavors */
-	Rand_value = seed_flavor;
+	/* Hack -- Induce consistant flavors with the "simple" RNG */
+	rng_state_init_quick(&flavor_rng, seed_flavor);
+	old_rng = Rand_set_context(&flavor_rng);
 
 	if (OPT(birth_randarts))
 		flavor_reset_fixed();
@@ -209,7 +208,7 @@ void flavor_init(void)
 	flavor_assign_random(TV_SCROLL);
 
 	/* Hack -- Use the "complex" RNG */
-	Rand_quick = false;
+	Rand_set_context(old_rng);
 
 	/* Analyze every object */
 	for (i = 1; i < z_info->k_max; i++) {
@@ -321,6 +320,132 @@ unsigned check_for_inscrip(const struct object *obj, const char *inscrip)
 
 /*** Object kind lookup functions ***/
 
+/**
+ * Indices for the lookup functions, built when the object and artifact data
+ * are loaded.  Each lookup falls back to scanning the data if its index
+ * hasn't been built, as when parsing the data files themselves.
+ */
+static struct object_kind **kind_by_tval_sval;	/* [tval][sval], flattened */
+static int kind_sval_max;
+
+static char **kind_sval_names;		/* Lowercased formatted names by kidx */
+static int kind_lookup_max;			/* k_max when the indices were built */
+static int *kind_name_index;		/* kidx + 1 of each name, or 0 */
+static size_t kind_name_size;
+
+static int *artifact_name_index;	/* aidx of each name, or 0 */
+static size_t artifact_name_size;
+
+/**
+ * Copy a name in lower case, for case-insensitive comparison
+ */
+static void lookup_lower(char *buf, size_t max, const char *name)
+{
+	size_t i;
+
+	for (i = 0; name[i] && i < max - 1; i++)
+		buf[i] = tolower((unsigned char)name[i]);
+	buf[i] = '\0';
+}
+
+/**
+ * Size for an open-addressed index of n entries, kept at most half full
+ */
+static size_t lookup_index_size(int n)
+{
+	size_t size = 16;
+
+	while (size < 2 * (size_t)n) size *= 2;
+	return size;
+}
+
+/**
+ * Find the index slot holding the kind with the given tval and lowercased
+ * name, or the empty slot where it would go
+ */
+static size_t kind_name_slot(int tval, const char *name)
+{
+	size_t mask = kind_name_size - 1;
+	size_t i = (djb2_hash(name) + tval) & mask;
+
+	while (kind_name_index[i]) {
+		int k = kind_name_index[i] - 1;
+		if (k_info[k].tval == tval && streq(kind_sval_names[k], name))
+			break;
+		i = (i + 1) & mask;
+	}
+
+	return i;
+}
+
+/**
+ * Build the kind indices by tval and sval and by tval and name
+ */
+void kind_lookup_init(void)
+{
+	int k;
+
+	kind_lookup_free();
+
+	kind_sval_max = 0;
+	for (k = 0; k < z_info->k_max; k++)
+		kind_sval_max = MAX(kind_sval_max, k_info[k].sval);
+
+	kind_by_tval_sval = mem_zalloc(TV_MAX * (kind_sval_max + 1)
+								   * sizeof(struct object_kind *));
+	kind_lookup_max = z_info->k_max;
+	kind_sval_names = mem_zalloc(z_info->k_max * sizeof(char *));
+	kind_name_size = lookup_index_size(z_info->k_max);
+	kind_name_index = mem_zalloc(kind_name_size * sizeof(int));
+
+	for (k = 0; k < z_info->k_max; k++) {
+		struct object_kind *kind = &k_info[k];
+		struct object_kind **slot;
+		char cmp_name[1024], lower[1024];
+		size_t i;
+
+		/* The first kind with a given tval and sval wins */
+		if (kind->tval >= 0 && kind->tval < TV_MAX && kind->sval >= 0) {
+			slot = &kind_by_tval_sval[kind->tval * (kind_sval_max + 1)
+									  + kind->sval];
+			if (!*slot) *slot = kind;
+		}
+
+		if (!kind->name) continue;
+
+		obj_desc_name_format(cmp_name, sizeof cmp_name, 0, kind->name, 0,
+							 false);
+		lookup_lower(lower, sizeof(lower), cmp_name);
+		kind_sval_names[k] = string_make(lower);
+
+		/* Likewise the first with a given tval and name */
+		i = kind_name_slot(kind->tval, lower);
+		if (!kind_name_index[i])
+			kind_name_index[i] = k + 1;
+	}
+}
+
+/**
+ * Free the kind indices
+ */
+void kind_lookup_free(void)
+{
+	int k;
+
+	if (kind_sval_names)
+		for (k = 0; k < kind_lookup_max; k++)
+			string_free(kind_sval_names[k]);
+	mem_free(kind_sval_names);
+	kind_sval_names = NULL;
+	mem_free(kind_name_index);
+	kind_name_index = NULL;
+	kind_name_size = 0;
+	mem_free(kind_by_tval_sval);
+	kind_by_tval_sval = NULL;
+	kind_sval_max = 0;
+	kind_lookup_max = 0;
+}
+
 /**
  * Return the object kind with the given `tval` and `sval`, or NULL.
  */
@@ -329,10 +454,16 @@ struct object_kind *lookup_kind(int tval, int sval)
 	int k;
 
 	/* Look for it */
-	for (k = 0; k < z_info->k_max; k++) {
-		struct object_kind *kind = &k_info[k];
-		if (kind->tval == tval && kind->sval == sval)
-			return kind;
+	if (kind_by_tval_sval) {
+		if (tval >= 0 && tval < TV_MAX && sval >= 0 && sval <= kind_sval_max
+			&& kind_by_tval_sval[tval * (kind_sval_max + 1) + sval])
+			return kind_by_tval_sval[tval * (kind_sval_max + 1) + sval];
+	} else {
+		for (k = 0; k < z_info->k_max; k++) {
+			struct object_kind *kind = &k_info[k];
+			if (kind->tval == tval && kind->sval == sval)
+				return kind;
+		}
 	}
 
 	/* Failure */
@@ -349,6 +480,54 @@ struct object_kind *objkind_byid(int kidx) {
 
 /*** Textual<->numeric conversion ***/
 
+/**
+ * Find the index slot holding the artifact with the given name, or the empty
+ * slot where it would go
+ */
+static size_t artifact_name_slot(const char *name)
+{
+	size_t mask = artifact_name_size - 1;
+	size_t i = djb2_hash(name) & mask;
+
+	while (artifact_name_index[i] &&
+		   !streq(a_info[artifact_name_index[i]].name, name))
+		i = (i + 1) & mask;
+
+	return i;
+}
+
+/**
+ * Build the artifact name index; artifact names change with randarts, so
+ * this is called again whenever they do
+ */
+void artifact_lookup_init(void)
+{
+	int i;
+
+	artifact_lookup_free();
+
+	artifact_name_size = lookup_index_size(z_info->a_max);
+	artifact_name_index = mem_zalloc(artifact_name_size * sizeof(int));
+	for (i = 1; i < z_info->a_max; i++) {
+		size_t slot;
+
+		if (!a_info[i].name) continue;
+		slot = artifact_name_slot(a_info[i].name);
+		if (!artifact_name_index[slot])
+			artifact_name_index[slot] = i;
+	}
+}
+
+/**
+ * Free the artifact name index
+ */
+void artifact_lookup_free(void)
+{
+	mem_free(artifact_name_index);
+	artifact_name_index = NULL;
+	artifact_name_size = 0;
+}
+
 /**
  * Return the a_idx of the artifact with the given name
  */
@@ -357,12 +536,18 @@ int lookup_artifact_name(const char *name)
 	int i;
 	int a_idx = -1;
 
+	/* Test for equality */
+	if (artifact_name_index) {
+		i = artifact_name_index[artifact_name_slot(name)];
+		if (i) return i;
+	}
+
 	/* Look for it */
 	for (i = 1; i < z_info->a_max; i++) {
 		struct artifact *art = &a_info[i];
 
 		/* Test for equality */
-		if (art->name && streq(name, art->name))
+		if (!artifact_name_index && art->name && streq(name, art->name))
 			return i;
 		
 		/* Test for close matches */
@@ -389,6 +574,14 @@ int lookup_sval(int tval, const char *name)
 		return r;
 
 	/* Look for it */
+	if (kind_name_index) {
+		char lower[1024];
+
+		lookup_lower(lower, sizeof(lower), name);
+		k = kind_name_index[kind_name_slot(tval, lower)];
+		return k ? k_info[k - 1].sval : -1;
+	}
+
 	for (k = 0; k < z_info->k_max; k++) {
 		struct object_kind *kind = &k_info[k];
 		char cmp_name[1024];
@@ -32,8 +32,12 @@ bool object_test(item_tester tester, const struct object *o);
 bool item_test(item_tester tester, int item);
 bool is_unknown(const struct object *obj);
 unsigned check_for_inscrip(const struct object *obj, const char *inscrip);
+void kind_lookup_init(void);
+void kind_lookup_free(void);
 struct object_kind *lookup_kind(int tval, int sval);
 struct object_kind *objkind_byid(int kidx);
+void artifact_lookup_init(void);
+void artifact_lookup_free(void);
 int lookup_artifact_name(const char *name);
 int lookup_sval(int tval, const char *name);
 void object_short_name(char *buf, size_t max, const char *name);
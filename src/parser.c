@@ -16,6 +16,7 @@
  *    are included in all such copies.  Other copyrights may also apply.
  */
 
+#include "buildid.h"
 #include "init.h"
 #include "game-event.h"
 #include "message.h"
@@ -59,7 +60,7 @@ struct parser_spec {
 };
 
 struct parser_value {
-	struct parser_spec spec;
+	const struct parser_spec *spec;
 	union {
 		wchar_t cval;
 		int ival;
@@ -75,16 +76,29 @@ struct parser_hook {
 	char *dir;
 	struct parser_spec *fhead;
 	struct parser_spec *ftail;
+	int nspecs;
 };
 
+/**
+ * The current line is copied into a buffer owned by the parser and split in
+ * place, so sym and str values point into it and are only good until the next
+ * line is parsed; the values themselves live in an array big enough for the
+ * hook with the most fields.
+ */
 struct parser {
 	enum parser_error error;
 	unsigned int lineno;
 	unsigned int colno;
 	char errmsg[1024];
 	struct parser_hook *hooks;
-	struct parser_value *fhead;
-	struct parser_value *ftail;
+	struct parser_hook **hook_index;	/* Open-addressed, by directive */
+	size_t hook_index_size;
+	size_t hook_count;
+	char *line;
+	size_t line_size;
+	struct parser_value *vals;
+	int nvals;
+	int max_vals;
 	void *priv;
 };
 
@@ -96,26 +110,92 @@ struct parser *parser_new(void) {
 	return p;
 }
 
+/**
+ * Find the hook index slot holding the given directive, or the empty slot
+ * where it would go.
+ */
+static size_t hook_slot(struct parser *p, const char *dir) {
+	size_t mask = p->hook_index_size - 1;
+	size_t i = djb2_hash(dir) & mask;
+
+	while (p->hook_index[i] && strcmp(p->hook_index[i]->dir, dir))
+		i = (i + 1) & mask;
+
+	return i;
+}
+
 static struct parser_hook *findhook(struct parser *p, const char *dir) {
-	struct parser_hook *h = p->hooks;
-	while (h) {
-		if (!strcmp(h->dir, dir))
-			break;
-		h = h->next;
+	if (!p->hook_index_size)
+		return NULL;
+	return p->hook_index[hook_slot(p, dir)];
+}
+
+/**
+ * Enter a hook in the index, superseding any hook with the same directive.
+ */
+static void index_hook(struct parser *p, struct parser_hook *h) {
+	size_t slot;
+
+	/* Keep the index at most half full */
+	if (2 * (p->hook_count + 1) > p->hook_index_size) {
+		struct parser_hook **old = p->hook_index;
+		size_t i, old_size = p->hook_index_size;
+
+		p->hook_index_size = old_size ? 2 * old_size : 32;
+		p->hook_index = mem_zalloc(p->hook_index_size * sizeof(*old));
+		for (i = 0; i < old_size; i++)
+			if (old[i])
+				p->hook_index[hook_slot(p, old[i]->dir)] = old[i];
+		mem_free(old);
 	}
-	return h;
+
+	slot = hook_slot(p, h->dir);
+	if (!p->hook_index[slot])
+		p->hook_count++;
+	p->hook_index[slot] = h;
 }
 
 static void parser_freeold(struct parser *p) {
-	struct parser_value *v;
-	while (p->fhead) {
-		int t = p->fhead->spec.type & ~PARSE_T_OPT;
-		v = (struct parser_value *)p->fhead->spec.next;
-		if (t == PARSE_T_SYM || t == PARSE_T_STR)
-			mem_free(p->fhead->u.sval);
-		mem_free(p->fhead);
-		p->fhead = v;
+	p->nvals = 0;
+}
+
+/**
+ * Split the next field off the string at *pos, as strtok() would: leading
+ * delimiters are skipped, the field is terminated in place and *pos is left
+ * after it.  Returns NULL if nothing is left.
+ */
+static char *split_field(char **pos, char delim) {
+	char *s = *pos;
+	char *e;
+
+	while (*s == delim)
+		s++;
+	if (!*s) {
+		*pos = s;
+		return NULL;
+	}
+
+	e = strchr(s, delim);
+	if (e) {
+		*e = '\0';
+		*pos = e + 1;
+	} else {
+		*pos = s + strlen(s);
 	}
+	return s;
+}
+
+/**
+ * Take the rest of the string at *pos as one field.  Returns NULL if nothing
+ * is left.
+ */
+static char *split_rest(char **pos) {
+	char *s = *pos;
+
+	if (!*s)
+		return NULL;
+	*pos = s + strlen(s);
+	return s;
 }
 
 static bool parse_random(const char *str, random_value *bonus) {
@@ -209,12 +289,12 @@ static bool parse_random(const char *str, random_value *bonus) {
  * This runs the first parser hook registered with `p` that matches `line`.
  */
 enum parser_error parser_parse(struct parser *p, const char *line) {
-	char *cline;
+	char *pos;
 	char *tok;
 	struct parser_hook *h;
 	struct parser_spec *s;
 	struct parser_value *v;
-	char *sp = NULL;
+	size_t len;
 
 	assert(p);
 	assert(line);
@@ -223,8 +303,6 @@ enum parser_error parser_parse(struct parser *p, const char *line) {
 
 	p->lineno++;
 	p->colno = 1;
-	p->fhead = NULL;
-	p->ftail = NULL;
 
 	/* Ignore empty lines and comments. */
 	while (*line && (isspace(*line)))
@@ -232,11 +310,17 @@ enum parser_error parser_parse(struct parser *p, const char *line) {
 	if (!*line || *line == '#')
 		return PARSE_ERROR_NONE;
 
-	cline = string_make(line);
+	/* Take a copy of the line to split up */
+	len = strlen(line) + 1;
+	if (len > p->line_size) {
+		p->line_size = MAX(len, 2 * p->line_size);
+		p->line = mem_realloc(p->line, p->line_size);
+	}
+	memcpy(p->line, line, len);
+	pos = p->line;
 
-	tok = strtok(cline, ":");
+	tok = split_field(&pos, ':');
 	if (!tok) {
-		mem_free(cline);
 		p->error = PARSE_ERROR_MISSING_FIELD;
 		return PARSE_ERROR_MISSING_FIELD;
 	}
@@ -245,7 +329,6 @@ enum parser_error parser_parse(struct parser *p, const char *line) {
 	if (!h) {
 		my_strcpy(p->errmsg, tok, sizeof(p->errmsg));
 		p->error = PARSE_ERROR_UNDEFINED_DIRECTIVE;
-		mem_free(cline);
 		return PARSE_ERROR_UNDEFINED_DIRECTIVE;
 	}
 
@@ -261,39 +344,32 @@ enum parser_error parser_parse(struct parser *p, const char *line) {
 		 * at all (i.e., they consume the remainder of the line) */
 		if (t == PARSE_T_INT || t == PARSE_T_SYM || t == PARSE_T_RAND ||
 			t == PARSE_T_UINT) {
-			tok = strtok(sp, ":");
-			sp = NULL;
+			tok = split_field(&pos, ':');
 		} else if (t == PARSE_T_CHAR) {
-			tok = strtok(sp, "");
+			tok = split_rest(&pos);
 			if (tok)
-				sp = tok + 2;
+				pos = tok[1] ? tok + 2 : tok + 1;
 		} else {
-			tok = strtok(sp, "");
-			sp = NULL;
+			tok = split_rest(&pos);
 		}
 		if (!tok) {
 			if (!(s->type & PARSE_T_OPT)) {
 				my_strcpy(p->errmsg, s->name, sizeof(p->errmsg));
 				p->error = PARSE_ERROR_MISSING_FIELD;
-				mem_free(cline);
 				return PARSE_ERROR_MISSING_FIELD;
 			}
 			break;
 		}
 
-		/* Allocate a value node. */
-		v = mem_alloc(sizeof *v);
-		v->spec.next = NULL;
-		v->spec.type = s->type;
-		v->spec.name = s->name;
+		/* Take the next value slot. */
+		v = &p->vals[p->nvals];
+		v->spec = s;
 
 		/* Parse out its value. */
 		if (t == PARSE_T_INT) {
 			char *z = NULL;
 			v->u.ival = strtol(tok, &z, 0);
 			if (z == tok) {
-				mem_free(v);
-				mem_free(cline);
 				my_strcpy(p->errmsg, s->name, sizeof(p->errmsg));
 				p->error = PARSE_ERROR_NOT_NUMBER;
 				return PARSE_ERROR_NOT_NUMBER;
@@ -302,8 +378,6 @@ enum parser_error parser_parse(struct parser *p, const char *line) {
 			char *z = NULL;
 			v->u.uval = strtoul(tok, &z, 0);
 			if (z == tok || *tok == '-') {
-				mem_free(v);
-				mem_free(cline);
 				my_strcpy(p->errmsg, s->name, sizeof(p->errmsg));
 				p->error = PARSE_ERROR_NOT_NUMBER;
 				return PARSE_ERROR_NOT_NUMBER;
@@ -311,27 +385,18 @@ enum parser_error parser_parse(struct parser *p, const char *line) {
 		} else if (t == PARSE_T_CHAR) {
 			text_mbstowcs(&v->u.cval, tok, 1);
 		} else if (t == PARSE_T_SYM || t == PARSE_T_STR) {
-			v->u.sval = string_make(tok);
+			v->u.sval = tok;
 		} else if (t == PARSE_T_RAND) {
 			if (!parse_random(tok, &v->u.rval)) {
-				mem_free(v);
-				mem_free(cline);
 				my_strcpy(p->errmsg, s->name, sizeof(p->errmsg));
 				p->error = PARSE_ERROR_NOT_RANDOM;
 				return PARSE_ERROR_NOT_RANDOM;
 			}
 		}
 
-		/* Link it into the value list. */
-		if (!p->fhead)
-			p->fhead = v;
-		else
-			p->ftail->spec.next = &v->spec;
-		p->ftail = v;
+		p->nvals++;
 	}
 
-	mem_free(cline);
-
 	p->error = h->func(p);
 	return p->error;
 }
@@ -396,6 +461,9 @@ void parser_destroy(struct parser *p) {
 		mem_free(p->hooks);
 		p->hooks = h;
 	}
+	mem_free(p->hook_index);
+	mem_free(p->line);
+	mem_free(p->vals);
 	mem_free(p);
 }
 
@@ -408,20 +476,21 @@ static errr parse_specs(struct parser_hook *h, char *fmt) {
 	assert(h);
 	assert(fmt);
 
-	name = strtok(fmt, " ");
+	name = split_field(&fmt, ' ');
 	if (!name)
 		return -EINVAL;
 	h->dir = string_make(name);
 	h->fhead = NULL;
 	h->ftail = NULL;
+	h->nspecs = 0;
 	while (name) {
 		/* Lack of a type is legal; that means we're at the end of the line. */
-		stype = strtok(NULL, " ");
+		stype = split_field(&fmt, ' ');
 		if (!stype)
 			break;
 
 		/* Lack of a name, on the other hand... */
-		name = strtok(NULL, " ");
+		name = split_field(&fmt, ' ');
 		if (!name) {
 			clean_specs(h);
 			return -EINVAL;
@@ -454,6 +523,7 @@ static errr parse_specs(struct parser_hook *h, char *fmt) {
 		else
 			h->fhead = s;
 		h->ftail = s;
+		h->nspecs++;
 	}
 
 	return 0;
@@ -494,7 +564,14 @@ errr parser_reg(struct parser *p, const char *fmt,
 	}
 
 	p->hooks = h;
+	index_hook(p, h);
 	mem_free(cfmt);
+
+	/* Make room for this hook's values */
+	if (h->nspecs > p->max_vals) {
+		p->max_vals = h->nspecs;
+		p->vals = mem_realloc(p->vals, p->max_vals * sizeof(*p->vals));
+	}
 	return 0;
 }
 
@@ -511,19 +588,19 @@ enum parser_error ignored(struct parser *p) {
  * Used to test for presence of optional values.
  */
 bool parser_hasval(struct parser *p, const char *name) {
-	struct parser_value *v;
-	for (v = p->fhead; v; v = (struct parser_value *)v->spec.next) {
-		if (!strcmp(v->spec.name, name))
+	int i;
+	for (i = 0; i < p->nvals; i++) {
+		if (!strcmp(p->vals[i].spec->name, name))
 			return true;
 	}
 	return false;
 }
 
 static struct parser_value *parser_getval(struct parser *p, const char *name) {
-	struct parser_value *v;
-	for (v = p->fhead; v; v = (struct parser_value *)v->spec.next) {
-		if (!strcmp(v->spec.name, name)) {
-			return v;
+	int i;
+	for (i = 0; i < p->nvals; i++) {
+		if (!strcmp(p->vals[i].spec->name, name)) {
+			return &p->vals[i];
 		}
 	}
 	quit_fmt("parser_getval error: name is %s\n", name);
@@ -535,7 +612,7 @@ static struct parser_value *parser_getval(struct parser *p, const char *name) {
  */
 const char *parser_getsym(struct parser *p, const char *name) {
 	struct parser_value *v = parser_getval(p, name);
-	assert((v->spec.type & ~PARSE_T_OPT) == PARSE_T_SYM);
+	assert((v->spec->type & ~PARSE_T_OPT) == PARSE_T_SYM);
 	return v->u.sval;
 }
 
@@ -544,7 +621,7 @@ const char *parser_getsym(struct parser *p, const char *name) {
  */
 int parser_getint(struct parser *p, const char *name) {
 	struct parser_value *v = parser_getval(p, name);
-	assert((v->spec.type & ~PARSE_T_OPT) == PARSE_T_INT);
+	assert((v->spec->type & ~PARSE_T_OPT) == PARSE_T_INT);
 	return v->u.ival;
 }
 
@@ -553,7 +630,7 @@ int parser_getint(struct parser *p, const char *name) {
  */
 unsigned int parser_getuint(struct parser *p, const char *name) {
 	struct parser_value *v = parser_getval(p, name);
-	assert((v->spec.type & ~PARSE_T_OPT) == PARSE_T_UINT);
+	assert((v->spec->type & ~PARSE_T_OPT) == PARSE_T_UINT);
 	return v->u.uval;
 }
 
@@ -562,7 +639,7 @@ unsigned int parser_getuint(struct parser *p, const char *name) {
  */
 const char *parser_getstr(struct parser *p, const char *name) {
 	struct parser_value *v = parser_getval(p, name);
-	assert((v->spec.type & ~PARSE_T_OPT) == PARSE_T_STR);
+	assert((v->spec->type & ~PARSE_T_OPT) == PARSE_T_STR);
 	return v->u.sval;
 }
 
@@ -571,7 +648,7 @@ const char *parser_getstr(struct parser *p, const char *name) {
  */
 struct random parser_getrand(struct parser *p, const char *name) {
 	struct parser_value *v = parser_getval(p, name);
-	assert((v->spec.type & ~PARSE_T_OPT) == PARSE_T_RAND);
+	assert((v->spec->type & ~PARSE_T_OPT) == PARSE_T_RAND);
 	return v->u.rval;
 }
 
@@ -580,7 +657,7 @@ struct random parser_getrand(struct parser *p, const char *name) {
  */
 wchar_t parser_getchar(struct parser *p, const char *name) {
 	struct parser_value *v = parser_getval(p, name);
-	assert((v->spec.type & ~PARSE_T_OPT) == PARSE_T_CHAR);
+	assert((v->spec->type & ~PARSE_T_OPT) == PARSE_T_CHAR);
 	return v->u.cval;
 }
 
@@ -690,6 +767,382 @@ void cleanup_parser(struct file_parser *fp)
 	fp->cleanup();
 }
 
+/**
+ * ------------------------------------------------------------------------
+ * Binary caches of parsed game data
+ *
+ * A cache is stored in the user directory and records a hash of each of the
+ * text files it was built from, so that it is ignored (and rebuilt by the
+ * caller) as soon as any of them changes.  The layout is:
+ *   magic, format version, build id, source hash, payload length, payload,
+ *   payload checksum
+ * with all numbers as little-endian u32b and strings as a u32b length
+ * followed by the bytes.
+ * ------------------------------------------------------------------------ */
+
+#define PARSE_CACHE_MAGIC	0x43474e41	/* "ANGC" */
+
+/**
+ * The payload format is not part of the key: the build id only changes
+ * between releases.  Bump this whenever a payload changes shape, either
+ * because one of the cache writers (room_cache_write() and vault_cache_write()
+ * in generate.c, the object, ego, artifact and activation writers in init.c,
+ * monster_cache_write() in mon-init.c) changes, or because a field is added
+ * to the structs they store.
+ */
+#define PARSE_CACHE_VERSION	2
+
+struct parse_cache {
+	char path[1024];
+	u32b source_hash;
+	byte *buf;
+	size_t len;
+	size_t size;
+	size_t pos;
+	bool loaded;
+	bool ok;
+};
+
+/**
+ * Read a little-endian u32b from a buffer
+ */
+static u32b parse_cache_u32b(const byte *b) {
+	return (u32b)b[0] | ((u32b)b[1] << 8) | ((u32b)b[2] << 16) |
+		((u32b)b[3] << 24);
+}
+
+/**
+ * Hash the text files a cache is built from, in the order given.  This runs
+ * over every source on every start, so it takes a word at a time.
+ */
+static u32b parse_cache_hash_sources(const char **sources) {
+	u32b hash = 5381;
+	char path[1024];
+	byte buf[4096];
+	int i, j, n;
+
+	for (i = 0; sources[i]; i++) {
+		ang_file *fh;
+
+		/* Look where parse_file() would */
+		path_build(path, sizeof(path), ANGBAND_DIR_USER,
+				   format("%s.txt", sources[i]));
+		if (!file_exists(path))
+			path_build(path, sizeof(path), ANGBAND_DIR_GAMEDATA,
+					   format("%s.txt", sources[i]));
+
+		fh = file_open(path, MODE_READ, FTYPE_RAW);
+		if (!fh) {
+			hash = hash * 33 + 1;
+			continue;
+		}
+		while ((n = file_read(fh, (char *)buf, sizeof(buf))) > 0) {
+			for (j = 0; j + 4 <= n; j += 4)
+				hash = hash * 33 + parse_cache_u32b(buf + j);
+			for (; j < n; j++)
+				hash = hash * 33 + buf[j];
+		}
+		file_close(fh);
+
+		/* Separate the files */
+		hash = hash * 33;
+	}
+
+	return hash;
+}
+
+static u32b parse_cache_checksum(const byte *data, size_t len) {
+	u32b sum = 0;
+	size_t i;
+
+	for (i = 0; i + 4 <= len; i += 4)
+		sum = (sum << 5) + (sum >> 27) + parse_cache_u32b(data + i);
+	for (; i < len; i++)
+		sum = (sum << 5) + (sum >> 27) + data[i];
+	return sum;
+}
+
+/**
+ * Open the cache with the given name, built from the given NULL-terminated
+ * list of game data files.  If the stored cache is valid for the current
+ * files and build, parse_cache_loaded() is true and the payload can be read
+ * back with the parse_cache_get_*() functions; otherwise the payload is empty,
+ * ready to be filled with parse_cache_put_*() and saved.
+ */
+struct parse_cache *parse_cache_open(const char *name, const char **sources) {
+	struct parse_cache *c = mem_zalloc(sizeof(*c));
+	ang_file *fh;
+	byte *data = NULL;
+	size_t len = 0, size = 0;
+	int n;
+
+	c->source_hash = parse_cache_hash_sources(sources);
+	c->ok = true;
+	path_build(c->path, sizeof(c->path), ANGBAND_DIR_USER,
+			   format("%s.cache", name));
+
+	/* Read the whole file */
+	fh = file_open(c->path, MODE_READ, FTYPE_RAW);
+	if (!fh)
+		return c;
+	do {
+		if (len == size) {
+			size = size ? 2 * size : 65536;
+			data = mem_realloc(data, size);
+		}
+		n = file_read(fh, (char *)data + len, size - len);
+		if (n > 0)
+			len += n;
+	} while (n > 0);
+	file_close(fh);
+
+	/* Check the header and the payload */
+	c->buf = data;
+	c->size = size;
+	c->len = len;
+	c->pos = 0;
+	if (parse_cache_get_u32b(c) == PARSE_CACHE_MAGIC &&
+		parse_cache_get_u32b(c) == PARSE_CACHE_VERSION) {
+		char *build = parse_cache_get_str(c);
+		u32b hash = parse_cache_get_u32b(c);
+		u32b payload = parse_cache_get_u32b(c);
+
+		if (c->ok && build && streq(build, buildid) &&
+			hash == c->source_hash && payload + 4 == c->len - c->pos &&
+			parse_cache_u32b(c->buf + c->pos + payload) ==
+			parse_cache_checksum(c->buf + c->pos, payload)) {
+			c->len = c->pos + payload;
+			c->loaded = true;
+		}
+		string_free(build);
+	}
+
+	/* Start afresh if the cache is no good */
+	if (!c->loaded) {
+		c->len = 0;
+		c->pos = 0;
+		c->ok = true;
+	}
+
+	return c;
+}
+
+/**
+ * Return whether a cache was loaded from disk
+ */
+bool parse_cache_loaded(struct parse_cache *c) {
+	return c->loaded;
+}
+
+/**
+ * Return whether everything read from a cache so far was there to be read
+ */
+bool parse_cache_ok(struct parse_cache *c) {
+	return c->ok;
+}
+
+void parse_cache_put(struct parse_cache *c, const void *data, size_t len) {
+	if (c->len + len > c->size) {
+		c->size = MAX(c->len + len, c->size ? 2 * c->size : 65536);
+		c->buf = mem_realloc(c->buf, c->size);
+	}
+	memcpy(c->buf + c->len, data, len);
+	c->len += len;
+}
+
+void parse_cache_put_byte(struct parse_cache *c, byte v) {
+	parse_cache_put(c, &v, 1);
+}
+
+void parse_cache_put_u32b(struct parse_cache *c, u32b v) {
+	byte b[4];
+
+	b[0] = v & 0xFF;
+	b[1] = (v >> 8) & 0xFF;
+	b[2] = (v >> 16) & 0xFF;
+	b[3] = (v >> 24) & 0xFF;
+	parse_cache_put(c, b, 4);
+}
+
+void parse_cache_put_s32b(struct parse_cache *c, s32b v) {
+	parse_cache_put_u32b(c, (u32b)v);
+}
+
+void parse_cache_put_rand(struct parse_cache *c, random_value v) {
+	parse_cache_put_s32b(c, v.base);
+	parse_cache_put_s32b(c, v.dice);
+	parse_cache_put_s32b(c, v.sides);
+	parse_cache_put_s32b(c, v.m_bonus);
+}
+
+/**
+ * Store a string; NULL is stored as a length of 0xFFFFFFFF
+ */
+void parse_cache_put_str(struct parse_cache *c, const char *s) {
+	if (!s) {
+		parse_cache_put_u32b(c, 0xFFFFFFFF);
+		return;
+	}
+	parse_cache_put_u32b(c, strlen(s));
+	parse_cache_put(c, s, strlen(s));
+}
+
+/**
+ * Read back data stored with parse_cache_put(); if there is not enough left,
+ * the buffer is zeroed
+ */
+void parse_cache_get(struct parse_cache *c, void *data, size_t len) {
+	if (len > c->len - c->pos) {
+		c->ok = false;
+		memset(data, 0, len);
+		return;
+	}
+	memcpy(data, c->buf + c->pos, len);
+	c->pos += len;
+}
+
+byte parse_cache_get_byte(struct parse_cache *c) {
+	if (c->pos + 1 > c->len) {
+		c->ok = false;
+		return 0;
+	}
+	return c->buf[c->pos++];
+}
+
+u32b parse_cache_get_u32b(struct parse_cache *c) {
+	u32b v;
+
+	if (c->pos + 4 > c->len) {
+		c->ok = false;
+		return 0;
+	}
+	v = parse_cache_u32b(c->buf + c->pos);
+	c->pos += 4;
+	return v;
+}
+
+s32b parse_cache_get_s32b(struct parse_cache *c) {
+	return (s32b)parse_cache_get_u32b(c);
+}
+
+random_value parse_cache_get_rand(struct parse_cache *c) {
+	random_value v;
+
+	v.base = parse_cache_get_s32b(c);
+	v.dice = parse_cache_get_s32b(c);
+	v.sides = parse_cache_get_s32b(c);
+	v.m_bonus = parse_cache_get_s32b(c);
+	return v;
+}
+
+/**
+ * Read back a string, allocated with string_make(), or NULL
+ */
+char *parse_cache_get_str(struct parse_cache *c) {
+	u32b len = parse_cache_get_u32b(c);
+	char *s;
+
+	if (!c->ok || len == 0xFFFFFFFF)
+		return NULL;
+	if (len > c->len - c->pos) {
+		c->ok = false;
+		return NULL;
+	}
+	s = mem_alloc(len + 1);
+	memcpy(s, c->buf + c->pos, len);
+	s[len] = '\0';
+	c->pos += len;
+	return s;
+}
+
+/**
+ * Write a cache's payload out, replacing any old cache; failure just means
+ * the game data will be parsed again next time.  The user directory may not
+ * exist yet on a first run, so it is made here if need be.
+ */
+void parse_cache_save(struct parse_cache *c) {
+	struct parse_cache *head;
+	char new_path[1024];
+	ang_file *fh;
+	bool ok;
+
+	if (!dir_create(ANGBAND_DIR_USER))
+		return;
+
+	head = mem_zalloc(sizeof(*head));
+	parse_cache_put_u32b(head, PARSE_CACHE_MAGIC);
+	parse_cache_put_u32b(head, PARSE_CACHE_VERSION);
+	parse_cache_put_str(head, buildid);
+	parse_cache_put_u32b(head, c->source_hash);
+	parse_cache_put_u32b(head, c->len);
+
+	/* Write to a new file and move it over the old one */
+	strnfmt(new_path, sizeof(new_path), "%s.new", c->path);
+	fh = file_open(new_path, MODE_WRITE, FTYPE_RAW);
+	if (fh) {
+		byte sum[4];
+		u32b v = parse_cache_checksum(c->buf, c->len);
+
+		sum[0] = v & 0xFF;
+		sum[1] = (v >> 8) & 0xFF;
+		sum[2] = (v >> 16) & 0xFF;
+		sum[3] = (v >> 24) & 0xFF;
+		ok = file_write(fh, (char *)head->buf, head->len) &&
+			file_write(fh, (char *)c->buf, c->len) &&
+			file_write(fh, (char *)sum, 4);
+		file_close(fh);
+		if (ok) {
+			file_delete(c->path);
+			ok = file_move(new_path, c->path);
+		}
+		if (!ok)
+			file_delete(new_path);
+	}
+
+	parse_cache_close(head);
+}
+
+void parse_cache_close(struct parse_cache *c) {
+	mem_free(c->buf);
+	mem_free(c);
+}
+
+/**
+ * Parse a game data file through its cache.  If the cache built from the
+ * given sources is current, read() is given the parser and the cache; it
+ * should fill in the parser's private data just as parsing the file would,
+ * including anything parsing registers with the rest of the game, and
+ * return true.  If it can't read the cache it should return false and leave
+ * everything as it was, and the file is parsed as usual.  After parsing,
+ * write() stores the parser's private data in a new cache for next time, or
+ * returns false if it can't, in which case no cache is saved.
+ */
+errr parse_file_cached(struct parser *p, const char *filename,
+					   const char **sources,
+					   bool (*read)(struct parser *p, struct parse_cache *c),
+					   bool (*write)(struct parser *p, struct parse_cache *c))
+{
+	struct parse_cache *c = parse_cache_open(filename, sources);
+	errr r;
+
+	if (parse_cache_loaded(c)) {
+		if (read(p, c)) {
+			parse_cache_close(c);
+			return 0;
+		}
+
+		/* Start a new cache */
+		parse_cache_close(c);
+		c = parse_cache_open(filename, sources);
+	}
+
+	r = parse_file_quit_not_found(p, filename);
+	if (!r && write(p, c))
+		parse_cache_save(c);
+	parse_cache_close(c);
+	return r;
+}
+
 int lookup_flag(const char **flag_table, const char *flag_name) {
 	int i = FLAG_START;
 
@@ -79,6 +79,29 @@ errr run_parser(struct file_parser *fp);
 errr parse_file_quit_not_found(struct parser *p, const char *filename);
 errr parse_file(struct parser *p, const char *filename);
 void cleanup_parser(struct file_parser *fp);
+
+struct parse_cache;
+struct parse_cache *parse_cache_open(const char *name, const char **sources);
+bool parse_cache_loaded(struct parse_cache *c);
+bool parse_cache_ok(struct parse_cache *c);
+void parse_cache_put(struct parse_cache *c, const void *data, size_t len);
+void parse_cache_put_byte(struct parse_cache *c, byte v);
+void parse_cache_put_u32b(struct parse_cache *c, u32b v);
+void parse_cache_put_s32b(struct parse_cache *c, s32b v);
+void parse_cache_put_rand(struct parse_cache *c, random_value v);
+void parse_cache_put_str(struct parse_cache *c, const char *s);
+void parse_cache_get(struct parse_cache *c, void *data, size_t len);
+byte parse_cache_get_byte(struct parse_cache *c);
+u32b parse_cache_get_u32b(struct parse_cache *c);
+s32b parse_cache_get_s32b(struct parse_cache *c);
+random_value parse_cache_get_rand(struct parse_cache *c);
+char *parse_cache_get_str(struct parse_cache *c);
+void parse_cache_save(struct parse_cache *c);
+void parse_cache_close(struct parse_cache *c);
+errr parse_file_cached(struct parser *p, const char *filename,
+					   const char **sources,
+					   bool (*read)(struct parser *p, struct parse_cache *c),
+					   bool (*write)(struct parser *p, struct parse_cache *c));
 int lookup_flag(const char **flag_table, const char *flag_name);
 errr grab_rand_value(random_value *value, const char **value_type,
 					 const char *name_and_value);
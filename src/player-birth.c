@@ -23,6 +23,7 @@
 #include "game-world.h"
 #include "init.h"
 #include "mon-lore.h"
+#include "mon-make.h"
 #include "monster.h"
 #include "obj-gear.h"
 #include "obj-ignore.h"
@@ -419,6 +420,7 @@ void player_init(struct player *p)
 			race->max_num = 1;
 		lore->pkills = 0;
 	}
+	mon_uniques_changed();
 
 	/* Always start with a well fed player (this is surely in the wrong fn) */
 	p->food = PY_FOOD_FULL - 1;
@@ -1668,44 +1668,27 @@ int weight_remaining(struct player *p)
 
 
 /**
- * Calculate the players current "state", taking into account
- * not only race/class intrinsics, but also objects being worn
- * and temporary spell effects.
- *
- * See also calc_mana() and calc_hitpoints().
+ * Calculate the part of the player's state that comes from race, class and
+ * equipment.  It only needs working out again when one of those changes,
+ * so update_bonuses() keeps it and calc_bonuses_from_gear() builds the rest
+ * of the state on top of it.
  *
- * Take note of the new "speed code", in particular, a very strong
- * player will start slowing down as soon as he reaches 150 pounds,
- * but not until he reaches 450 pounds will he be half as fast as
- * a normal kobold.  This both hurts and helps the player, hurts
- * because in the old days a player could just avoid 300 pounds,
- * and helps because now carrying 300 pounds is not very painful.
- *
- * The "weapon" and "bow" do *not* add to the bonuses to hit or to
- * damage, since that would affect non-combat things.  These values
- * are actually added in later, at the appropriate place.
- *
- * If known_only is true, calc_bonuses() will only use the known
- * information of objects; thus it returns what the player _knows_
- * the character state to be.
+ * If known_only is true, only the known information of objects is used.
  */
-void calc_bonuses(struct player *p, struct player_state *state, bool known_only,
-				  bool update)
+static void calc_gear_bonuses(struct player *p, struct gear_bonuses *gear,
+							  bool known_only)
 {
-	int i, j, hold;
-
-	int extra_blows = 0;
-	int extra_shots = 0;
-	int extra_might = 0;
+	int i, j;
 
+	struct player_state *state = &gear->state;
 	struct object *obj;
 
 	bitflag f[OF_SIZE];
 	bitflag collect_f[OF_SIZE];
-	bool vuln[ELEM_MAX];
+	bool *vuln = gear->vuln;
 
 	/* Reset */
-	memset(state, 0, sizeof *state);
+	memset(gear, 0, sizeof *gear);
 
 	/* Set various defaults */
 	state->speed = 110;
@@ -1745,10 +1728,6 @@ void calc_bonuses(struct player *p, struct player_state *state, bool known_only,
 	/* Extract the player flags */
 	player_flags(p, collect_f);
 
-	/* Add player specific pflags */
-	if (!p->csp)
-		pf_on(state->pflags, PF_NO_MANA);
-
 	/* ------------------------------------
 	 * Analyze equipment
 	 * ------------------------------------ */
@@ -1799,13 +1778,13 @@ void calc_bonuses(struct player *p, struct player_state *state, bool known_only,
 		state->speed += obj->modifiers[OBJ_MOD_SPEED];
 
 		/* Affect blows */
-		extra_blows += obj->modifiers[OBJ_MOD_BLOWS];
+		gear->extra_blows += obj->modifiers[OBJ_MOD_BLOWS];
 
 		/* Affect shots */
-		extra_shots += obj->modifiers[OBJ_MOD_SHOTS];
+		gear->extra_shots += obj->modifiers[OBJ_MOD_SHOTS];
 
 		/* Affect Might */
-		extra_might += obj->modifiers[OBJ_MOD_MIGHT];
+		gear->extra_might += obj->modifiers[OBJ_MOD_MIGHT];
 
 		/* Affect resists */
 		for (j = 0; j < ELEM_MAX; j++)
@@ -1843,6 +1822,51 @@ void calc_bonuses(struct player *p, struct player_state *state, bool known_only,
 	 * ------------------------------------ */
 
 	of_union(state->flags, collect_f);
+}
+
+/**
+ * Calculate the players current "state", taking into account
+ * not only race/class intrinsics, but also objects being worn
+ * and temporary spell effects.
+ *
+ * See also calc_mana() and calc_hitpoints().
+ *
+ * Take note of the new "speed code", in particular, a very strong
+ * player will start slowing down as soon as he reaches 150 pounds,
+ * but not until he reaches 450 pounds will he be half as fast as
+ * a normal kobold.  This both hurts and helps the player, hurts
+ * because in the old days a player could just avoid 300 pounds,
+ * and helps because now carrying 300 pounds is not very painful.
+ *
+ * The "weapon" and "bow" do *not* add to the bonuses to hit or to
+ * damage, since that would affect non-combat things.  These values
+ * are actually added in later, at the appropriate place.
+ *
+ * This part starts from the race, class and equipment contribution
+ * worked out by calc_gear_bonuses(), and adds stats, timed effects,
+ * weight and everything else that can change without the gear changing.
+ */
+static void calc_bonuses_from_gear(struct player *p,
+								   struct player_state *state,
+								   const struct gear_bonuses *gear,
+								   bool update)
+{
+	int i, j, hold;
+
+	int extra_blows = gear->extra_blows;
+	int extra_shots = gear->extra_shots;
+	int extra_might = gear->extra_might;
+
+	struct object *obj;
+
+	const bool *vuln = gear->vuln;
+
+	/* Start from race, class and equipment */
+	*state = gear->state;
+
+	/* Add player specific pflags */
+	if (!p->csp)
+		pf_on(state->pflags, PF_NO_MANA);
 
 	/* ------------------------------------
 	 * Handle stats
@@ -2209,6 +2233,23 @@ void calc_bonuses(struct player *p, struct player_state *state, bool known_only,
 	return;
 }
 
+/**
+ * Calculate the players current "state" from scratch; see
+ * calc_gear_bonuses() and calc_bonuses_from_gear().
+ *
+ * If known_only is true, calc_bonuses() will only use the known
+ * information of objects; thus it returns what the player _knows_
+ * the character state to be.
+ */
+void calc_bonuses(struct player *p, struct player_state *state, bool known_only,
+				  bool update)
+{
+	struct gear_bonuses gear;
+
+	calc_gear_bonuses(p, &gear, known_only);
+	calc_bonuses_from_gear(p, state, &gear, update);
+}
+
 /**
  * Calculate bonuses, and print various things on changes.
  */
@@ -2224,8 +2265,16 @@ static void update_bonuses(struct player *p)
 	 * Calculate bonuses
 	 * ------------------------------------ */
 
-	calc_bonuses(p, &state, false, true);
-	calc_bonuses(p, &known_state, true, true);
+	/* Race, class and equipment only need redoing after PU_BONUS */
+	if (!p->upkeep->gear_bonuses_valid) {
+		calc_gear_bonuses(p, &p->upkeep->gear_bonuses, false);
+		calc_gear_bonuses(p, &p->upkeep->known_gear_bonuses, true);
+		p->upkeep->gear_bonuses_valid = true;
+	}
+
+	calc_bonuses_from_gear(p, &state, &p->upkeep->gear_bonuses, true);
+	calc_bonuses_from_gear(p, &known_state, &p->upkeep->known_gear_bonuses,
+						   true);
 
 
 	/* ------------------------------------
@@ -2458,7 +2507,12 @@ void update_stuff(struct player *p)
 	}
 
 	if (p->upkeep->update & (PU_BONUS)) {
-		p->upkeep->update &= ~(PU_BONUS);
+		/* Something other than a timed effect changed */
+		p->upkeep->gear_bonuses_valid = false;
+	}
+
+	if (p->upkeep->update & (PU_BONUS | PU_TIMED_BONUS)) {
+		p->upkeep->update &= ~(PU_BONUS | PU_TIMED_BONUS);
 		update_bonuses(p);
 	}
 
@@ -2626,5 +2680,8 @@ void handle_stuff(struct player *p)
 {
 	if (p->upkeep->update) update_stuff(p);
 	if (p->upkeep->redraw) redraw_stuff(p);
+
+	/* Draw the map grids that changed since last time in one go */
+	event_flush_map_points();
 }
 
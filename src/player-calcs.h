@@ -46,6 +46,7 @@
 #define PU_DISTANCE		0x00000400L	/* Update distances */
 #define PU_PANEL		0x00000800L	/* Update panel */
 #define PU_INVEN		0x00001000L	/* Update inventory */
+#define PU_TIMED_BONUS	0x00002000L	/* Calculate bonuses, gear unchanged */
 
 
 /**
@@ -44,11 +44,32 @@
 #define MAX_PF_LENGTH 500
 
 
+/**
+ * Number of grids in the pathfinder's window
+ */
+#define MAX_PF_GRIDS (MAX_PF_RADIUS * MAX_PF_RADIUS)
+
+/**
+ * Distance from the player (plus one) of each grid reached by the search,
+ * valid only when the grid's stamp matches the current search
+ */
 static int terrain[MAX_PF_RADIUS][MAX_PF_RADIUS];
+static u16b pf_stamp[MAX_PF_RADIUS][MAX_PF_RADIUS];
+static u16b pf_search;
+
+/**
+ * The open set, as a binary heap of grid indices ordered by estimated path
+ * length, and the position of each grid in the heap (-1 once closed)
+ */
+static int pf_heap[MAX_PF_GRIDS];
+static int pf_heap_pos[MAX_PF_GRIDS];
+static int pf_heap_size;
+
 static char pf_result[MAX_PF_LENGTH];
 static int pf_result_index;
 
 static int ox, oy, ex, ey;
+static int ty, tx;
 static int dir_search[8] = {2,4,6,8,1,3,7,9};
 
 
@@ -61,86 +82,184 @@ static bool is_valid_pf(int y, int x)
 	return (square_ispassable(cave, y, x));
 }
 
+/**
+ * Set the pathfinder's window around the player, and start a new search
+ */
 static void fill_terrain_info(void)
 {
-	int i, j;
-
 	ox = MAX(player->px - MAX_PF_RADIUS / 2, 0);
 	oy = MAX(player->py - MAX_PF_RADIUS / 2, 0);
 
 	ex = MIN(player->px + MAX_PF_RADIUS / 2 - 1, cave->width);
 	ey = MIN(player->py + MAX_PF_RADIUS / 2 - 1, cave->height);
 
-	for (i = 0; i < MAX_PF_RADIUS; i++)
-		for (j = 0; j < MAX_PF_RADIUS; j++)
-			terrain[i][j] = -1;
+	/* Forget every grid from the last search, wiping only on wraparound */
+	if (++pf_search == 0) {
+		memset(pf_stamp, 0, sizeof(pf_stamp));
+		pf_search = 1;
+	}
+
+	pf_heap_size = 0;
+}
+
+/**
+ * Lower bound on the number of steps from a grid to the target, which is
+ * the larger of the two offsets since diagonal steps cost the same as
+ * orthogonal ones.  (distance() would overestimate, losing shortest paths.)
+ */
+static int pf_estimate(int idx)
+{
+	int y = idx / MAX_PF_RADIUS + oy;
+	int x = idx % MAX_PF_RADIUS + ox;
+
+	return MAX(ABS(y - ty), ABS(x - tx));
+}
+
+/**
+ * Whether open grid a should come out of the heap before open grid b;
+ * ties go to the grid further along, which is usually nearer the target
+ */
+static bool pf_before(int a, int b)
+{
+	int ga = terrain[a / MAX_PF_RADIUS][a % MAX_PF_RADIUS];
+	int gb = terrain[b / MAX_PF_RADIUS][b % MAX_PF_RADIUS];
+	int fa = ga + pf_estimate(a);
+	int fb = gb + pf_estimate(b);
+
+	return (fa < fb) || ((fa == fb) && (ga > gb));
+}
+
+static void pf_heap_set(int pos, int idx)
+{
+	pf_heap[pos] = idx;
+	pf_heap_pos[idx] = pos;
+}
+
+static void pf_heap_up(int pos)
+{
+	int idx = pf_heap[pos];
 
-	for (j = oy; j < ey; j++)
-		for (i = ox; i < ex; i++)
-			if (is_valid_pf(j, i))
-				terrain[j - oy][i - ox] = MAX_PF_LENGTH;
+	while (pos > 0) {
+		int parent = (pos - 1) / 2;
+		if (!pf_before(idx, pf_heap[parent])) break;
+		pf_heap_set(pos, pf_heap[parent]);
+		pos = parent;
+	}
+	pf_heap_set(pos, idx);
+}
+
+static int pf_heap_pop(void)
+{
+	int top = pf_heap[0];
+	int idx = pf_heap[--pf_heap_size];
+	int pos = 0;
+
+	pf_heap_pos[top] = -1;
+	if (!pf_heap_size) return top;
+
+	while (true) {
+		int child = 2 * pos + 1;
+		if (child >= pf_heap_size) break;
+		if ((child + 1 < pf_heap_size) &&
+			pf_before(pf_heap[child + 1], pf_heap[child]))
+			child++;
+		if (!pf_before(pf_heap[child], idx)) break;
+		pf_heap_set(pos, pf_heap[child]);
+		pos = child;
+	}
+	pf_heap_set(pos, idx);
 
-	terrain[player->py - oy][player->px - ox] = 1;
+	return top;
 }
 
-#define MARK_DISTANCE(c,d) if ((c <= MAX_PF_LENGTH) && (c > d)) \
-							{ c = d; try_again = (true); }
+/**
+ * Offer a grid (relative to the window) a path of the given length; the
+ * target is always allowed, even if it looks impassable
+ */
+static void pf_offer(int j, int i, int dist)
+{
+	int idx = j * MAX_PF_RADIUS + i;
+
+	if (pf_stamp[j][i] != pf_search) {
+		pf_stamp[j][i] = pf_search;
+		if ((j + oy != ty || i + ox != tx) && !is_valid_pf(j + oy, i + ox)) {
+			terrain[j][i] = -1;
+			return;
+		}
+		terrain[j][i] = dist;
+		pf_heap_set(pf_heap_size++, idx);
+		pf_heap_up(pf_heap_pos[idx]);
+		return;
+	}
+
+	/* Closed, impassable, or no shorter than before */
+	if (terrain[j][i] < 0 || terrain[j][i] <= dist || pf_heap_pos[idx] < 0)
+		return;
 
+	terrain[j][i] = dist;
+	pf_heap_up(pf_heap_pos[idx]);
+}
+
+/**
+ * Find a shortest path from the player to (y, x), by A* search over the
+ * grids within MAX_PF_RADIUS / 2 of the player.  On success the path is
+ * left in pf_result as a string of directions, last step first.
+ */
 bool findpath(int y, int x)
 {
 	int i, j, k;
 	int dir = 10;
-	bool try_again;
 	int cur_distance;
+	int found = 0;
 
 	fill_terrain_info();
 
-	terrain[player->py - oy][player->px - ox] = 1;
-
-	if ((x >= ox) && (x < ex) && (y >= oy) && (y < ey)) {
-		if ((cave->squares[y][x].mon > 0) &&
-			mflag_has(square_monster(cave, y, x)->mflag, MFLAG_VISIBLE))
-			terrain[y - oy][x - ox] = MAX_PF_LENGTH;
-
-		terrain[y - oy][x - ox] = MAX_PF_LENGTH;
-	} else {
+	if ((x < ox) || (x >= ex) || (y < oy) || (y >= ey)) {
 		bell("Target out of range.");
 		return (false);
 	}
 
-	/* 
-	 * And now starts the very naive and very 
-	 * inefficient pathfinding algorithm
-	 */
-	do {
-		try_again = false;
-
-		for (j = oy + 1; j < ey - 1; j++) {
-			for (i = ox + 1; i < ex - 1; i++) {
-				cur_distance = terrain[j - oy][i - ox] + 1;
-
-				if ((cur_distance > 0) && (cur_distance < MAX_PF_LENGTH)) {
-					for (dir = 1; dir < 10; dir++) {
-						int next_y, next_x;
-						if (dir == 5)
-							dir++;
-						next_y = j - oy + ddy[dir];
-						next_x = i - ox + ddx[dir];
-
-						MARK_DISTANCE(terrain[next_y][next_x], cur_distance);
-					}
-				}
-			}
+	ty = y;
+	tx = x;
+
+	pf_offer(player->py - oy, player->px - ox, 1);
+
+	while (pf_heap_size) {
+		int idx = pf_heap[0];
+
+		j = idx / MAX_PF_RADIUS;
+		i = idx % MAX_PF_RADIUS;
+
+		/*
+		 * Once the target is reached, carry on until every grid which could
+		 * be on a shortest path to it has its final distance, so the path
+		 * is traced back below just as it was over fully relaxed distances
+		 */
+		if (found && (terrain[j][i] + pf_estimate(idx) > found)) break;
+		pf_heap_pop();
+
+		/* Arrived */
+		if ((j + oy == y) && (i + ox == x)) {
+			found = terrain[j][i];
+			continue;
 		}
 
-		if (terrain[y - oy][x - ox] < MAX_PF_LENGTH)
-			try_again = false;
+		/* Grids on the edge of the window are never expanded */
+		if ((j + oy <= oy) || (j + oy >= ey - 1) ||
+			(i + ox <= ox) || (i + ox >= ex - 1))
+			continue;
+
+		cur_distance = terrain[j][i] + 1;
+		if (cur_distance >= MAX_PF_LENGTH) continue;
 
+		for (dir = 1; dir < 10; dir++) {
+			if (dir == 5) continue;
+			pf_offer(j + ddy[dir], i + ddx[dir], cur_distance);
+		}
 	}
-	while (try_again) ;
 
 	/* Failure */
-	if (terrain[y - oy][x - ox] == MAX_PF_LENGTH) {
+	if (!found) {
 		bell("Target space unreachable.");
 		return (false);
 	}
@@ -154,8 +273,15 @@ bool findpath(int y, int x)
 	while ((i != player->px) || (j != player->py)) {
 		cur_distance = terrain[j - oy][i - ox] - 1;
 		for (k = 0; k < 8; k++) {
+			int next_y = j - oy + ddy[dir_search[k]];
+			int next_x = i - ox + ddx[dir_search[k]];
+
 			dir = dir_search[k];
-			if (terrain[j - oy + ddy[dir]][i - ox + ddx[dir]] == cur_distance)
+			if ((next_y < 0) || (next_x < 0) || (next_y >= MAX_PF_RADIUS) ||
+				(next_x >= MAX_PF_RADIUS))
+				continue;
+			if ((pf_stamp[next_y][next_x] == pf_search) &&
+				(terrain[next_y][next_x] == cur_distance))
 				break;
 		}
 
@@ -172,6 +298,21 @@ bool findpath(int y, int x)
 	return (true);
 }
 
+/**
+ * Copy the directions of the last path found by findpath() into buf, first
+ * step first, as a NUL-terminated string; return the number of steps
+ */
+int findpath_result(char *buf, size_t len)
+{
+	int i, n = 0;
+
+	for (i = pf_result_index; i >= 0 && (size_t)n + 1 < len; i--)
+		buf[n++] = pf_result[i];
+	if (len) buf[n] = '\0';
+
+	return pf_result_index + 1;
+}
+
 /**
  * Compute the direction (in the angband 123456789 sense) from a point to a
  * point. We decide to use diagonals if dx and dy are within a factor of two of
@@ -36,4 +36,5 @@ extern void get_spell_info(int index, char *buf, size_t len);
 extern bool cast_spell(int tval, int index, int dir);
 extern bool spell_needs_aim(int spell_index);
 extern expression_base_value_f spell_value_base_by_name(const char *name);
+extern const char *spell_value_base_name(expression_base_value_f function);
 
@@ -363,7 +363,7 @@ static bool set_stun(struct player *p, int v)
 
 	/* Disturb and update */
 	disturb(player, 0);
-	p->upkeep->update |= (PU_BONUS);
+	p->upkeep->update |= (PU_TIMED_BONUS);
 	p->upkeep->redraw |= (PR_STATUS);
 	handle_stuff(player);
 
@@ -520,7 +520,7 @@ static bool set_cut(struct player *p, int v)
 
 	/* Disturb and update */
 	disturb(player, 0);
-	p->upkeep->update |= (PU_BONUS);
+	p->upkeep->update |= (PU_TIMED_BONUS);
 	p->upkeep->redraw |= (PR_STATUS);
 	handle_stuff(player);
 
@@ -614,7 +614,7 @@ bool player_set_food(struct player *p, int v)
 
 	/* Disturb and update */
 	disturb(player, 0);
-	p->upkeep->update |= (PU_BONUS);
+	p->upkeep->update |= (PU_TIMED_BONUS);
 	p->upkeep->redraw |= (PR_STATUS);
 	handle_stuff(player);
 
@@ -428,6 +428,18 @@ struct player_state {
 	struct element_info el_info[ELEM_MAX]; /* Resists from race and items */
 };
 
+/**
+ * The part of the player's state that comes from race, class and equipment,
+ * along with what calc_bonuses() needs to finish the state off from it.
+ */
+struct gear_bonuses {
+	struct player_state state;
+	int extra_blows;
+	int extra_shots;
+	int extra_might;
+	bool vuln[ELEM_MAX];
+};
+
 /**
  * Temporary, derived, player-related variables used during play but not saved
  *
@@ -476,6 +488,10 @@ struct player_upkeep {
 	int inven_cnt;				/* Number of items in inventory */
 	int equip_cnt;				/* Number of items in equipment */
 	int quiver_cnt;				/* Number of items in the quiver */
+
+	struct gear_bonuses gear_bonuses;		/* Gear part of state */
+	struct gear_bonuses known_gear_bonuses;	/* Gear part of known_state */
+	bool gear_bonuses_valid;				/* Both are up to date */
 };
 
 
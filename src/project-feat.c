@@ -50,7 +50,7 @@ static void project_feature_handler_LIGHT_WEAK(project_feature_handler_context_t
 	const int y = context->y;
 
 	/* Turn on the light */
-	sqinfo_on(cave->squares[y][x].info, SQUARE_GLOW);
+	square_flag_on(cave, y, x, SQUARE_GLOW);
 
 	/* Grid is in line of sight */
 	if (square_isview(cave, y, x)) {
@@ -72,7 +72,7 @@ static void project_feature_handler_DARK_WEAK(project_feature_handler_context_t
 
 	if (player->depth != 0 || !is_daytime())
 		/* Turn off the light */
-		sqinfo_off(cave->squares[y][x].info, SQUARE_GLOW);
+		square_flag_off(cave, y, x, SQUARE_GLOW);
 
 	/* Grid is in line of sight */
 	if (square_isview(cave, y, x)) {
@@ -176,8 +176,8 @@ static void project_feature_handler_KILL_WALL(project_feature_handler_context_t
 	/* Update the visuals */
 	player->upkeep->update |= (PU_UPDATE_VIEW | PU_MONSTERS);
 
-	/* Fully update the flow */
-	player->upkeep->update |= (PU_FORGET_FLOW | PU_UPDATE_FLOW);
+	/* Update the flow around the new opening */
+	player->upkeep->update |= (PU_UPDATE_FLOW);
 }
 
 /* Destroy Doors */
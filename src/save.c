@@ -171,9 +171,10 @@ static void wr_item(const struct object *obj)
 /**
  * Write a monster record (including held or mimicked objects)
  */
-static void wr_monster(const struct monster *mon)
+static void wr_monster(const struct monster *mon, bool handled)
 {
 	size_t j;
+	bitflag mflag[MFLAG_SIZE];
 	struct object *obj = mon->held_obj; 
 	struct object *dummy = object_new();
 
@@ -189,8 +190,12 @@ static void wr_monster(const struct monster *mon)
 	for (j = 0; j < MON_TMD_MAX; j++)
 		wr_s16b(mon->m_timed[j]);
 
+	/* Note monsters which have already acted this game turn */
+	mflag_copy(mflag, mon->mflag);
+	if (handled)
+		mflag_on(mflag, MFLAG_HANDLED);
 	for (j = 0; j < MFLAG_SIZE; j++)
-		wr_byte(mon->mflag[j]);
+		wr_byte(mflag[j]);
 
 	for (j = 0; j < OF_SIZE; j++)
 		wr_byte(mon->known_pstate.flags[j]);
@@ -240,21 +245,22 @@ static void wr_trap(struct trap *trap)
 void wr_randomizer(void)
 {
 	int i;
+	struct rng_state *rng = Rand_context();
 
 	/* current value for the simple RNG */
-	wr_u32b(Rand_value);
+	wr_u32b(rng->value);
 
 	/* state index */
-	wr_u32b(state_i);
+	wr_u32b(rng->state_i);
 
 	/* RNG variables */
-	wr_u32b(z0);
-	wr_u32b(z1);
-	wr_u32b(z2);
+	wr_u32b(rng->z0);
+	wr_u32b(rng->z1);
+	wr_u32b(rng->z2);
 
 	/* RNG state */
 	for (i = 0; i < RAND_DEG; i++)
-		wr_u32b(STATE[i]);
+		wr_u32b(rng->state[i]);
 
 	/* NULL padding */
 	for (i = 0; i < 59 - RAND_DEG; i++)
@@ -707,6 +713,33 @@ void wr_stores(void)
 
 
 
+/**
+ * Write a run length encoding of some bytes
+ */
+static void wr_rle(const byte *data, size_t n)
+{
+	size_t i;
+	byte count = 0;
+	byte prev_char = 0;
+
+	for (i = 0; i < n; i++) {
+		/* If the run is broken, or too full, flush it */
+		if ((data[i] != prev_char) || (count == UCHAR_MAX)) {
+			wr_byte((byte)count);
+			wr_byte((byte)prev_char);
+			prev_char = data[i];
+			count = 1;
+		} else /* Continue the run */
+			count++;
+	}
+
+	/* Flush the data (if any) */
+	if (count) {
+		wr_byte((byte)count);
+		wr_byte((byte)prev_char);
+	}
+}
+
 /**
  * Write the current dungeon terrain features and info flags
  *
@@ -714,74 +747,44 @@ void wr_stores(void)
  */
 static void wr_dungeon_aux(struct chunk *c)
 {
-	int y, x;
-	size_t i;
-
-	byte tmp8u;
+	size_t grids = c->height * c->width;
+	size_t i, grid;
+	int flag;
 
-	byte count;
-	byte prev_char;
+	/* One array of bytes for each byte of the square info */
+	byte *info = mem_alloc(MAX(SQUARE_SIZE * grids, 1));
 
 	/* Dungeon specific info follows */
 	wr_string(c->name ? c->name : "Blank");
 	wr_u16b(c->height);
 	wr_u16b(c->width);
 
-	/* Run length encoding of c->squares[y][x].info */
-	for (i = 0; i < SQUARE_SIZE; i++) {
-		count = 0;
-		prev_char = 0;
-
-		/* Dump for each grid */
-		for (y = 0; y < c->height; y++) {
-			for (x = 0; x < c->width; x++) {
-				/* Extract the important c->squares[y][x].info flags */
-				tmp8u = c->squares[y][x].info[i];
-
-				/* If the run is broken, or too full, flush it */
-				if ((tmp8u != prev_char) || (count == UCHAR_MAX)) {
-					wr_byte((byte)count);
-					wr_byte((byte)prev_char);
-					prev_char = tmp8u;
-					count = 1;
-				} else /* Continue the run */
-					count++;
-			}
-		}
-
-		/* Flush the data (if any) */
-		if (count) {
-			wr_byte((byte)count);
-			wr_byte((byte)prev_char);
-		}
+	/* Gather the square info in one pass, then add the flags held in bit
+	 * planes, as square_get_info() would */
+	for (grid = 0; grid < grids; grid++)
+		for (i = 0; i < SQUARE_SIZE; i++)
+			info[i * grids + grid] = c->square_data[grid].info[i];
+	for (flag = FLAG_START; flag < SQUARE_MAX; flag++) {
+		int plane = square_flag_plane(flag);
+		byte *bytes = info + FLAG_OFFSET(flag) * grids;
+		int next;
+
+		if (plane < 0) continue;
+		for (next = cave_plane_next(c, plane, 0); next >= 0;
+			 next = cave_plane_next(c, plane, next + 1))
+			bytes[next] |= FLAG_BINARY(flag);
 	}
 
-	/* Now the terrain */
-	count = 0;
-	prev_char = 0;
+	/* Run length encoding of c->squares[y][x].info */
+	for (i = 0; i < SQUARE_SIZE; i++)
+		wr_rle(info + i * grids, grids);
 
-	/* Dump for each grid */
-	for (y = 0; y < c->height; y++) {
-		for (x = 0; x < c->width; x++) {
-			/* Extract a byte */
-			tmp8u = c->squares[y][x].feat;
-
-			/* If the run is broken, or too full, flush it */
-			if ((tmp8u != prev_char) || (count == UCHAR_MAX)) {
-				wr_byte((byte)count);
-				wr_byte((byte)prev_char);
-				prev_char = tmp8u;
-				count = 1;
-			} else /* Continue the run */
-				count++;
-		}
-	}
+	/* Now the terrain */
+	for (grid = 0; grid < grids; grid++)
+		info[grid] = c->square_data[grid].feat;
+	wr_rle(info, grids);
 
-	/* Flush the data (if any) */
-	if (count) {
-		wr_byte((byte)count);
-		wr_byte((byte)prev_char);
-	}
+	mem_free(info);
 
 	/* Write feeling */
 	wr_byte(c->feeling);
@@ -848,7 +851,7 @@ static void wr_monsters_aux(struct chunk *c)
 	for (i = 1; i < cave_monster_max(c); i++) {
 		const struct monster *mon = cave_monster(c, i);
 
-		wr_monster(mon);
+		wr_monster(mon, mon_is_handled(c, i));
 	}
 }
 
@@ -932,6 +935,13 @@ void wr_chunks(void)
 	/* Now write each chunk */
 	for (j = 0; j < chunk_list_max; j++) {
 		struct chunk *c = chunk_list[j];
+		u32b start = wr_tell();
+
+		/* Stored chunks don't change, so reuse what was written last time */
+		if (c->saved && !c->lent) {
+			wr_bytes(c->saved, c->saved_size);
+			continue;
+		}
 
 		/* Write the terrain and info */
 		wr_dungeon_aux(c);
@@ -944,6 +954,10 @@ void wr_chunks(void)
 
 		/* Write the traps */
 		wr_traps_aux(c);
+
+		/* Keep it for next time, unless it is shared with the level */
+		if (!c->lent)
+			c->saved = wr_copy(start, &c->saved_size);
 	}
 }
 
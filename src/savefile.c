@@ -36,6 +36,11 @@
  * ... data ...
  * padding so that block is a multiple of 4 bytes
  *
+ * Blocks of at least BLOCK_COMPRESS_MIN bytes are compressed if that makes
+ * them smaller.  A compressed block has BLOCK_COMPRESSED set in its version;
+ * its data is the 4-byte size of the uncompressed block followed by the
+ * output of lz_compress(), and its checksum is that of the uncompressed data.
+ *
  * The savefile deosn't contain the version number of that game that saved it;
  * versioning is left at the individual block level.  The current code
  * keeps a list of savefile blocks to save in savers[] below, along with
@@ -50,7 +55,9 @@
  *
  * Savefile loading and saving is done by keeping the current block in
  * memory, which is accessed using the wr_* and rd_* functions.  This is
- * then written out, whole, to disk, with the appropriate header.
+ * then written out, whole, to disk, with the appropriate header.  When
+ * loading, the whole savefile is read into memory first and blocks are
+ * read from there.
  *
  *
  * So, if you want to make a savefile compat-breaking change, then there are
@@ -86,6 +93,8 @@ struct blockheader {
 	char name[16];
 	u32b version;
 	u32b size;
+	u32b data_size;
+	bool compressed;
 };
 
 struct blockinfo {
@@ -159,11 +168,25 @@ static u32b buffer_size;
 static u32b buffer_pos;
 static u32b buffer_check;
 
+/* The whole of the savefile being read */
+static byte *image;
+static u32b image_size;
+static u32b image_pos;
+
 #define BUFFER_INITIAL_SIZE		1024
-#define BUFFER_BLOCK_INCREMENT	1024
+#define IMAGE_INITIAL_SIZE		65536
 
 #define SAVEFILE_HEAD_SIZE		28
 
+#define BLOCK_COMPRESSED		0x80000000
+#define BLOCK_COMPRESS_MIN		256
+
+/* Compression parameters; see lz_compress() */
+#define LZ_HASH_BITS	13
+#define LZ_MAX_OFFSET	(1 << 13)
+#define LZ_MAX_LITERAL	(1 << 5)
+#define LZ_MAX_MATCH	((1 << 8) + (1 << 3))
+
 
 /**
  * ------------------------------------------------------------------------
@@ -185,23 +208,41 @@ void note(const char *message)
  * Base put/get
  * ------------------------------------------------------------------------ */
 
-static void sf_put(byte v)
+/**
+ * Make room for n more bytes in the buffer, doubling it as often as needed
+ */
+static void sf_reserve(u32b n)
 {
 	assert(buffer != NULL);
 	assert(buffer_size > 0);
 
-	if (buffer_size == buffer_pos)
-	{
-		buffer_size += BUFFER_BLOCK_INCREMENT;
-		buffer = mem_realloc(buffer, buffer_size);
-	}
+	if (buffer_size - buffer_pos >= n) return;
 
-	assert(buffer_pos < buffer_size);
+	while (buffer_size - buffer_pos < n)
+		buffer_size *= 2;
+	buffer = mem_realloc(buffer, buffer_size);
+}
+
+static void sf_put(byte v)
+{
+	if (buffer_size == buffer_pos)
+		sf_reserve(1);
 
 	buffer[buffer_pos++] = v;
 	buffer_check += v;
 }
 
+static void sf_put_bytes(const byte *v, u32b n)
+{
+	u32b i;
+
+	sf_reserve(n);
+	memcpy(buffer + buffer_pos, v, n);
+	for (i = 0; i < n; i++)
+		buffer_check += v[i];
+	buffer_pos += n;
+}
+
 static byte sf_get(void)
 {
 	if ((buffer == NULL) || (buffer_size <= 0) || (buffer_pos >= buffer_size))
@@ -212,6 +253,20 @@ static byte sf_get(void)
 	return buffer[buffer_pos++];
 }
 
+static void sf_get_bytes(byte *v, u32b n)
+{
+	u32b i;
+
+	if ((buffer == NULL) || (buffer_pos > buffer_size) ||
+		(n > buffer_size - buffer_pos))
+		quit("Broken savefile - probably from a development version");
+
+	memcpy(v, buffer + buffer_pos, n);
+	for (i = 0; i < n; i++)
+		buffer_check += v[i];
+	buffer_pos += n;
+}
+
 
 /**
  * ------------------------------------------------------------------------
@@ -225,8 +280,11 @@ void wr_byte(byte v)
 
 void wr_u16b(u16b v)
 {
-	sf_put((byte)(v & 0xFF));
-	sf_put((byte)((v >> 8) & 0xFF));
+	byte bytes[2];
+
+	bytes[0] = (byte)(v & 0xFF);
+	bytes[1] = (byte)((v >> 8) & 0xFF);
+	sf_put_bytes(bytes, 2);
 }
 
 void wr_s16b(s16b v)
@@ -236,10 +294,13 @@ void wr_s16b(s16b v)
 
 void wr_u32b(u32b v)
 {
-	sf_put((byte)(v & 0xFF));
-	sf_put((byte)((v >> 8) & 0xFF));
-	sf_put((byte)((v >> 16) & 0xFF));
-	sf_put((byte)((v >> 24) & 0xFF));
+	byte bytes[4];
+
+	bytes[0] = (byte)(v & 0xFF);
+	bytes[1] = (byte)((v >> 8) & 0xFF);
+	bytes[2] = (byte)((v >> 16) & 0xFF);
+	bytes[3] = (byte)((v >> 24) & 0xFF);
+	sf_put_bytes(bytes, 4);
 }
 
 void wr_s32b(s32b v)
@@ -249,12 +310,35 @@ void wr_s32b(s32b v)
 
 void wr_string(const char *str)
 {
-	while (*str)
-	{
-		wr_byte(*str);
-		str++;
-	}
-	wr_byte(*str);
+	sf_put_bytes((const byte *)str, strlen(str) + 1);
+}
+
+void wr_bytes(const byte *v, u32b n)
+{
+	sf_put_bytes(v, n);
+}
+
+/**
+ * How much of the current block has been written so far
+ */
+u32b wr_tell(void)
+{
+	return buffer_pos;
+}
+
+/**
+ * Copy what has been written to the current block since wr_tell() gave
+ * `start`, for writing again later with wr_bytes()
+ */
+byte *wr_copy(u32b start, u32b *size)
+{
+	byte *copy;
+
+	assert(start <= buffer_pos);
+	*size = buffer_pos - start;
+	copy = mem_alloc(MAX(*size, 1));
+	memcpy(copy, buffer + start, *size);
+	return copy;
 }
 
 
@@ -265,8 +349,11 @@ void rd_byte(byte *ip)
 
 void rd_u16b(u16b *ip)
 {
-	(*ip) = sf_get();
-	(*ip) |= ((u16b)(sf_get()) << 8);
+	byte bytes[2];
+
+	sf_get_bytes(bytes, 2);
+	(*ip) = bytes[0];
+	(*ip) |= ((u16b)bytes[1] << 8);
 }
 
 void rd_s16b(s16b *ip)
@@ -276,10 +363,13 @@ void rd_s16b(s16b *ip)
 
 void rd_u32b(u32b *ip)
 {
-	(*ip) = sf_get();
-	(*ip) |= ((u32b)(sf_get()) << 8);
-	(*ip) |= ((u32b)(sf_get()) << 16);
-	(*ip) |= ((u32b)(sf_get()) << 24);
+	byte bytes[4];
+
+	sf_get_bytes(bytes, 4);
+	(*ip) = bytes[0];
+	(*ip) |= ((u32b)bytes[1] << 8);
+	(*ip) |= ((u32b)bytes[2] << 16);
+	(*ip) |= ((u32b)bytes[3] << 24);
 }
 
 void rd_s32b(s32b *ip)
@@ -314,6 +404,142 @@ void pad_bytes(int n)
 }
 
 
+/**
+ * ------------------------------------------------------------------------
+ * Block compression
+ * ------------------------------------------------------------------------ */
+
+/**
+ * Write a run of literal bytes to the compressed output, as one control
+ * byte (the length less one) for each LZ_MAX_LITERAL bytes, followed by
+ * the bytes themselves
+ */
+static bool lz_literals(byte **op, const byte *out_end, const byte *in,
+						u32b n)
+{
+	while (n) {
+		u32b run = MIN(n, LZ_MAX_LITERAL);
+
+		if ((u32b)(out_end - *op) < run + 1) return false;
+		*(*op)++ = (byte)(run - 1);
+		memcpy(*op, in, run);
+		*op += run;
+		in += run;
+		n -= run;
+	}
+
+	return true;
+}
+
+/**
+ * Compress in_len bytes into at most out_len bytes, returning the size of
+ * the output, or 0 if it would not fit.
+ *
+ * This is the LZF format: a control byte below LZ_MAX_LITERAL starts a run
+ * of literal bytes; any other control byte gives in its top three bits the
+ * length less two of a copy of earlier output (an extra byte is added if
+ * they are all set), and in its low five bits and the byte after that the
+ * distance back, less one, to copy from.  Repeats are found through a hash
+ * of the next three bytes.
+ */
+u32b lz_compress(const byte *in, u32b in_len, byte *out, u32b out_len)
+{
+	u32b *table = mem_zalloc((1 << LZ_HASH_BITS) * sizeof(u32b));
+	const byte *out_end = out + out_len;
+	byte *op = out;
+	u32b i = 0, literal = 0;
+
+	while (i + 2 < in_len) {
+		u32b hash = ((in[i] << 16) | (in[i + 1] << 8) | in[i + 2]) * 2654435761u
+			>> (32 - LZ_HASH_BITS);
+		u32b ref = table[hash];
+
+		/* Positions are kept plus one, so zero means no entry */
+		table[hash] = i + 1;
+
+		if (ref && (i - ref < LZ_MAX_OFFSET) &&
+			!memcmp(in + ref - 1, in + i, 3)) {
+			u32b offset = i - ref;
+			u32b len = 3, max = MIN(in_len - i, LZ_MAX_MATCH);
+
+			ref--;
+			while (len < max && in[ref + len] == in[i + len])
+				len++;
+
+			/* Flush the literals before the match */
+			if (!lz_literals(&op, out_end, in + literal, i - literal))
+				break;
+
+			/* Write the match */
+			if (out_end - op < 3) break;
+			if (len - 2 < 7) {
+				*op++ = (byte)(((len - 2) << 5) | (offset >> 8));
+			} else {
+				*op++ = (byte)((7 << 5) | (offset >> 8));
+				*op++ = (byte)(len - 2 - 7);
+			}
+			*op++ = (byte)(offset & 0xFF);
+
+			i += len;
+			literal = i;
+		} else {
+			i++;
+		}
+	}
+
+	/* Flush the last literals, unless we ran out of room */
+	if (i + 2 < in_len ||
+		!lz_literals(&op, out_end, in + literal, in_len - literal)) {
+		mem_free(table);
+		return 0;
+	}
+
+	mem_free(table);
+	return (u32b)(op - out);
+}
+
+/**
+ * Decompress the output of lz_compress(), which must give exactly out_len
+ * bytes
+ */
+bool lz_decompress(const byte *in, u32b in_len, byte *out, u32b out_len)
+{
+	u32b ip = 0, op = 0;
+
+	while (ip < in_len) {
+		u32b control = in[ip++];
+
+		if (control < LZ_MAX_LITERAL) {
+			u32b len = control + 1;
+
+			if (len > in_len - ip || len > out_len - op) return false;
+			memcpy(out + op, in + ip, len);
+			ip += len;
+			op += len;
+		} else {
+			u32b len = control >> 5, offset;
+
+			if (len == 7) {
+				if (ip >= in_len) return false;
+				len += in[ip++];
+			}
+			if (ip >= in_len) return false;
+			offset = ((control & 0x1F) << 8) + in[ip++] + 1;
+			len += 2;
+
+			/* The copy may overlap what it is copying */
+			if (offset > op || len > out_len - op) return false;
+			while (len--) {
+				out[op] = out[op - offset];
+				op++;
+			}
+		}
+	}
+
+	return op == out_len;
+}
+
+
 /**
  * ------------------------------------------------------------------------
  * Savefile saving functions
@@ -324,17 +550,45 @@ static bool try_save(ang_file *file)
 {
 	byte savefile_head[SAVEFILE_HEAD_SIZE];
 	size_t i, pos;
+	byte *packed = NULL;
+	u32b packed_size = 0;
 
 	/* Start off the buffer */
 	buffer = mem_alloc(BUFFER_INITIAL_SIZE);
 	buffer_size = BUFFER_INITIAL_SIZE;
 
 	for (i = 0; i < N_ELEMENTS(savers); i++) {
+		const byte *data;
+		u32b size, version = savers[i].version;
+
 		buffer_pos = 0;
 		buffer_check = 0;
 
 		savers[i].save();
 
+		data = buffer;
+		size = buffer_pos;
+
+		/* Compress larger blocks, if that makes them smaller */
+		if (buffer_pos >= BLOCK_COMPRESS_MIN) {
+			u32b len;
+
+			if (packed_size < buffer_pos) {
+				packed_size = buffer_pos;
+				packed = mem_realloc(packed, packed_size);
+			}
+			len = lz_compress(buffer, buffer_pos, packed + 4, buffer_pos - 4);
+			if (len) {
+				packed[0] = (buffer_pos & 0xFF);
+				packed[1] = ((buffer_pos >> 8) & 0xFF);
+				packed[2] = ((buffer_pos >> 16) & 0xFF);
+				packed[3] = ((buffer_pos >> 24) & 0xFF);
+				data = packed;
+				size = len + 4;
+				version |= BLOCK_COMPRESSED;
+			}
+		}
+
 		/* 16-byte block name */
 		pos = my_strcpy((char *)savefile_head,
 				savers[i].name,
@@ -348,21 +602,23 @@ static bool try_save(ang_file *file)
 		savefile_head[pos++] = ((v >> 16) & 0xFF); \
 		savefile_head[pos++] = ((v >> 24) & 0xFF);
 
-		SAVE_U32B(savers[i].version);
-		SAVE_U32B(buffer_pos);
+		SAVE_U32B(version);
+		SAVE_U32B(size);
 		SAVE_U32B(buffer_check);
 
 		assert(pos == SAVEFILE_HEAD_SIZE);
 
 		file_write(file, (char *)savefile_head, SAVEFILE_HEAD_SIZE);
-		file_write(file, (char *)buffer, buffer_pos);
+		file_write(file, (const char *)data, size);
 
 		/* pad to 4 byte multiples */
-		if (buffer_pos % 4)
-			file_write(file, "xxx", 4 - (buffer_pos % 4));
+		if (size % 4)
+			file_write(file, "xxx", 4 - (size % 4));
 	}
 
+	mem_free(packed);
 	mem_free(buffer);
+	buffer = NULL;
 
 	return true;
 }
@@ -447,15 +703,50 @@ bool savefile_save(const char *path)
  * ------------------------------------------------------------------------ */
 
 /**
- * Check the savefile header file clearly inicates that it's a savefile
+ * Read the whole of a savefile into memory
+ */
+static bool read_image(ang_file *f)
+{
+	u32b size = IMAGE_INITIAL_SIZE;
+	int n;
+
+	image = mem_alloc(size);
+	image_size = 0;
+	image_pos = 0;
+
+	while ((n = file_read(f, (char *)image + image_size,
+						 size - image_size)) > 0) {
+		image_size += n;
+		if (image_size == size) {
+			size *= 2;
+			image = mem_realloc(image, size);
+		}
+	}
+
+	return n == 0;
+}
+
+/**
+ * Let go of the savefile read by read_image()
  */
-static bool check_header(ang_file *f) {
-	byte head[8];
+static void free_image(void)
+{
+	mem_free(image);
+	image = NULL;
+	image_size = 0;
+	image_pos = 0;
+}
 
-	if (file_read(f, (char *) &head, 8) == 8 &&
-			memcmp(&head[0], savefile_magic, 4) == 0 &&
-			memcmp(&head[4], savefile_name, 4) == 0)
+/**
+ * Check the savefile header file clearly inicates that it's a savefile
+ */
+static bool check_header(void) {
+	if (image_size >= 8 &&
+			memcmp(&image[0], savefile_magic, 4) == 0 &&
+			memcmp(&image[4], savefile_name, 4) == 0) {
+		image_pos = 8;
 		return true;
+	}
 
 	return false;
 }
@@ -463,17 +754,17 @@ static bool check_header(ang_file *f) {
 /**
  * Get the next block header from the savefile
  */
-static errr next_blockheader(ang_file *f, struct blockheader *b) {
-	byte savefile_head[SAVEFILE_HEAD_SIZE];
-	size_t len;
+static errr next_blockheader(struct blockheader *b) {
+	const byte *savefile_head = image + image_pos;
 
-	len = file_read(f, (char *)savefile_head, SAVEFILE_HEAD_SIZE);
-	if (len == 0) /* no more blocks */
+	if (image_pos == image_size) /* no more blocks */
 		return 1;
 
-	if (len != SAVEFILE_HEAD_SIZE || savefile_head[15] != 0) {
+	if (image_size - image_pos < SAVEFILE_HEAD_SIZE ||
+			savefile_head[15] != 0) {
 		return -1;
 	}
+	image_pos += SAVEFILE_HEAD_SIZE;
 
 #define RECONSTRUCT_U32B(from) \
 	((u32b) savefile_head[from]) | \
@@ -481,11 +772,16 @@ static errr next_blockheader(ang_file *f, struct blockheader *b) {
 	((u32b) savefile_head[from+2] << 16) | \
 	((u32b) savefile_head[from+3] << 24);
 
-	my_strcpy(b->name, (char *)&savefile_head, sizeof b->name);
+	my_strcpy(b->name, (const char *)savefile_head, sizeof b->name);
 	b->version = RECONSTRUCT_U32B(16);
-	b->size = RECONSTRUCT_U32B(20);
+	b->data_size = RECONSTRUCT_U32B(20);
+
+	/* Compression is noted in the version */
+	b->compressed = (b->version & BLOCK_COMPRESSED) ? true : false;
+	b->version &= ~BLOCK_COMPRESSED;
 
 	/* Pad to 4 bytes */
+	b->size = b->data_size;
 	if (b->size % 4)
 		b->size += 4 - (b->size % 4);
 
@@ -512,49 +808,93 @@ static loader_t find_loader(struct blockheader *b,
 }
 
 /**
- * Load a given block with the given loader
+ * Uncompress a compressed block into its own buffer
  */
-static bool load_block(ang_file *f, struct blockheader *b, loader_t loader)
+static bool unpack_block(struct blockheader *b)
 {
-	/* Allocate space for the buffer */
-	buffer = mem_alloc(b->size);
-	buffer_pos = 0;
-	buffer_check = 0;
+	const byte *data = image + image_pos;
+	u32b size;
+
+	if (b->data_size < 4) return false;
+	size = ((u32b) data[0]) | ((u32b) data[1] << 8) |
+		((u32b) data[2] << 16) | ((u32b) data[3] << 24);
 
-	buffer_size = file_read(f, (char *) buffer, b->size);
-	if (buffer_size != b->size ||
-			loader() != 0) {
+	/* No copy in the compressed data can be more than LZ_MAX_MATCH long */
+	if (size / LZ_MAX_MATCH > b->data_size) return false;
+
+	/* Pad to 4 bytes, like an uncompressed block */
+	buffer_size = size;
+	if (buffer_size % 4)
+		buffer_size += 4 - (buffer_size % 4);
+	buffer = mem_zalloc(MAX(buffer_size, 1));
+
+	if (!lz_decompress(data + 4, b->data_size - 4, buffer, size)) {
 		mem_free(buffer);
+		buffer = NULL;
 		return false;
 	}
 
-	mem_free(buffer);
 	return true;
 }
 
+/**
+ * Load a given block with the given loader
+ */
+static bool load_block(struct blockheader *b, loader_t loader)
+{
+	bool ok;
+
+	if (b->size > image_size - image_pos)
+		return false;
+
+	/* Read uncompressed blocks straight from the savefile */
+	if (b->compressed) {
+		if (!unpack_block(b))
+			return false;
+	} else {
+		buffer = image + image_pos;
+		buffer_size = b->size;
+	}
+	buffer_pos = 0;
+	buffer_check = 0;
+
+	ok = loader() == 0;
+
+	if (b->compressed)
+		mem_free(buffer);
+	buffer = NULL;
+	image_pos += b->size;
+
+	return ok;
+}
+
 /**
  * Skip a block
  */
-static void skip_block(ang_file *f, struct blockheader *b)
+static bool skip_block(struct blockheader *b)
 {
-	file_skip(f, b->size);
+	if (b->size > image_size - image_pos)
+		return false;
+
+	image_pos += b->size;
+	return true;
 }
 
 /**
  * Try to load a savefile
  */
-static bool try_load(ang_file *f, const struct blockinfo *local_loaders)
+static bool try_load(const struct blockinfo *local_loaders)
 {
 	struct blockheader b;
 	errr err;
 
-	if (!check_header(f)) {
+	if (!check_header()) {
 		note("Savefile is corrupted -- incorrect file header.");
 		return false;
 	}
 
 	/* Get the next block header */
-	while ((err = next_blockheader(f, &b)) == 0) {
+	while ((err = next_blockheader(&b)) == 0) {
 		loader_t loader = find_loader(&b, local_loaders);
 		if (!loader) {
 			note("Savefile block can't be read.");
@@ -562,7 +902,7 @@ static bool try_load(ang_file *f, const struct blockinfo *local_loaders)
 			return false;
 		}
 
-		if (!load_block(f, &b, loader)) {
+		if (!load_block(&b, loader)) {
 			note(format("Savefile corrupted - Couldn't load block %s", b.name));
 			return false;
 		}
@@ -589,6 +929,7 @@ static int get_desc(void) {
  */
 const char *savefile_get_description(const char *path) {
 	struct blockheader b;
+	bool ok;
 
 	ang_file *f = file_open(path, MODE_READ, FTYPE_TEXT);
 	if (!f) return NULL;
@@ -596,20 +937,23 @@ const char *savefile_get_description(const char *path) {
 	/* Blank the description */
 	savefile_desc[0] = 0;
 
-	if (!check_header(f)) {
+	ok = read_image(f);
+	file_close(f);
+
+	if (!ok || !check_header()) {
 		my_strcpy(savefile_desc, "Invalid savefile", sizeof savefile_desc);
 	} else {
-		while (!next_blockheader(f, &b)) {
+		while (!next_blockheader(&b)) {
 			if (!streq(b.name, "description")) {
-				skip_block(f, &b);
+				if (!skip_block(&b)) break;
 				continue;
 			}
-			load_block(f, &b, get_desc);
+			load_block(&b, get_desc);
 			break;
 		}
 	}
 
-	file_close(f);
+	free_image();
 	return savefile_desc;
 }
 
@@ -626,8 +970,13 @@ bool savefile_load(const char *path, bool cheat_death)
 		return false;
 	}
 
-	ok = try_load(f, loaders);
+	ok = read_image(f);
 	file_close(f);
+	if (ok)
+		ok = try_load(loaders);
+	else
+		note("Couldn't read savefile.");
+	free_image();
 
 	if (player->chp < 0) {
 		player->is_dead = true;
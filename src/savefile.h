@@ -64,6 +64,9 @@ void wr_s16b(s16b v);
 void wr_u32b(u32b v);
 void wr_s32b(s32b v);
 void wr_string(const char *str);
+void wr_bytes(const byte *v, u32b n);
+u32b wr_tell(void);
+byte *wr_copy(u32b start, u32b *size);
 void pad_bytes(int n);
 
 /* Reading bits */
@@ -75,6 +78,10 @@ void rd_s32b(s32b *ip);
 void rd_string(char *str, int max);
 void strip_bytes(int n);
 
+/* Block compression */
+u32b lz_compress(const byte *in, u32b in_len, byte *out, u32b out_len);
+bool lz_decompress(const byte *in, u32b in_len, byte *out, u32b out_len);
+
 
 
 /* load.c */
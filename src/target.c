@@ -20,7 +20,9 @@
 #include "cave.h"
 #include "cmd-core.h"
 #include "game-input.h"
+#include "init.h"
 #include "mon-desc.h"
+#include "mon-make.h"
 #include "mon-util.h"
 #include "monster.h"
 #include "obj-ignore.h"
@@ -414,6 +416,18 @@ bool target_sighted(void)
 
 #define TS_INITIAL_SIZE	20
 
+/**
+ * Sort monster indices into the order a scan of the map would find them
+ */
+static int cmp_monster_grid(const void *a, const void *b)
+{
+	const struct monster *ma = cave_monster(cave, *(const s16b *)a);
+	const struct monster *mb = cave_monster(cave, *(const s16b *)b);
+
+	if (ma->fy != mb->fy) return ma->fy - mb->fy;
+	return ma->fx - mb->fx;
+}
+
 /**
  * Return a target set of target_able monsters.
  */
@@ -426,6 +440,37 @@ struct point_set *target_get_monsters(int mode)
 	/* Get the current panel */
 	get_panel(&min_y, &min_x, &max_y, &max_x);
 
+	/* Only monsters will do, so only look where they are */
+	if (mode & (TARGET_KILL)) {
+		s16b *found = cave->mon_found;
+		int i, n = mon_index_rect(cave, min_y, min_x, max_y - 1, max_x - 1,
+								  found);
+
+		sort(found, n, sizeof(*found), cmp_monster_grid);
+		for (i = 0; i < n; i++) {
+			struct monster *mon = cave_monster(cave, found[i]);
+
+			y = mon->fy;
+			x = mon->fx;
+
+			/* Check bounds */
+			if (!square_in_bounds_fully(cave, y, x)) continue;
+
+			/* Require "interesting" contents */
+			if (!target_accept(y, x)) continue;
+
+			/* Must be a targettable monster */
+			if (!target_able(mon)) continue;
+
+			/* Save the location */
+			add_to_point_set(targets, y, x);
+		}
+
+		sort(targets->pts, point_set_size(targets), sizeof(*(targets->pts)),
+			 cmp_distance);
+		return targets;
+	}
+
 	/* Scan for targets */
 	for (y = min_y; y < max_y; y++) {
 		for (x = min_x; x < max_x; x++) {
@@ -435,15 +480,6 @@ struct point_set *target_get_monsters(int mode)
 			/* Require "interesting" contents */
 			if (!target_accept(y, x)) continue;
 
-			/* Special mode */
-			if (mode & (TARGET_KILL)) {
-				/* Must contain a monster */
-				if (!(cave->squares[y][x].mon > 0)) continue;
-
-				/* Must be a targettable monster */
-			 	if (!target_able(square_monster(cave, y, x))) continue;
-			}
-
 			/* Save the location */
 			add_to_point_set(targets, y, x);
 		}
@@ -0,0 +1,128 @@
+/* game/event.c */
+
+#include "unit-test.h"
+#include "game-event.h"
+
+NOSETUP
+
+int teardown_tests(void *state) {
+	event_remove_all_handlers();
+	return 0;
+}
+
+static int calls[4];
+static int order[8];
+static int n_order;
+static int batches, batch_points;
+
+static void note_call(game_event_type type, game_event_data *data, void *user) {
+	int who = *(int *)user;
+
+	calls[who]++;
+	order[n_order++] = who;
+}
+
+static int ids[4] = { 0, 1, 2, 3 };
+
+static void remove_other(game_event_type type, game_event_data *data,
+						 void *user) {
+	note_call(type, data, user);
+	event_remove_handler(EVENT_BELL, note_call, &ids[0]);
+	event_add_handler(EVENT_BELL, note_call, &ids[3]);
+}
+
+static void note_batch(game_event_type type, game_event_data *data,
+					   void *user) {
+	batches++;
+	batch_points += data->points.count;
+}
+
+static void note_point(game_event_type type, game_event_data *data,
+					   void *user) {
+	calls[0]++;
+}
+
+int test_order(void *state) {
+	event_add_handler(EVENT_BELL, note_call, &ids[0]);
+	event_add_handler(EVENT_BELL, note_call, &ids[1]);
+	event_add_handler(EVENT_BELL, note_call, &ids[2]);
+	event_signal(EVENT_BELL);
+
+	/* Most recently added first, as before */
+	eq(n_order, 3);
+	eq(order[0], 2);
+	eq(order[1], 1);
+	eq(order[2], 0);
+
+	event_remove_handler(EVENT_BELL, note_call, &ids[1]);
+	n_order = 0;
+	event_signal(EVENT_BELL);
+	eq(n_order, 2);
+	eq(order[0], 2);
+	eq(order[1], 0);
+
+	event_remove_handler_type(EVENT_BELL);
+	n_order = 0;
+	event_signal(EVENT_BELL);
+	eq(n_order, 0);
+	ok;
+}
+
+int test_change_during_dispatch(void *state) {
+	memset(calls, 0, sizeof(calls));
+	n_order = 0;
+	event_add_handler(EVENT_BELL, note_call, &ids[0]);
+	event_add_handler(EVENT_BELL, remove_other, &ids[1]);
+	event_signal(EVENT_BELL);
+
+	/* The removed handler isn't called, the added one waits its turn */
+	eq(calls[1], 1);
+	eq(calls[0], 0);
+	eq(calls[3], 0);
+
+	event_remove_handler(EVENT_BELL, remove_other, &ids[1]);
+	event_signal(EVENT_BELL);
+	eq(calls[3], 1);
+	eq(calls[0], 0);
+
+	event_remove_handler_type(EVENT_BELL);
+	ok;
+}
+
+int test_map_points(void *state) {
+	memset(calls, 0, sizeof(calls));
+
+	/* With nothing taking batches, points go straight out */
+	event_add_handler(EVENT_MAP, note_point, NULL);
+	event_queue_map_point(3, 4);
+	eq(calls[0], 1);
+
+	/* Otherwise they are held and sent once, without repeats */
+	event_add_handler(EVENT_MAP_POINTS, note_batch, NULL);
+	event_queue_map_point(3, 4);
+	event_queue_map_point(300, 100);
+	event_queue_map_point(3, 4);
+	event_queue_map_point(5, 6);
+	eq(calls[0], 1);
+	eq(batches, 0);
+	event_flush_map_points();
+	eq(batches, 1);
+	eq(batch_points, 3);
+	event_flush_map_points();
+	eq(batches, 1);
+
+	/* Any other event sends the held points first */
+	event_queue_map_point(3, 4);
+	event_signal(EVENT_BELL);
+	eq(batches, 2);
+	eq(batch_points, 4);
+	ok;
+}
+
+const char *suite_name = "game/event";
+struct test tests[] = {
+	{ "order", test_order },
+	{ "change during dispatch", test_change_during_dispatch },
+	{ "map points", test_map_points },
+	{ NULL, NULL }
+};
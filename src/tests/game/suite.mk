@@ -1,2 +1,3 @@
 TESTPROGS += game/basic \
+	game/event \
 	game/mage
@@ -0,0 +1,211 @@
+/* monster/flow
+ *
+ * Walk the player around a level, knocking down walls and putting up
+ * rubble, and check the flow cave_update_flow() repairs after every change
+ * against distances worked out from scratch
+ */
+
+#include "unit-test.h"
+#include "unit-test-data.h"
+#include "test-utils.h"
+
+#include "cave.h"
+#include "init.h"
+#include "player.h"
+#include "z-rand.h"
+
+#define WALK_STEPS 3000
+
+/* Flow data and player grid from before the last update */
+static byte *old_cost;
+static byte *old_when;
+static int old_py, old_px;
+
+/* Distances from the player, worked out from scratch */
+static int *dist;
+static struct loc *queue;
+
+static void println(const char *str) {
+	printf("%s\n", str);
+}
+
+int setup_tests(void **state) {
+	plog_aux = println;
+	set_file_paths();
+	init_angband();
+	new_test_game(1618, 10);
+
+	old_cost = mem_zalloc(cave->height * cave->width);
+	old_when = mem_zalloc(cave->height * cave->width);
+	dist = mem_zalloc(cave->height * cave->width * sizeof(*dist));
+	queue = mem_zalloc(cave->height * cave->width * sizeof(*queue));
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	mem_free(old_cost);
+	mem_free(old_when);
+	mem_free(dist);
+	mem_free(queue);
+	cleanup_angband();
+	return 0;
+}
+
+static bool no_flow(int y, int x)
+{
+	return tf_has(f_info[cave->squares[y][x].feat].flags, TF_NO_FLOW);
+}
+
+/* Breadth-first search from the player over every grid the flow can use */
+static void find_dist(void)
+{
+	int head = 0, tail = 0;
+	int i, d;
+
+	for (i = 0; i < cave->height * cave->width; i++)
+		dist[i] = z_info->max_flow_depth;
+
+	dist[player->py * cave->width + player->px] = 0;
+	queue[tail++] = loc(player->px, player->py);
+	while (head < tail) {
+		struct loc grid = queue[head++];
+		int n = dist[grid.y * cave->width + grid.x] + 1;
+
+		if (n >= z_info->max_flow_depth) continue;
+		for (d = 0; d < 8; d++) {
+			int y = grid.y + ddy_ddd[d], x = grid.x + ddx_ddd[d];
+			if (!square_in_bounds(cave, y, x)) continue;
+			if (no_flow(y, x)) continue;
+			if (dist[y * cave->width + x] <= n) continue;
+			dist[y * cave->width + x] = n;
+			queue[tail++] = loc(x, y);
+		}
+	}
+}
+
+static void save_flow(void)
+{
+	int y, x;
+
+	old_py = player->py;
+	old_px = player->px;
+	for (y = 0; y < cave->height; y++)
+		for (x = 0; x < cave->width; x++) {
+			old_cost[y * cave->width + x] = cave->squares[y][x].cost;
+			old_when[y * cave->width + x] = cave->squares[y][x].when;
+		}
+}
+
+/*
+ * Grids in reach carry their distance and the player's stamp.  Grids the
+ * flow has just left keep their cost, and share a stamp fresher than any
+ * other scent.  Everything else is untouched, unless the stamps were cycled.
+ */
+static bool flow_matches(void)
+{
+	int now = cave->squares[player->py][player->px].when;
+	int old_now = old_when[old_py * cave->width + old_px];
+	int drop = -1, scent = 0;
+	int y, x;
+
+	find_dist();
+	for (y = 0; y < cave->height; y++)
+		for (x = 0; x < cave->width; x++) {
+			int i = y * cave->width + x;
+			int cost = cave->squares[y][x].cost;
+			int when = cave->squares[y][x].when;
+
+			if (dist[i] < z_info->max_flow_depth) {
+				if (when != now || cost != dist[i]) return false;
+				continue;
+			}
+
+			if (when == now || cost != old_cost[i]) return false;
+			if (old_when[i] && old_when[i] == old_now) {
+				if (drop >= 0 && when != drop) return false;
+				drop = when;
+			} else {
+				int cycled = (old_when[i] >= 128) ? old_when[i] - 128 : 0;
+				if (when != old_when[i] && when != cycled) return false;
+				scent = MAX(scent, when);
+			}
+		}
+
+	return (drop < 0) || (drop > scent);
+}
+
+/* Step to a random neighbouring grid, or teleport if there is none */
+static void move_player(bool teleport)
+{
+	int d, y = player->py, x = player->px;
+
+	for (d = 0; d < 20 && !teleport; d++) {
+		int dir = randint0(8);
+		y = player->py + ddy_ddd[dir];
+		x = player->px + ddx_ddd[dir];
+		if (square_in_bounds_fully(cave, y, x) &&
+			square_ispassable(cave, y, x))
+			break;
+	}
+	if (teleport || d == 20)
+		do {
+			y = randint1(cave->height - 2);
+			x = randint1(cave->width - 2);
+		} while (!square_isempty(cave, y, x));
+
+	player->py = y;
+	player->px = x;
+}
+
+/* Knock down a wall or put up rubble near the player */
+static void change_terrain(void)
+{
+	int k;
+
+	for (k = 0; k < 100; k++) {
+		int y = player->py + randint0(21) - 10;
+		int x = player->px + randint0(21) - 10;
+
+		if (!square_in_bounds_fully(cave, y, x)) continue;
+		if (y == player->py && x == player->px) continue;
+
+		if (no_flow(y, x) && !square_isperm(cave, y, x)) {
+			square_set_feat(cave, y, x, FEAT_FLOOR);
+			return;
+		}
+		if (square_isempty(cave, y, x)) {
+			square_set_feat(cave, y, x, FEAT_RUBBLE);
+			return;
+		}
+	}
+}
+
+static int test_walk(void *state) {
+	int i, k;
+
+	cave_forget_flow(cave);
+	cave_update_flow(cave);
+	save_flow();
+	require(flow_matches());
+
+	for (i = 0; i < WALK_STEPS; i++) {
+		save_flow();
+		if (one_in_(8)) {
+			/* Usually a few changes, sometimes too many to repair */
+			int n = one_in_(20) ? 50 : randint1(3);
+			for (k = 0; k < n; k++)
+				change_terrain();
+		} else {
+			move_player(one_in_(200));
+		}
+		cave_update_flow(cave);
+		require(flow_matches());
+	}
+	ok;
+}
+
+const char *suite_name = "monster/flow";
+struct test tests[] = {
+	{ "walk", test_walk },
+	{ NULL, NULL }
+};
@@ -0,0 +1,203 @@
+/* monster/index
+ *
+ * Tests for the per-region monster lists in mon-make.c
+ */
+
+#include "unit-test.h"
+#include "unit-test-data.h"
+#include "test-utils.h"
+
+#include "cave.h"
+#include "generate.h"
+#include "init.h"
+#include "mon-make.h"
+#include "mon-util.h"
+#include "monster.h"
+#include "player.h"
+#include "z-rand.h"
+
+static s16b *found;
+static s16b *expect;
+
+static void println(const char *str) {
+	printf("%s\n", str);
+}
+
+int setup_tests(void **state) {
+	plog_aux = println;
+	set_file_paths();
+	init_angband();
+	new_test_game(4242, 20);
+
+	found = mem_zalloc(z_info->level_monster_max * sizeof(*found));
+	expect = mem_zalloc(z_info->level_monster_max * sizeof(*expect));
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	mem_free(found);
+	mem_free(expect);
+	cleanup_angband();
+	return 0;
+}
+
+/* Compare the index with a full scan of the monster list */
+static bool index_matches(void)
+{
+	int i, k, n, m;
+
+	for (k = 0; k < 40; k++) {
+		int y1 = randint0(cave->height) - 5, x1 = randint0(cave->width) - 5;
+		int y2 = y1 + randint0(30), x2 = x1 + randint0(60);
+		int y = randint0(cave->height), x = randint0(cave->width);
+		int r = randint0(40);
+
+		/* Rectangles, some of them off the edge of the level */
+		n = mon_index_rect(cave, y1, x1, y2, x2, found);
+		for (m = 0, i = 1; i < cave_monster_max(cave); i++) {
+			struct monster *mon = cave_monster(cave, i);
+			if (!mon->race) continue;
+			if (mon->fy < y1 || mon->fy > y2) continue;
+			if (mon->fx < x1 || mon->fx > x2) continue;
+			expect[m++] = i;
+		}
+		if (n != m || memcmp(found, expect, n * sizeof(*found)))
+			return false;
+
+		/* Circles */
+		n = mon_index_radius(cave, y, x, r, found);
+		for (m = 0, i = 1; i < cave_monster_max(cave); i++) {
+			struct monster *mon = cave_monster(cave, i);
+			if (!mon->race) continue;
+			if (distance(y, x, mon->fy, mon->fx) > r) continue;
+			expect[m++] = i;
+		}
+		if (n != m || memcmp(found, expect, n * sizeof(*found)))
+			return false;
+	}
+
+	/* The whole level */
+	n = mon_index_rect(cave, 0, 0, cave->height - 1, cave->width - 1, found);
+	if (n != cave_monster_count(cave)) return false;
+
+	/* Light carriers */
+	for (k = mon_index_next_light(cave, 0), i = 1; i < cave_monster_max(cave);
+		 i++) {
+		struct monster *mon = cave_monster(cave, i);
+		if (!mon->race || !rf_has(mon->race->flags, RF_HAS_LIGHT)) continue;
+		if (k != i) return false;
+		k = mon_index_next_light(cave, k);
+	}
+	return k == 0;
+}
+
+/* A random live monster, or NULL if there are none */
+static struct monster *random_monster(void)
+{
+	int tries;
+
+	for (tries = 0; tries < 1000; tries++) {
+		struct monster *mon = cave_monster(cave,
+			1 + randint0(cave_monster_max(cave) - 1));
+		if (mon->race) return mon;
+	}
+	return NULL;
+}
+
+int test_place(void *state) {
+	int placed = 0, tries;
+
+	require(index_matches());
+	for (tries = 0; placed < 150 && tries < 100000; tries++) {
+		int y = randint0(cave->height), x = randint0(cave->width);
+
+		if (!square_isempty(cave, y, x)) continue;
+		if (pick_and_place_monster(cave, y, x, 20, true, false, 0)) {
+			placed++;
+			require(index_matches());
+		}
+	}
+	require(placed == 150);
+	ok;
+}
+
+int test_swap(void *state) {
+	int moves = 0, tries;
+
+	for (tries = 0; moves < 500 && tries < 100000; tries++) {
+		struct monster *mon = random_monster();
+		int y = randint0(cave->height), x = randint0(cave->width);
+
+		/* Long jumps change regions; swaps with monsters move two */
+		if (!mon) break;
+		if (!square_in_bounds_fully(cave, y, x)) continue;
+		if (!square_isempty(cave, y, x) && cave->squares[y][x].mon <= 0)
+			continue;
+		monster_swap(mon->fy, mon->fx, y, x);
+		moves++;
+		require(index_matches());
+	}
+	require(moves == 500);
+	ok;
+}
+
+int test_delete(void *state) {
+	int i;
+
+	for (i = 0; i < 40; i++) {
+		struct monster *mon = random_monster();
+
+		require(mon);
+		delete_monster_idx(mon->midx);
+		require(index_matches());
+	}
+	ok;
+}
+
+int test_compact(void *state) {
+	/* Fill the holes left by deleted monsters */
+	compact_monsters(0);
+	eq(cave_monster_max(cave), cave_monster_count(cave) + 1);
+	require(index_matches());
+
+	/* Delete some more and then compact */
+	compact_monsters(30);
+	require(index_matches());
+	ok;
+}
+
+int test_write(void *state) {
+	struct chunk *c;
+	int y, x, n, count = cave_monster_count(cave);
+
+	require(count > 0);
+
+	/* Monsters written out with the level are in the new chunk's index */
+	c = chunk_write(0, 0, cave->height, cave->width, true, false, false);
+	eq(cave_monster_count(cave), 0);
+	eq(cave_monster_count(c), count);
+	n = mon_index_rect(c, 0, 0, c->height - 1, c->width - 1, found);
+	eq(n, count);
+	for (y = 0; y < c->height; y++) {
+		for (x = 0; x < c->width; x++) {
+			int m_idx = c->squares[y][x].mon;
+
+			if (m_idx <= 0) continue;
+			eq(mon_index_rect(c, y, x, y, x, found), 1);
+			eq(found[0], m_idx);
+			eq(cave_monster(c, m_idx)->midx, m_idx);
+		}
+	}
+	cave_free(c);
+	ok;
+}
+
+const char *suite_name = "monster/index";
+struct test tests[] = {
+	{ "place", test_place },
+	{ "swap", test_swap },
+	{ "delete", test_delete },
+	{ "compact", test_compact },
+	{ "write", test_write },
+	{ NULL, NULL }
+};
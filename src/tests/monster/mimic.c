@@ -0,0 +1,120 @@
+/* monster/mimic
+ *
+ * Tests for the objects mimics pretend to be
+ */
+
+#include "unit-test.h"
+#include "unit-test-data.h"
+#include "test-utils.h"
+
+#include "cave.h"
+#include "init.h"
+#include "mon-make.h"
+#include "mon-util.h"
+#include "monster.h"
+#include "obj-make.h"
+#include "obj-pile.h"
+#include "object.h"
+#include "player.h"
+#include "z-rand.h"
+
+static void println(const char *str) {
+	printf("%s\n", str);
+}
+
+int setup_tests(void **state) {
+	plog_aux = println;
+	set_file_paths();
+	init_angband();
+	new_test_game(1729, 10);
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	cleanup_angband();
+	return 0;
+}
+
+/* Pick an empty floor grid well inside the level */
+static void find_empty(int *y, int *x)
+{
+	do {
+		*y = randint1(cave->height - 2);
+		*x = randint1(cave->width - 2);
+	} while (!square_isempty(cave, *y, *x));
+}
+
+/* Place a mimic of copper coins, returning its index */
+static int place_mimic(int y, int x)
+{
+	struct monster_race *race = lookup_monster("Creeping copper coins");
+
+	if (!place_new_monster(cave, y, x, race, true, false, ORIGIN_FLOOR))
+		return 0;
+	return cave->squares[y][x].mon;
+}
+
+/* A mimic placed on a pile of the coins it mimics keeps its own object */
+static int test_place_on_pile(void *state) {
+	struct object *gold = make_gold(10, "copper");
+	struct monster *mon;
+	int y, x;
+
+	find_empty(&y, &x);
+	require(floor_carry(cave, y, x, gold, false));
+	mon = cave_monster(cave, place_mimic(y, x));
+	require(mon->race);
+	require(mon->mimicked_obj);
+	require(mon->mimicked_obj != gold);
+	require(pile_contains(square_object(cave, y, x), mon->mimicked_obj));
+	eq(mon->mimicked_obj->mimicking_m_idx, mon->midx);
+	ok;
+}
+
+/* Deleting a mimic that has been moved takes its object off the old grid */
+static int test_delete_moved(void *state) {
+	struct monster *mon;
+	int y1, x1, y2, x2;
+
+	find_empty(&y1, &x1);
+	mon = cave_monster(cave, place_mimic(y1, x1));
+	require(mon->mimicked_obj);
+	find_empty(&y2, &x2);
+	monster_swap(y1, x1, y2, x2);
+	eq(mon->fy, y2);
+	eq(mon->fx, x2);
+
+	delete_monster_idx(mon->midx);
+	null(square_object(cave, y1, x1));
+	null(square_object(cave, y2, x2));
+	ok;
+}
+
+/* A dead mimic's object is gone from the floor, not just freed */
+static int test_death(void *state) {
+	struct monster *mon;
+	struct object *obj, *mimicked;
+	int y, x;
+
+	find_empty(&y, &x);
+	mon = cave_monster(cave, place_mimic(y, x));
+	mimicked = mon->mimicked_obj;
+	require(mimicked);
+
+	monster_death(mon, false);
+	null(mon->mimicked_obj);
+	for (obj = square_object(cave, y, x); obj; obj = obj->next) {
+		require(obj != mimicked);
+		eq(obj->mimicking_m_idx, 0);
+	}
+	delete_monster_idx(mon->midx);
+	ok;
+}
+
+const char *suite_name = "monster/mimic";
+struct test tests[] = {
+	{ "place_on_pile", test_place_on_pile },
+	{ "delete_moved", test_delete_moved },
+	{ "death", test_death },
+	{ NULL, NULL }
+};
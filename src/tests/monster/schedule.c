@@ -0,0 +1,345 @@
+/* monster/schedule
+ *
+ * Check the order process_monsters() visits monsters in against a full
+ * reverse sweep of the monster list, and replay a game with each of them
+ */
+
+#include "unit-test.h"
+#include "unit-test-data.h"
+#include "test-utils.h"
+
+#include "cave.h"
+#include "game-world.h"
+#include "init.h"
+#include "mon-make.h"
+#include "mon-move.h"
+#include "mon-util.h"
+#include "monster.h"
+#include "player.h"
+#include "player-timed.h"
+#include "z-rand.h"
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define MAX_TAGS 2000
+#define REPLAY_TURNS 1000
+#define MAX_STEPS (REPLAY_TURNS * 4)
+
+/* Which monsters the reference sweep has handled, by tag */
+static bool ref_handled[MAX_TAGS];
+static int next_tag = 1;
+
+static void println(const char *str) {
+	printf("%s\n", str);
+}
+
+int setup_tests(void **state) {
+	plog_aux = println;
+	set_file_paths();
+	init_angband();
+	new_test_game(2718, 15);
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	cleanup_angband();
+	return 0;
+}
+
+/*
+ * Nothing here processes the monsters, so their hitpoints can carry a tag
+ * that goes wherever the monster does when the list is compacted
+ */
+static void tag_monster(struct monster *mon)
+{
+	mon->hp = next_tag++;
+}
+
+/* The next monster a full reverse sweep from m_idx would visit */
+static int ref_prev(int m_idx)
+{
+	int i;
+
+	for (i = m_idx - 1; i >= 1; i--) {
+		struct monster *mon = cave_monster(cave, i);
+		if (mon->race && !ref_handled[mon->hp]) return i;
+	}
+	return 0;
+}
+
+static bool place_random_monster(void)
+{
+	int tries;
+
+	for (tries = 0; tries < 1000; tries++) {
+		int y = randint0(cave->height), x = randint0(cave->width);
+
+		if (!square_isempty(cave, y, x)) continue;
+		if (pick_and_place_monster(cave, y, x, 15, true, false, 0)) {
+			tag_monster(cave_monster(cave, cave->squares[y][x].mon));
+			return true;
+		}
+	}
+	return false;
+}
+
+static struct monster *random_monster(void)
+{
+	int tries;
+
+	for (tries = 0; tries < 1000; tries++) {
+		struct monster *mon = cave_monster(cave,
+			1 + randint0(cave_monster_max(cave) - 1));
+		if (mon->race) return mon;
+	}
+	return NULL;
+}
+
+/*
+ * Walk the turn order the way process_monsters() does, checking each step
+ * against the reference, while monsters come and go and the list is
+ * compacted under it
+ */
+static bool sweep_matches(int *visited)
+{
+	int i = cave_monster_max(cave);
+
+	while (true) {
+		int next = mon_schedule_prev(cave, i);
+		struct monster *mon;
+
+		if (next != ref_prev(i)) return false;
+		if (!next) break;
+
+		i = next;
+		mon = cave_monster(cave, i);
+		mon_schedule_done(cave, mon);
+		ref_handled[mon->hp] = true;
+		(*visited)++;
+
+		switch (randint0(10)) {
+			case 0: {
+				if (!place_random_monster()) return false;
+				break;
+			}
+			case 1: {
+				struct monster *victim = random_monster();
+				if (victim) delete_monster_idx(victim->midx);
+				break;
+			}
+			case 2: {
+				compact_monsters(0);
+				break;
+			}
+			case 3: {
+				if (one_in_(5)) compact_monsters(5);
+				break;
+			}
+			default: break;
+		}
+	}
+
+	/* The same monsters have had their turn, leaving out those placed
+	 * behind the sweep */
+	for (i = 1; i < cave_monster_max(cave); i++) {
+		struct monster *mon = cave_monster(cave, i);
+		if (mon->race && mon_is_handled(cave, i) != ref_handled[mon->hp])
+			return false;
+	}
+
+	reset_monsters();
+	memset(ref_handled, 0, sizeof(ref_handled));
+	return true;
+}
+
+int test_sweeps(void *state) {
+	int i;
+
+	/* Fix the stream, so the same monsters come and go on every run */
+	rng_state_init(Rand_context(), 1066);
+
+	/* Tag everyone already on the level, and add some more */
+	for (i = 1; i < cave_monster_max(cave); i++)
+		if (cave_monster(cave, i)->race)
+			tag_monster(cave_monster(cave, i));
+	for (i = 0; i < 100; i++)
+		require(place_random_monster());
+
+	/* Every sweep follows the reference order and reaches someone */
+	for (i = 0; i < 20; i++) {
+		int visited = 0;
+
+		require(next_tag < MAX_TAGS - 100);
+		require(sweep_matches(&visited));
+		require(visited > 0);
+	}
+	ok;
+}
+
+int test_process(void *state) {
+	const struct monster_race **present;
+	int i, t;
+
+	present = mem_zalloc(z_info->level_monster_max * sizeof(*present));
+	for (t = 0; t < 100; t++) {
+		int max = cave_monster_max(cave);
+
+		/* Keep the player around to be chased */
+		player->chp = player->mhp;
+		(void)player_inc_timed(player, TMD_INVULN, 10, false, false);
+
+		for (i = 1; i < max; i++)
+			present[i] = cave_monster(cave, i)->race;
+
+		turn++;
+		process_monsters(cave, 0);
+		if (player->is_dead || player->upkeep->generate_level) break;
+
+		/* Everyone who was there at the start has been visited */
+		for (i = 1; i < max; i++) {
+			struct monster *mon = cave_monster(cave, i);
+			if (mon->race && mon->race == present[i])
+				require(mon_is_handled(cave, i));
+		}
+
+		/* ...and is waiting again after the reset */
+		reset_monsters();
+		for (i = 1; i < cave_monster_max(cave); i++)
+			require(!mon_is_handled(cave, i));
+	}
+	mem_free(present);
+	require(t > 10);
+	ok;
+}
+
+/*
+ * The loop process_monsters() used to be: every slot of the monster list,
+ * from the top down, with no bound on who might have the energy to move
+ */
+static void ref_process_monsters(struct chunk *c, int minimum_energy)
+{
+	int i;
+
+	for (i = cave_monster_max(c) - 1; i >= 1; i--) {
+		struct monster *mon = cave_monster(c, i);
+
+		if (player->is_dead || player->upkeep->generate_level) break;
+		if (!mon->race || mon_is_handled(c, i)) continue;
+		if (mon->energy < minimum_energy) continue;
+		process_monster_turn(c, mon);
+	}
+	player->upkeep->update |= PU_MONSTERS;
+}
+
+static u32b hash_add(u32b h, u32b value)
+{
+	return (h ^ value) * 16777619U;
+}
+
+/* Everything about the monsters and the random numbers that a turn moves */
+static u32b replay_hash(void)
+{
+	struct rng_state *rng = Rand_context();
+	u32b h = 2166136261U;
+	int i;
+
+	for (i = 1; i < cave_monster_max(cave); i++) {
+		struct monster *mon = cave_monster(cave, i);
+
+		if (!mon->race) continue;
+		h = hash_add(h, i);
+		h = hash_add(h, mon->race->ridx);
+		h = hash_add(h, (mon->fy << 16) | mon->fx);
+		h = hash_add(h, (mon->energy << 16) | mon_is_handled(cave, i));
+		h = hash_add(h, mon->hp);
+	}
+	h = hash_add(h, rng->state_i);
+	for (i = 0; i < RAND_DEG; i++)
+		h = hash_add(h, rng->state[i]);
+	h = hash_add(h, player->chp);
+	return h;
+}
+
+/*
+ * Play out game turns the way run_game_loop() does, with a player who only
+ * ever holds, noting the state after every call to process_monsters()
+ */
+static int replay(void (*process)(struct chunk *c, int minimum_energy),
+				  u32b *steps)
+{
+	int t, n = 0;
+
+	for (t = 0; t < REPLAY_TURNS && n < MAX_STEPS - 8; t++) {
+		player->chp = player->mhp;
+		(void)player_inc_timed(player, TMD_INVULN, 10, false, false);
+
+		while (player->energy >= z_info->move_energy) {
+			process(cave, player->energy + 1);
+			steps[n++] = replay_hash();
+			player->energy -= z_info->move_energy;
+		}
+		process(cave, 0);
+		steps[n++] = replay_hash();
+		if (player->is_dead || player->upkeep->generate_level) break;
+
+		reset_monsters();
+		player->energy += turn_energy(player->state.speed);
+		turn++;
+	}
+	return n;
+}
+
+int test_replay(void *state) {
+	static u32b ref_steps[MAX_STEPS], new_steps[MAX_STEPS];
+	int fds[2], status, i, ref_n, new_n = 0;
+	ssize_t got, len;
+	pid_t pid;
+
+	/* Plenty of monsters, all in their places at the start of a turn */
+	for (i = 0; i < 100; i++)
+		require(place_random_monster());
+	reset_monsters();
+
+	/* A copy of the game plays with the new loop and reports back */
+	require(pipe(fds) == 0);
+	pid = fork();
+	require(pid >= 0);
+	if (pid == 0) {
+		close(fds[0]);
+		new_n = replay(process_monsters, new_steps);
+		len = new_n * sizeof(u32b);
+		if (write(fds[1], &new_n, sizeof(new_n)) != sizeof(new_n) ||
+			write(fds[1], new_steps, len) != len)
+			_exit(1);
+		_exit(0);
+	}
+	close(fds[1]);
+
+	/* Meanwhile this one plays from the same state with the old loop */
+	ref_n = replay(ref_process_monsters, ref_steps);
+
+	got = read(fds[0], &new_n, sizeof(new_n));
+	for (len = 0; got > 0 && len < (ssize_t)(new_n * sizeof(u32b));
+		 len += got)
+		got = read(fds[0], (char *)new_steps + len,
+				   new_n * sizeof(u32b) - len);
+	close(fds[0]);
+	require(waitpid(pid, &status, 0) == pid);
+	require(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+	/* Every step went the same way */
+	require(ref_n > REPLAY_TURNS / 2);
+	eq(new_n, ref_n);
+	for (i = 0; i < ref_n; i++)
+		eq(new_steps[i], ref_steps[i]);
+	ok;
+}
+
+const char *suite_name = "monster/schedule";
+struct test tests[] = {
+	{ "sweeps", test_sweeps },
+	{ "process", test_process },
+	{ "replay", test_replay },
+	{ NULL, NULL }
+};
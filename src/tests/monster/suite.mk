@@ -1 +1 @@
-TESTPROGS += monster/attack monster/monster
+TESTPROGS += monster/attack monster/flow monster/index monster/mimic monster/monster monster/schedule
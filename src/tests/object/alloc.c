@@ -0,0 +1,123 @@
+/* object/alloc
+ *
+ * Check that picking object kinds by binary search of running totals gives
+ * the same kinds as walking the allocation table did
+ */
+
+#include "unit-test.h"
+#include "unit-test-data.h"
+#include "test-utils.h"
+
+#include "init.h"
+#include "obj-make.h"
+#include "obj-tval.h"
+#include "obj-util.h"
+#include "object.h"
+#include "z-rand.h"
+
+static void println(const char *str) {
+	printf("%s\n", str);
+}
+
+int setup_tests(void **state) {
+	plog_aux = println;
+	set_file_paths();
+	init_angband();
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	cleanup_angband();
+	return 0;
+}
+
+/* An entry of the allocation table, as init_obj_make() makes it */
+static int alloc_rarity(int kidx, int level, bool good)
+{
+	const struct object_kind *kind = &k_info[kidx];
+
+	if (level < kind->alloc_min || level > kind->alloc_max) return 0;
+	if (good && !kind_is_good(kind)) return 0;
+	return (byte)kind->alloc_prob;
+}
+
+/* get_obj_num() walking the table, as it used to */
+static struct object_kind *linear_obj_num(int level, bool good, int tval)
+{
+	int item;
+	u32b value, total = 0;
+
+	if ((level > 0) && one_in_(z_info->great_obj))
+		level = 1 + (level * z_info->max_obj_depth /
+					 randint1(z_info->max_obj_depth));
+	level = MIN(level, z_info->max_obj_depth);
+	level = MAX(level, 0);
+
+	for (item = 1; item < z_info->k_max; item++)
+		if (!tval || k_info[item].tval == tval)
+			total += alloc_rarity(item, level, good);
+	if (!total) return tval ? NULL : objkind_byid(z_info->k_max);
+
+	value = randint0(total);
+	for (item = 1; item < z_info->k_max; item++) {
+		if (tval && k_info[item].tval != tval) continue;
+		if (value < (u32b)alloc_rarity(item, level, good)) break;
+		value -= alloc_rarity(item, level, good);
+	}
+
+	return objkind_byid(item);
+}
+
+/* Pick the same way with the same random numbers */
+static bool picks_match(u32b seed, int level, bool good, int tval)
+{
+	struct rng_state rng, *old;
+	struct object_kind *kind;
+	bool match;
+
+	rng_state_init(&rng, seed);
+	old = Rand_set_context(&rng);
+	kind = get_obj_num(level, good, tval);
+	rng_state_init(&rng, seed);
+	match = kind == linear_obj_num(level, good, tval);
+	Rand_set_context(old);
+	return match;
+}
+
+int test_any_kind(void *state) {
+	int levels[] = { 0, 1, 5, 15, 30, 50, 75, 100 };
+	size_t i;
+	u32b seed;
+
+	for (i = 0; i < N_ELEMENTS(levels); i++) {
+		for (seed = 1; seed <= 500; seed++) {
+			require(picks_match(seed, levels[i], false, 0));
+			require(picks_match(seed, levels[i], true, 0));
+		}
+	}
+	ok;
+}
+
+int test_by_tval(void *state) {
+	int levels[] = { 0, 10, 40, 100 };
+	size_t i;
+	int tval;
+	u32b seed;
+
+	for (i = 0; i < N_ELEMENTS(levels); i++) {
+		for (tval = 1; tval < TV_MAX; tval++) {
+			for (seed = 1; seed <= 50; seed++) {
+				require(picks_match(seed, levels[i], false, tval));
+				require(picks_match(seed, levels[i], true, tval));
+			}
+		}
+	}
+	ok;
+}
+
+const char *suite_name = "object/alloc";
+struct test tests[] = {
+	{ "any-kind", test_any_kind },
+	{ "by-tval", test_by_tval },
+	{ NULL, NULL }
+};
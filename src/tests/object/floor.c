@@ -0,0 +1,132 @@
+/* object/floor
+ *
+ * Tests for objects dropped onto, and seen on, the floor of a level
+ */
+
+#include "unit-test.h"
+#include "unit-test-data.h"
+#include "test-utils.h"
+
+#include "cave.h"
+#include "init.h"
+#include "message.h"
+#include "obj-make.h"
+#include "obj-pile.h"
+#include "obj-util.h"
+#include "object.h"
+#include "player.h"
+#include "player-util.h"
+#include "z-rand.h"
+
+static void println(const char *str) {
+	printf("%s\n", str);
+}
+
+int setup_tests(void **state) {
+	plog_aux = println;
+	set_file_paths();
+	init_angband();
+	new_test_game(2718, 10);
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	cleanup_angband();
+	return 0;
+}
+
+/* Pick an empty floor grid well inside the level */
+static void find_empty(int *y, int *x)
+{
+	do {
+		*y = randint1(cave->height - 2);
+		*x = randint1(cave->width - 2);
+	} while (!square_isempty(cave, *y, *x));
+}
+
+static struct object *make_flasks(int number)
+{
+	struct object *obj = object_new();
+
+	object_prep(obj, lookup_kind(TV_FLASK, lookup_sval(TV_FLASK, "Flask of oil")),
+				0, RANDOMISE);
+	obj->number = number;
+	return obj;
+}
+
+/* Dropping onto a matching pile under the player absorbs the drop */
+static int test_drop_absorbed(void *state) {
+	struct object *pile = make_flasks(2);
+	int y, x;
+	u16b n;
+
+	find_empty(&y, &x);
+	player_place(cave, player, y, x);
+	require(floor_carry(cave, y, x, pile, false));
+
+	n = messages_num();
+	drop_near(cave, make_flasks(3), 0, y, x, true);
+	ptreq(square_object(cave, y, x), pile);
+	null(pile->next);
+	eq(pile->number, 5);
+	eq(messages_num(), n + 1);
+	require(streq(message_str(0), "You feel something roll beneath your feet."));
+	ok;
+}
+
+/* An artifact walled in at the edge of the level bounces to a floor grid */
+static int test_drop_walled_artifact(void *state) {
+	struct artifact *art = &a_info[1];
+	struct object *obj;
+	int y, x, k;
+
+	for (y = 1; y < 6; y++)
+		for (x = 1; x < 6; x++)
+			square_set_feat(cave, y, x, FEAT_GRANITE);
+
+	for (k = 0; k < 50; k++) {
+		obj = object_new();
+		object_prep(obj, lookup_kind(art->tval, art->sval), 0, RANDOMISE);
+		obj->artifact = art;
+		drop_near(cave, obj, 0, 1, 1, false);
+		require(square_in_bounds_fully(cave, obj->iy, obj->ix));
+		require(square_isfloor(cave, obj->iy, obj->ix));
+		require(pile_contains(square_object(cave, obj->iy, obj->ix), obj));
+
+		square_excise_object(cave, obj->iy, obj->ix, obj);
+		delist_object(cave, obj);
+		object_delete(&obj);
+	}
+	ok;
+}
+
+/* Lighting up a chunk other than the current level leaves the level alone */
+static int test_wiz_light_other_chunk(void *state) {
+	struct chunk *c = cave_new(cave->height, cave->width);
+	int y, x;
+
+	for (y = 0; y < c->height; y++)
+		for (x = 0; x < c->width; x++) {
+			bool edge = !y || !x || y == c->height - 1 || x == c->width - 1;
+			square_set_feat(c, y, x, edge ? FEAT_PERM : FEAT_FLOOR);
+		}
+	wiz_light(c, false);
+
+	for (y = 0; y < cave->height; y++)
+		for (x = 0; x < cave->width; x++)
+			require(!square_ismark(cave, y, x));
+	for (y = 1; y < c->height - 1; y++)
+		for (x = 1; x < c->width - 1; x++)
+			require(square_isglow(c, y, x));
+
+	cave_free(c);
+	ok;
+}
+
+const char *suite_name = "object/floor";
+struct test tests[] = {
+	{ "drop_absorbed", test_drop_absorbed },
+	{ "drop_walled_artifact", test_drop_walled_artifact },
+	{ "wiz_light_other_chunk", test_wiz_light_other_chunk },
+	{ NULL, NULL }
+};
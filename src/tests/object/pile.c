@@ -5,8 +5,10 @@
 #include "unit-test.h"
 #include "unit-test-data.h"
 
+#include "cave.h"
 #include "object.h"
 #include "obj-pile.h"
+#include "z-rand.h"
 
 int setup_tests(void **state) {
 	return 0;
@@ -90,8 +92,50 @@ int test_obj_piles(void *state) {
 	ok;
 }
 
+/* Objects should always be listed in the lowest free slot */
+int test_obj_list(void *state) {
+	struct chunk c;
+	struct object *objs[400];
+	int i, j, n;
+
+	memset(&c, 0, sizeof(c));
+	c.objects = mem_zalloc(OBJECT_LIST_SIZE * sizeof(struct object*));
+	c.obj_max = OBJECT_LIST_SIZE - 1;
+	for (i = 0; i < 400; i++)
+		objs[i] = object_new();
+
+	Rand_init();
+	for (n = 0; n < 20000; n++) {
+		struct object *obj = objs[randint0(400)];
+
+		if (obj->oidx) {
+			delist_object(&c, obj);
+			eq(obj->oidx, 0);
+			continue;
+		}
+
+		for (j = 1; j < c.obj_max; j++)
+			if (!c.objects[j]) break;
+		list_object(&c, obj);
+		eq(obj->oidx, j);
+		ptreq(c.objects[j], obj);
+
+		/* Listing again changes nothing */
+		list_object(&c, obj);
+		eq(obj->oidx, j);
+	}
+	require(c.obj_max > OBJECT_LIST_SIZE - 1);
+
+	for (i = 0; i < 400; i++)
+		mem_free(objs[i]);
+	mem_free(c.objects);
+	mem_free(c.obj_free);
+	ok;
+}
+
 const char *suite_name = "object/pile";
 struct test tests[] = {
 	{ "pile checking", test_obj_piles },
+	{ "object list slots", test_obj_list },
 	{ NULL, NULL }
 };
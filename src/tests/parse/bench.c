@@ -0,0 +1,105 @@
+/* parse/bench
+ *
+ * Time the parsers init_angband() runs over the game data files
+ */
+
+#include "unit-test.h"
+#include "test-utils.h"
+
+#include <time.h>
+#include "init.h"
+#include "mon-init.h"
+#include "parser.h"
+#include "store.h"
+
+static struct parser *init_parse_mon_spell(void) {
+	return mon_spell_parser.init();
+}
+
+static struct parser *init_parse_mon_base(void) {
+	return mon_base_parser.init();
+}
+
+/**
+ * The game data files parsed at startup, each with the function that makes
+ * its parser and registers every directive the file may use
+ */
+static const struct {
+	const char *name;
+	struct parser *(*init)(void);
+} bench_files[] = {
+	{ "constants", init_parse_constants },
+	{ "trap", init_parse_trap },
+	{ "terrain", init_parse_feat },
+	{ "object_base", init_parse_object_base },
+	{ "object", init_parse_object },
+	{ "activation", init_parse_act },
+	{ "ego_item", init_parse_ego },
+	{ "artifact", init_parse_artifact },
+	{ "pain", init_parse_pain },
+	{ "monster_spell", init_parse_mon_spell },
+	{ "monster_base", init_parse_mon_base },
+	{ "monster", init_parse_monster },
+	{ "pit", init_parse_pit },
+	{ "quest", init_parse_quest },
+	{ "history", init_parse_history },
+	{ "body", init_parse_body },
+	{ "p_race", init_parse_p_race },
+	{ "class", init_parse_class },
+	{ "flavor", init_parse_flavor },
+	{ "hints", init_parse_hints },
+	{ "names", init_parse_names },
+	{ "vault", init_parse_vault },
+	{ "store", init_parse_stores },
+};
+
+#define BENCH_REPEATS 10
+
+int setup_tests(void **state) {
+	set_file_paths();
+	init_angband();
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	cleanup_angband();
+	return 0;
+}
+
+/*
+ * Parse all of the game data files a number of times.  The hooks look up
+ * things such as object kinds and monster bases, so this runs after
+ * init_angband(), and the records each pass builds are thrown away.
+ */
+int test_bench(void *state) {
+	unsigned int lines = 0;
+	clock_t start;
+	size_t i;
+	int rep;
+
+	start = clock();
+	for (rep = 0; rep < BENCH_REPEATS; rep++) {
+		lines = 0;
+		for (i = 0; i < N_ELEMENTS(bench_files); i++) {
+			struct parser *p = bench_files[i].init();
+			struct parser_state s;
+
+			require(p);
+			eq(parse_file(p, bench_files[i].name), PARSE_ERROR_NONE);
+			parser_getstate(p, &s);
+			lines += s.line;
+			parser_destroy(p);
+		}
+	}
+
+	if (verbose)
+		printf("(%u lines x %d in %.3fs) ", lines, BENCH_REPEATS,
+			   (double)(clock() - start) / CLOCKS_PER_SEC);
+	ok;
+}
+
+const char *suite_name = "parse/bench";
+struct test tests[] = {
+	{ "bench", test_bench },
+	{ NULL, NULL }
+};
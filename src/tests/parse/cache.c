@@ -0,0 +1,597 @@
+/* parse/cache */
+
+#include "unit-test.h"
+#include "test-utils.h"
+
+#include "generate.h"
+#include "init.h"
+#include "monster.h"
+#include "obj-slays.h"
+#include "obj-tval.h"
+#include "object.h"
+#include "parser.h"
+#include "player-spell.h"
+#include "z-expression.h"
+#include "z-file.h"
+
+#include <unistd.h>
+
+extern struct init_module generate_module;
+
+static const char *room_sources[] = { "room_template", NULL };
+static const char *vault_sources[] = { "vault", "constants", NULL };
+
+/* Copies of the lists from a fresh parse */
+static struct room_template *parsed_rooms;
+static struct vault *parsed_vaults;
+
+/* The object, activation, ego item, artifact and monster caches */
+static const char *table_caches[] = { "object", "activation", "ego_item",
+									  "artifact", "monster" };
+static const char *table_sources[][6] = {
+	{ "object", NULL },
+	{ "activation", NULL },
+	{ "ego_item", "object", NULL },
+	{ "artifact", "object", "activation", NULL },
+	{ "monster", "monster_base", "object", "artifact", "constants", NULL },
+};
+
+/* A digest of the tables from a fresh parse */
+static u32b parsed_tables;
+
+static u32b digest;
+
+static void add_mem(const void *data, size_t len) {
+	const byte *b = data;
+	size_t i;
+
+	for (i = 0; i < len; i++)
+		digest = digest * 33 + b[i];
+}
+
+static void add_int(long v) {
+	add_mem(&v, sizeof(v));
+}
+
+static void add_str(const char *s) {
+	if (s)
+		add_mem(s, strlen(s) + 1);
+	else
+		add_int(-1);
+}
+
+static void add_rand(random_value v) {
+	add_int(v.base);
+	add_int(v.dice);
+	add_int(v.sides);
+	add_int(v.m_bonus);
+}
+
+static void add_el_info(struct element_info *el_info) {
+	int i;
+
+	for (i = 0; i < ELEM_MAX; i++) {
+		add_int(el_info[i].res_level);
+		add_int(el_info[i].flags);
+	}
+}
+
+static void add_brands(struct brand *b) {
+	for (; b; b = b->next) {
+		add_str(b->name);
+		add_int(b->element);
+		add_int(b->multiplier);
+	}
+	add_int(-1);
+}
+
+static void add_slays(struct slay *s) {
+	for (; s; s = s->next) {
+		add_str(s->name);
+		add_int(s->race_flag);
+		add_int(s->multiplier);
+	}
+	add_int(-1);
+}
+
+static void add_effects(struct effect *e) {
+	char buf[80];
+	int i;
+
+	for (; e; e = e->next) {
+		const expression_t *expression;
+		const char *name;
+
+		add_int(e->index);
+		add_mem(e->params, sizeof(e->params));
+		if (!e->dice) {
+			add_int(-1);
+			continue;
+		}
+		if (dice_to_string(e->dice, buf, sizeof(buf)))
+			add_str(buf);
+		for (i = 0; (name = dice_variable(e->dice, i, &expression)); i++) {
+			add_str(name);
+			if (!expression)
+				continue;
+			add_str(spell_value_base_name(
+						expression_get_base_value(expression)));
+			if (expression_to_string(expression, buf, sizeof(buf)))
+				add_str(buf);
+		}
+	}
+	add_int(-1);
+}
+
+/**
+ * Digest everything the object, activation, ego item, artifact and monster
+ * parsers set up, with pointers into other tables taken as indices or names
+ */
+static u32b digest_tables(void) {
+	struct brand *b;
+	struct slay *s;
+	int i, j;
+
+	digest = 5381;
+
+	for (i = 0; i < TV_MAX; i++)
+		add_int(kb_info[i].num_svals);
+	for (b = game_brands; b; b = b->next) {
+		add_str(b->name);
+		add_int(b->element);
+	}
+	for (s = game_slays; s; s = s->next) {
+		add_str(s->name);
+		add_int(s->race_flag);
+	}
+
+	add_int(z_info->k_max);
+	for (i = 0; i < z_info->k_max; i++) {
+		struct object_kind *k = &k_info[i];
+
+		add_str(k->name);
+		add_str(k->text);
+		add_int(k->base ? k->base - kb_info : -1);
+		add_int(k->kidx);
+		add_int(k->tval);
+		add_int(k->sval);
+		add_rand(k->pval);
+		add_rand(k->to_h);
+		add_rand(k->to_d);
+		add_rand(k->to_a);
+		add_int(k->ac);
+		add_int(k->dd);
+		add_int(k->ds);
+		add_int(k->weight);
+		add_int(k->cost);
+		add_mem(k->flags, sizeof(k->flags));
+		add_mem(k->kind_flags, sizeof(k->kind_flags));
+		for (j = 0; j < OBJ_MOD_MAX; j++)
+			add_rand(k->modifiers[j]);
+		add_el_info(k->el_info);
+		add_brands(k->brands);
+		add_slays(k->slays);
+		add_int(k->d_attr);
+		add_int(k->d_char);
+		add_int(k->alloc_prob);
+		add_int(k->alloc_min);
+		add_int(k->alloc_max);
+		add_int(k->level);
+		add_effects(k->effect);
+		add_int(k->power);
+		add_str(k->effect_msg);
+		add_rand(k->time);
+		add_rand(k->charge);
+		add_int(k->gen_mult_prob);
+		add_rand(k->stack_size);
+	}
+
+	add_int(z_info->act_max);
+	for (i = 0; i < z_info->act_max; i++) {
+		struct activation *act = &activations[i];
+
+		add_str(act->name);
+		add_int(act->next ? act->next->index : -1);
+		add_int(act->index);
+		add_int(act->aim);
+		add_int(act->power);
+		add_effects(act->effect);
+		add_str(act->message);
+		add_str(act->desc);
+	}
+
+	add_int(z_info->e_max);
+	for (i = 0; i < z_info->e_max; i++) {
+		struct ego_item *e = &e_info[i];
+		struct ego_poss_item *poss;
+
+		add_str(e->name);
+		add_str(e->text);
+		add_int(e->next ? (long)e->next->eidx : -1);
+		add_int(e->eidx);
+		add_int(e->cost);
+		add_mem(e->flags, sizeof(e->flags));
+		add_mem(e->flags_off, sizeof(e->flags_off));
+		add_mem(e->kind_flags, sizeof(e->kind_flags));
+		for (j = 0; j < OBJ_MOD_MAX; j++) {
+			add_rand(e->modifiers[j]);
+			add_int(e->min_modifiers[j]);
+		}
+		add_el_info(e->el_info);
+		add_brands(e->brands);
+		add_slays(e->slays);
+		add_int(e->level);
+		add_int(e->rarity);
+		add_int(e->rating);
+		add_int(e->alloc_prob);
+		add_int(e->alloc_min);
+		add_int(e->alloc_max);
+		for (poss = e->poss_items; poss; poss = poss->next)
+			add_int(poss->kidx);
+		add_rand(e->to_h);
+		add_rand(e->to_d);
+		add_rand(e->to_a);
+		add_int(e->min_to_h);
+		add_int(e->min_to_d);
+		add_int(e->min_to_a);
+		add_effects(e->effect);
+		add_str(e->effect_msg);
+		add_rand(e->time);
+	}
+
+	add_int(z_info->a_max);
+	for (i = 0; i < z_info->a_max; i++) {
+		struct artifact *a = &a_info[i];
+
+		add_str(a->name);
+		add_str(a->text);
+		add_int(a->next ? (long)a->next->aidx : -1);
+		add_int(a->aidx);
+		add_int(a->tval);
+		add_int(a->sval);
+		add_int(a->to_h);
+		add_int(a->to_d);
+		add_int(a->to_a);
+		add_int(a->ac);
+		add_int(a->dd);
+		add_int(a->ds);
+		add_int(a->weight);
+		add_int(a->cost);
+		add_mem(a->flags, sizeof(a->flags));
+		add_mem(a->modifiers, sizeof(a->modifiers));
+		add_el_info(a->el_info);
+		add_brands(a->brands);
+		add_slays(a->slays);
+		add_int(a->level);
+		add_int(a->alloc_prob);
+		add_int(a->alloc_min);
+		add_int(a->alloc_max);
+		add_int(a->activation ? a->activation->index : -1);
+		add_str(a->alt_msg);
+		add_rand(a->time);
+	}
+
+	add_int(z_info->r_max);
+	add_int(z_info->mon_blows_max);
+	for (i = 0; i < z_info->r_max; i++) {
+		struct monster_race *r = &r_info[i];
+		struct monster_drop *d;
+		struct monster_friends *f;
+		struct monster_friends_base *fb;
+		struct monster_mimic *m;
+
+		add_int(r->next ? (long)r->next->ridx : -1);
+		add_int(r->ridx);
+		add_str(r->name);
+		add_str(r->text);
+		add_str(r->plural);
+		add_str(r->base ? r->base->name : NULL);
+		add_int(r->avg_hp);
+		add_int(r->ac);
+		add_int(r->sleep);
+		add_int(r->aaf);
+		add_int(r->speed);
+		add_int(r->mexp);
+		add_int(r->power);
+		add_int(r->scaled_power);
+		add_int(r->freq_innate);
+		add_int(r->freq_spell);
+		add_mem(r->flags, sizeof(r->flags));
+		add_mem(r->spell_flags, sizeof(r->spell_flags));
+		for (j = 0; r->blow && j < z_info->mon_blows_max; j++) {
+			add_int(r->blow[j].method);
+			add_int(r->blow[j].effect);
+			add_rand(r->blow[j].dice);
+		}
+		add_int(r->level);
+		add_int(r->rarity);
+		add_int(r->d_attr);
+		add_int(r->d_char);
+		for (d = r->drops; d; d = d->next) {
+			add_int(d->kind ? (long)d->kind->kidx : -1);
+			add_int(d->artifact ? (long)d->artifact->aidx : -1);
+			add_int(d->percent_chance);
+			add_int(d->min);
+			add_int(d->max);
+		}
+		for (f = r->friends; f; f = f->next) {
+			add_int(f->race ? (long)f->race->ridx : -1);
+			add_int(f->percent_chance);
+			add_int(f->number_dice);
+			add_int(f->number_side);
+		}
+		for (fb = r->friends_base; fb; fb = fb->next) {
+			add_str(fb->base->name);
+			add_int(fb->percent_chance);
+			add_int(fb->number_dice);
+			add_int(fb->number_side);
+		}
+		for (m = r->mimic_kinds; m; m = m->next)
+			add_int(m->kind->kidx);
+	}
+
+	return digest;
+}
+
+/**
+ * Start the game again from scratch, loading everything from the caches
+ * which are current
+ */
+static void restart(void) {
+	cleanup_angband();
+
+	/* The game brands and slays are kept until the game exits */
+	free_brand(game_brands);
+	game_brands = NULL;
+	free_slay(game_slays);
+	game_slays = NULL;
+
+	set_file_paths();
+	init_angband();
+}
+
+static struct room_template *copy_rooms(struct room_template *list) {
+	struct room_template *head = NULL, **tail = &head;
+
+	for (; list; list = list->next) {
+		struct room_template *t = mem_zalloc(sizeof(*t));
+
+		*t = *list;
+		t->name = string_make(list->name);
+		t->text = string_make(list->text);
+		t->next = NULL;
+		*tail = t;
+		tail = &t->next;
+	}
+	return head;
+}
+
+static struct vault *copy_vaults(struct vault *list) {
+	struct vault *head = NULL, **tail = &head;
+
+	for (; list; list = list->next) {
+		struct vault *v = mem_zalloc(sizeof(*v));
+
+		*v = *list;
+		v->name = string_make(list->name);
+		v->text = string_make(list->text);
+		v->typ = string_make(list->typ);
+		v->next = NULL;
+		*tail = v;
+		tail = &v->next;
+	}
+	return head;
+}
+
+static bool str_match(const char *a, const char *b) {
+	return (!a && !b) || (a && b && streq(a, b));
+}
+
+/**
+ * Compare the loaded room templates with the parsed ones, field by field
+ */
+static bool rooms_match(struct room_template *a, struct room_template *b) {
+	int n = 0;
+
+	for (; a && b; a = a->next, b = b->next, n++) {
+		if (!str_match(a->name, b->name) || !str_match(a->text, b->text) ||
+			a->typ != b->typ || a->rat != b->rat || a->hgt != b->hgt ||
+			a->wid != b->wid || a->dor != b->dor || a->tval != b->tval)
+			return false;
+	}
+	return !a && !b && n > 0;
+}
+
+/**
+ * Compare the loaded vaults with the parsed ones, field by field
+ */
+static bool vaults_match(struct vault *a, struct vault *b) {
+	int n = 0;
+
+	for (; a && b; a = a->next, b = b->next, n++) {
+		if (!str_match(a->name, b->name) || !str_match(a->text, b->text) ||
+			!str_match(a->typ, b->typ) || a->rat != b->rat ||
+			a->hgt != b->hgt || a->wid != b->wid ||
+			a->min_lev != b->min_lev || a->max_lev != b->max_lev)
+			return false;
+	}
+	return !a && !b && n > 0;
+}
+
+static void cache_path(char *buf, size_t len, const char *name) {
+	path_build(buf, len, ANGBAND_DIR_USER, format("%s.cache", name));
+}
+
+/**
+ * Check whether the stored cache with the given name is current
+ */
+static bool cache_current(const char *name, const char **sources) {
+	struct parse_cache *c = parse_cache_open(name, sources);
+	bool loaded = parse_cache_loaded(c);
+
+	parse_cache_close(c);
+	return loaded;
+}
+
+/**
+ * Flip a byte in the middle of a cache file
+ */
+static bool corrupt_cache(const char *name) {
+	char path[1024];
+	static char buf[1024 * 1024];
+	ang_file *f;
+	int len;
+
+	cache_path(path, sizeof(path), name);
+	f = file_open(path, MODE_READ, FTYPE_RAW);
+	if (!f) return false;
+	len = file_read(f, buf, sizeof(buf));
+	file_close(f);
+	if (len <= 0) return false;
+
+	buf[len / 2] ^= 0x5a;
+	f = file_open(path, MODE_WRITE, FTYPE_RAW);
+	if (!f) return false;
+	file_write(f, buf, len);
+	file_close(f);
+	return true;
+}
+
+/**
+ * Reload the room templates and vaults; the lists are taken from the cache
+ * if it is current
+ */
+static void reload(void) {
+	generate_module.cleanup();
+	generate_module.init();
+}
+
+int setup_tests(void **state) {
+	/* Keep the caches in an empty directory of their own */
+	set_file_paths();
+	if (!set_temp_user_dir())
+		return 1;
+
+	/* Parse from the text files, which writes new caches */
+	init_angband();
+	parsed_rooms = copy_rooms(room_templates);
+	parsed_vaults = copy_vaults(vaults);
+	parsed_tables = digest_tables();
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	while (parsed_rooms) {
+		struct room_template *t = parsed_rooms;
+
+		parsed_rooms = t->next;
+		string_free(t->name);
+		string_free(t->text);
+		mem_free(t);
+	}
+	while (parsed_vaults) {
+		struct vault *v = parsed_vaults;
+
+		parsed_vaults = v->next;
+		string_free(v->name);
+		string_free(v->text);
+		string_free(v->typ);
+		mem_free(v);
+	}
+	remove_temp_user_dir();
+	cleanup_angband();
+	return 0;
+}
+
+/* A fresh parse writes caches which are then current */
+int test_written(void *state) {
+	require(cache_current("room_template", room_sources));
+	require(cache_current("vault", vault_sources));
+	ok;
+}
+
+/* Lists loaded from the caches match the parsed ones */
+int test_loaded(void *state) {
+	reload();
+	require(cache_current("room_template", room_sources));
+	require(cache_current("vault", vault_sources));
+	require(rooms_match(room_templates, parsed_rooms));
+	require(vaults_match(vaults, parsed_vaults));
+	ok;
+}
+
+/* Corrupted caches are ignored, and rebuilt from the text files */
+int test_corrupt(void *state) {
+	require(corrupt_cache("room_template"));
+	require(corrupt_cache("vault"));
+	require(!cache_current("room_template", room_sources));
+	require(!cache_current("vault", vault_sources));
+	reload();
+	require(rooms_match(room_templates, parsed_rooms));
+	require(vaults_match(vaults, parsed_vaults));
+	require(cache_current("room_template", room_sources));
+	require(cache_current("vault", vault_sources));
+
+	/* And the rebuilt caches load as before */
+	reload();
+	require(rooms_match(room_templates, parsed_rooms));
+	require(vaults_match(vaults, parsed_vaults));
+	ok;
+}
+
+/* A user directory which doesn't exist yet is made for the caches */
+int test_new_dir(void *state) {
+	char *user = ANGBAND_DIR_USER;
+	char dir[1024], path[1024];
+
+	path_build(dir, sizeof(dir), user, "new");
+	require(!dir_exists(dir));
+	ANGBAND_DIR_USER = dir;
+	reload();
+	require(dir_exists(dir));
+	require(cache_current("room_template", room_sources));
+	require(cache_current("vault", vault_sources));
+	cache_path(path, sizeof(path), "room_template");
+	file_delete(path);
+	cache_path(path, sizeof(path), "vault");
+	file_delete(path);
+	ANGBAND_DIR_USER = user;
+	require(rmdir(dir) == 0);
+	ok;
+}
+
+/* The object and monster tables loaded from their caches match the parsed
+ * ones, with pointers between them linked up again */
+int test_tables(void *state) {
+	size_t i;
+
+	for (i = 0; i < N_ELEMENTS(table_caches); i++)
+		require(cache_current(table_caches[i], table_sources[i]));
+	restart();
+	for (i = 0; i < N_ELEMENTS(table_caches); i++)
+		require(cache_current(table_caches[i], table_sources[i]));
+	eq(digest_tables(), parsed_tables);
+	ok;
+}
+
+/* If one table's cache is no good, that table is parsed again and the
+ * tables depending on it still load from their caches */
+int test_tables_corrupt(void *state) {
+	require(corrupt_cache("object"));
+	require(!cache_current("object", table_sources[0]));
+	restart();
+	require(cache_current("object", table_sources[0]));
+	eq(digest_tables(), parsed_tables);
+	ok;
+}
+
+const char *suite_name = "parse/cache";
+struct test tests[] = {
+	{ "written", test_written },
+	{ "loaded", test_loaded },
+	{ "corrupt", test_corrupt },
+	{ "new-dir", test_new_dir },
+	{ "tables", test_tables },
+	{ "tables-corrupt", test_tables_corrupt },
+	{ NULL, NULL }
+};
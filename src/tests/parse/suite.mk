@@ -1,4 +1,6 @@
 TESTPROGS += parse/a-info \
+	parse/bench \
+	parse/cache \
 	parse/c-info \
 	parse/e-info \
 	parse/f-info \
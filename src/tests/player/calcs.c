@@ -0,0 +1,122 @@
+/* player/calcs
+ *
+ * Check that the bonuses update_stuff() works out after timed effects
+ * change, reusing the gear part of the state, match a full calc_bonuses().
+ */
+
+#include "unit-test.h"
+#include "unit-test-data.h"
+#include "test-utils.h"
+
+#include "init.h"
+#include "player-calcs.h"
+#include "player-timed.h"
+#include "player-util.h"
+#include "player.h"
+#include "z-rand.h"
+
+static void println(const char *str) {
+	printf("%s\n", str);
+}
+
+int setup_tests(void **state) {
+	plog_aux = println;
+	set_file_paths();
+	init_angband();
+	new_test_game(1729, 5);
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	cleanup_angband();
+	return 0;
+}
+
+static bool states_match(const struct player_state *a,
+						 const struct player_state *b)
+{
+	int i;
+
+	if (a->speed != b->speed) return false;
+	if (a->num_blows != b->num_blows) return false;
+	if (a->num_shots != b->num_shots) return false;
+	if (a->ammo_mult != b->ammo_mult) return false;
+	if (a->ammo_tval != b->ammo_tval) return false;
+	for (i = 0; i < STAT_MAX; i++) {
+		if (a->stat_add[i] != b->stat_add[i]) return false;
+		if (a->stat_ind[i] != b->stat_ind[i]) return false;
+		if (a->stat_use[i] != b->stat_use[i]) return false;
+		if (a->stat_top[i] != b->stat_top[i]) return false;
+	}
+	if (a->ac != b->ac || a->to_a != b->to_a) return false;
+	if (a->to_h != b->to_h || a->to_d != b->to_d) return false;
+	if (a->see_infra != b->see_infra) return false;
+	if (a->cur_light != b->cur_light) return false;
+	for (i = 0; i < SKILL_MAX; i++)
+		if (a->skills[i] != b->skills[i]) return false;
+	if (a->noise != b->noise) return false;
+	if (a->heavy_wield != b->heavy_wield) return false;
+	if (a->heavy_shoot != b->heavy_shoot) return false;
+	if (a->icky_wield != b->icky_wield) return false;
+	if (a->cumber_armor != b->cumber_armor) return false;
+	if (a->cumber_glove != b->cumber_glove) return false;
+	if (!of_is_equal(a->flags, b->flags)) return false;
+	if (!pf_is_equal(a->pflags, b->pflags)) return false;
+	for (i = 0; i < ELEM_MAX; i++) {
+		if (a->el_info[i].res_level != b->el_info[i].res_level) return false;
+		if (a->el_info[i].flags != b->el_info[i].flags) return false;
+	}
+	return true;
+}
+
+/* Compare the kept state with a full recalculation */
+static bool bonuses_match(void)
+{
+	struct player_state full, known;
+
+	update_stuff(player);
+	calc_bonuses(player, &full, false, false);
+	calc_bonuses(player, &known, true, false);
+	return states_match(&full, &player->state) &&
+		states_match(&known, &player->known_state);
+}
+
+int test_timed_effects(void *state) {
+	int i;
+
+	require(bonuses_match());
+	for (i = 0; i < 2000; i++) {
+		int idx = randint0(TMD_MAX);
+
+		if (one_in_(10))
+			player_set_food(player, rand_range(PY_FOOD_WEAK, PY_FOOD_MAX));
+		else if (one_in_(3))
+			player_clear_timed(player, idx, false);
+		else
+			player_inc_timed(player, idx, randint1(20), false, false);
+		require(bonuses_match());
+	}
+	ok;
+}
+
+int test_stats(void *state) {
+	int i;
+
+	/* Mix in changes that need the gear part redone too */
+	for (i = 0; i < 500; i++) {
+		if (one_in_(4))
+			player_stat_dec(player, randint0(STAT_MAX), false);
+		else
+			player_inc_timed(player, randint0(TMD_MAX), randint1(20), false,
+							 false);
+		require(bonuses_match());
+	}
+	ok;
+}
+
+const char *suite_name = "player/calcs";
+struct test tests[] = {
+	{ "timed", test_timed_effects },
+	{ "stats", test_stats },
+	{ NULL, NULL }
+};
@@ -1,11 +1,55 @@
 /* player/pathfind */
 
 #include "unit-test.h"
+#include "test-utils.h"
+#include "cave.h"
 #include "cmd-core.h"
+#include "init.h"
+#include "player.h"
 #include "player-path.h"
 
-NOSETUP
-NOTEARDOWN
+#define PF_BENCH_RUNS 1000
+
+int setup_tests(void **state) {
+	int y, x;
+
+	set_file_paths();
+	init_angband();
+
+	/* A large, fully known open cavern */
+	cave = cave_new(z_info->dungeon_hgt, z_info->dungeon_wid);
+	cave_k = cave_new(z_info->dungeon_hgt, z_info->dungeon_wid);
+	for (y = 0; y < cave->height; y++)
+		for (x = 0; x < cave->width; x++) {
+			bool edge = !y || !x || (y == cave->height - 1) ||
+				(x == cave->width - 1);
+			cave->squares[y][x].feat = edge ? FEAT_PERM : FEAT_FLOOR;
+			cave_k->squares[y][x].feat = cave->squares[y][x].feat;
+		}
+
+	player->py = cave->height / 2;
+	player->px = cave->width / 2;
+
+	return 0;
+}
+
+int teardown_tests(void **state) {
+	cave_free(cave_k);
+	cave_free(cave);
+	cave = cave_k = NULL;
+	cleanup_angband();
+	return 0;
+}
+
+static void set_wall(int y, int x) {
+	cave->squares[y][x].feat = FEAT_GRANITE;
+	cave_k->squares[y][x].feat = FEAT_GRANITE;
+}
+
+static void set_floor(int y, int x) {
+	cave->squares[y][x].feat = FEAT_FLOOR;
+	cave_k->squares[y][x].feat = FEAT_FLOOR;
+}
 
 int test_dir_to(void *state) {
 	eq(pathfind_direction_to(loc(0,0), loc(0,1)), DIR_S);
@@ -24,8 +68,173 @@ int test_dir_to(void *state) {
 	ok;
 }
 
+int test_findpath(void *state) {
+	int y;
+
+	/* Open ground, and out of the pathfinder's range */
+	require(findpath(player->py + 20, player->px + 40));
+	require(findpath(1, player->px - 40));
+	require(!findpath(player->py, player->px + 60));
+
+	/* A wall across the cavern with a single gap at the bottom */
+	for (y = 1; y < cave->height - 1; y++)
+		set_wall(y, player->px + 5);
+	set_floor(cave->height - 2, player->px + 5);
+	require(findpath(player->py, player->px + 10));
+
+	/* Close the gap */
+	set_wall(cave->height - 2, player->px + 5);
+	require(!findpath(player->py, player->px + 10));
+
+	for (y = 1; y < cave->height - 1; y++)
+		set_floor(y, player->px + 5);
+	ok;
+}
+
+/**
+ * Follow the last path found from the player, checking every step is
+ * passable and the path ends at (y, x); return its length, or -1
+ */
+static int follow_path(int y, int x) {
+	char buf[512];
+	int n = findpath_result(buf, sizeof(buf));
+	int py = player->py, px = player->px;
+	int i;
+
+	if (n != (int)strlen(buf)) return -1;
+	for (i = 0; i < n; i++) {
+		int dir = buf[i] - '0';
+
+		if (dir < 1 || dir > 9 || dir == 5) return -1;
+		py += ddy[dir];
+		px += ddx[dir];
+		if (!square_ispassable(cave, py, px)) return -1;
+	}
+	return ((py == y) && (px == x)) ? n : -1;
+}
+
+/**
+ * Number of steps on a shortest path from the player to (y, x), by a plain
+ * breadth-first search, or -1 if there is none
+ */
+static int shortest_path(int y, int x) {
+	static int dist[256][256];
+	static struct loc queue[256 * 256];
+	int head = 0, tail = 0;
+	int j, i, dir;
+
+	for (j = 0; j < cave->height; j++)
+		for (i = 0; i < cave->width; i++)
+			dist[j][i] = -1;
+	dist[player->py][player->px] = 0;
+	queue[tail++] = loc(player->px, player->py);
+
+	while (head < tail) {
+		struct loc grid = queue[head++];
+
+		for (dir = 1; dir < 10; dir++) {
+			int ny = grid.y + ddy[dir], nx = grid.x + ddx[dir];
+
+			if (dir == 5 || !square_in_bounds(cave, ny, nx)) continue;
+			if (dist[ny][nx] >= 0 || !square_ispassable(cave, ny, nx))
+				continue;
+			dist[ny][nx] = dist[grid.y][grid.x] + 1;
+			queue[tail++] = loc(nx, ny);
+		}
+	}
+
+	return dist[y][x];
+}
+
+int test_result(void *state) {
+	char buf[512];
+	int py = player->py, px = player->px;
+	int y, x, n, trial;
+
+	/* Straight and diagonal lines are unambiguous */
+	require(findpath(py, px + 10));
+	eq(findpath_result(buf, sizeof(buf)), 10);
+	require(streq(buf, "6666666666"));
+	require(findpath(py + 5, px + 5));
+	eq(findpath_result(buf, sizeof(buf)), 5);
+	require(streq(buf, "33333"));
+	require(findpath(py - 3, px));
+	eq(findpath_result(buf, sizeof(buf)), 3);
+	require(streq(buf, "888"));
+
+	/* Other paths take as many steps as the larger offset */
+	require(findpath(py + 2, px + 7));
+	eq(follow_path(py + 2, px + 7), 7);
+	require(findpath(py - 20, px - 33));
+	eq(follow_path(py - 20, px - 33), 33);
+
+	/* A short buffer gets as many steps as fit */
+	require(findpath(py, px + 10));
+	eq(findpath_result(buf, 4), 10);
+	require(streq(buf, "666"));
+
+	/* Around a wall with a single gap at the bottom */
+	for (y = 1; y < cave->height - 1; y++)
+		set_wall(y, px + 5);
+	set_floor(cave->height - 2, px + 5);
+	require(findpath(py, px + 10));
+	n = follow_path(py, px + 10);
+	require(n > 10);
+	eq(n, shortest_path(py, px + 10));
+	for (y = 1; y < cave->height - 1; y++)
+		set_floor(y, px + 5);
+
+	/* Scattered rubble in a walled box, against a breadth-first search */
+	for (y = 1; y < cave->height - 1; y++) {
+		set_wall(y, px - 31);
+		set_wall(y, px + 31);
+	}
+	for (trial = 0; trial < 50; trial++) {
+		int ty, tx;
+
+		for (y = 1; y < cave->height - 1; y++)
+			for (x = px - 30; x <= px + 30; x++)
+				if ((y != py || x != px) && one_in_(3))
+					set_wall(y, x);
+				else
+					set_floor(y, x);
+		ty = rand_range(1, cave->height - 2);
+		tx = rand_range(px - 30, px + 30);
+		set_floor(ty, tx);
+
+		n = shortest_path(ty, tx);
+		if (n < 0) {
+			require(!findpath(ty, tx));
+		} else {
+			require(findpath(ty, tx));
+			eq(follow_path(ty, tx), n);
+		}
+	}
+	for (y = 1; y < cave->height - 1; y++)
+		for (x = px - 31; x <= px + 31; x++)
+			set_floor(y, x);
+	ok;
+}
+
+int test_bench_open(void *state) {
+	int i;
+	clock_t start = clock();
+
+	for (i = 0; i < PF_BENCH_RUNS; i++)
+		require(findpath(i % 2 ? 1 : cave->height - 2,
+						 player->px + (i % 3 ? 45 : -45)));
+
+	if (verbose)
+		printf("(%d paths in %.3fs) ", PF_BENCH_RUNS,
+			   (double)(clock() - start) / CLOCKS_PER_SEC);
+	ok;
+}
+
 const char *suite_name = "player/pathfind";
 struct test tests[] = {
 	{ "dir-to", test_dir_to },
+	{ "findpath", test_findpath },
+	{ "result", test_result },
+	{ "bench-open", test_bench_open },
 	{ NULL, NULL },
 };
@@ -1,4 +1,5 @@
 TESTPROGS += player/birth \
+             player/calcs \
              player/history \
              player/pathfind \
              player/playerstat
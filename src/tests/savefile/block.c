@@ -0,0 +1,321 @@
+/* savefile/block
+ *
+ * Tests for the compression of savefile blocks, and for loading savefiles
+ * with broken compressed blocks
+ */
+
+#include "unit-test.h"
+#include "unit-test-data.h"
+#include "test-utils.h"
+
+#include "init.h"
+#include "player.h"
+#include "savefile.h"
+#include "z-file.h"
+#include "z-rand.h"
+
+/* The layout of a block header, as savefile.c writes it */
+#define HEAD_SIZE	28
+#define HEAD_VERSION	16
+#define HEAD_SIZE_AT	20
+#define COMPRESSED	0x80000000
+
+static char path[1024];
+
+static void println(const char *str) {
+	printf("%s\n", str);
+}
+
+int setup_tests(void **state) {
+	plog_aux = println;
+	set_file_paths();
+	if (!set_temp_user_dir())
+		return 1;
+	init_angband();
+	new_test_game(31337, 10);
+	path_build(path, sizeof(path), ANGBAND_DIR_USER, "test-savefile");
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	remove_temp_user_dir();
+	cleanup_angband();
+	return 0;
+}
+
+/* Room for any input, even one with nothing to compress */
+static u32b room_for(u32b n)
+{
+	return n + n / 32 + 64;
+}
+
+/* Text-like data that compresses, with some random bytes mixed in */
+static byte *make_data(u32b n, int random_percent)
+{
+	static const char *words[] = {
+		"the ", "orc ", "hits ", "you. ", "You ", "miss ", "Grip, ",
+		"Farmer Maggot's Dog ", "barks. ", "\n"
+	};
+	byte *data = mem_alloc(MAX(n, 1));
+	u32b i = 0;
+
+	while (i < n) {
+		if (randint0(100) < random_percent) {
+			data[i++] = (byte)randint0(256);
+		} else {
+			const char *w = words[randint0(N_ELEMENTS(words))];
+			while (*w && i < n) data[i++] = (byte)*w++;
+		}
+	}
+
+	return data;
+}
+
+/* Compress and decompress n bytes of data, checking they come back */
+static bool round_trip(const byte *data, u32b n, u32b *packed_len)
+{
+	byte *packed = mem_alloc(room_for(n));
+	byte *unpacked = mem_alloc(MAX(n, 1));
+	u32b len = lz_compress(data, n, packed, room_for(n));
+	bool same = (len > 0 || n == 0) &&
+		lz_decompress(packed, len, unpacked, n) &&
+		!memcmp(data, unpacked, n);
+
+	mem_free(unpacked);
+	mem_free(packed);
+	if (packed_len) *packed_len = len;
+	return same;
+}
+
+int test_round_trip(void *state) {
+	u32b sizes[] = { 0, 1, 2, 3, 4, 31, 32, 33, 255, 256, 4096, 100000 };
+	byte zeros[5000];
+	size_t i;
+	u32b len;
+
+	/* Empty blocks come to nothing */
+	require(round_trip(zeros, 0, &len));
+	eq(len, 0);
+
+	/* Long runs need more than one copy */
+	memset(zeros, 0, sizeof(zeros));
+	require(round_trip(zeros, sizeof(zeros), &len));
+	require(len < sizeof(zeros) / 20);
+
+	for (i = 0; i < N_ELEMENTS(sizes); i++) {
+		byte *data = make_data(sizes[i], 5);
+		require(round_trip(data, sizes[i], NULL));
+		mem_free(data);
+	}
+
+	/* A large block, with copies from as far back as they can reach */
+	{
+		byte *data = make_data(1 << 20, 1);
+		require(round_trip(data, 1 << 20, &len));
+		require(len < (1 << 19));
+		mem_free(data);
+	}
+	ok;
+}
+
+int test_incompressible(void *state) {
+	u32b n = 20000;
+	byte *data = make_data(n, 100);
+	byte *packed = mem_alloc(n + 8);
+	size_t i;
+	u32b len;
+
+	/* Random data does not fit in less room than it started in... */
+	for (i = 0; i < 8; i++) packed[n - 4 + i] = 0xAA;
+	eq(lz_compress(data, n, packed, n - 4), 0);
+
+	/* ...and nothing is written past the room it is given */
+	for (i = 0; i < 8; i++) eq(packed[n - 4 + i], 0xAA);
+
+	/* Given enough room, it still comes back */
+	require(round_trip(data, n, &len));
+	require(len >= n);
+
+	mem_free(packed);
+	mem_free(data);
+	ok;
+}
+
+int test_corrupt(void *state) {
+	u32b n = 50000, len, cut;
+	byte *data = make_data(n, 5);
+	byte *packed = mem_alloc(room_for(n));
+	byte *unpacked = mem_alloc(n);
+	byte bad[] = { 0x3F, 0xFF, 0x00, 0x41 };
+	int i;
+
+	len = lz_compress(data, n, packed, room_for(n));
+	require(len > 0);
+
+	/* Only the exact size will do */
+	require(!lz_decompress(packed, len, unpacked, n - 1));
+	require(!lz_decompress(packed, len, unpacked + 1, n - 1));
+	require(lz_decompress(packed, len, unpacked, n));
+
+	/* Cut short anywhere, copied so that there is nothing after the end */
+	for (cut = 0; cut < len; cut += 1 + cut / 50) {
+		byte *part = mem_alloc(MAX(cut, 1));
+		memcpy(part, packed, cut);
+		require(!lz_decompress(part, cut, unpacked, n));
+		mem_free(part);
+	}
+
+	/* A copy from before the start of the output */
+	require(!lz_decompress(bad, sizeof(bad), unpacked, 300));
+
+	/* A long copy with its length byte missing */
+	bad[0] = 0xE0;
+	require(!lz_decompress(bad, 1, unpacked, 300));
+
+	/* Damage anywhere must not take the decoder outside its buffers */
+	for (i = 0; i < 2000; i++) {
+		byte *copy = mem_alloc(len);
+		memcpy(copy, packed, len);
+		copy[randint0(len)] ^= (byte)randint1(255);
+		(void)lz_decompress(copy, len, unpacked, n);
+		mem_free(copy);
+	}
+
+	mem_free(unpacked);
+	mem_free(packed);
+	mem_free(data);
+	ok;
+}
+
+/* Read the whole of the savefile */
+static byte *read_savefile(u32b *size)
+{
+	ang_file *f = file_open(path, MODE_READ, FTYPE_RAW);
+	byte *image = mem_alloc(1 << 20);
+	int n;
+
+	*size = 0;
+	if (!f) return image;
+	while ((n = file_read(f, (char *)image + *size, (1 << 20) - *size)) > 0)
+		*size += n;
+	file_close(f);
+	return image;
+}
+
+static void write_savefile(const byte *image, u32b size)
+{
+	ang_file *f = file_open(path, MODE_WRITE, FTYPE_RAW);
+
+	file_write(f, (const char *)image, size);
+	file_close(f);
+}
+
+static u32b get_u32b(const byte *p)
+{
+	return p[0] | (p[1] << 8) | (p[2] << 16) | ((u32b)p[3] << 24);
+}
+
+static void put_u32b(byte *p, u32b v)
+{
+	p[0] = v & 0xFF;
+	p[1] = (v >> 8) & 0xFF;
+	p[2] = (v >> 16) & 0xFF;
+	p[3] = (v >> 24) & 0xFF;
+}
+
+/* The offset of the header of the biggest compressed block, or 0 */
+static u32b find_compressed(const byte *image, u32b size)
+{
+	u32b pos = 8, found = 0, biggest = 0;
+
+	while (pos + HEAD_SIZE <= size) {
+		u32b len = get_u32b(image + pos + HEAD_SIZE_AT);
+
+		if ((get_u32b(image + pos + HEAD_VERSION) & COMPRESSED) &&
+			len > biggest) {
+			found = pos;
+			biggest = len;
+		}
+		pos += HEAD_SIZE + len + (len % 4 ? 4 - len % 4 : 0);
+	}
+
+	return found;
+}
+
+int test_savefile(void *state) {
+	s32b au = player->au;
+	s16b lev = player->lev;
+	byte *image, *broken;
+	u32b size, block, data_size, unpacked_size;
+	u32b cuts[6];
+	u32b sizes[4];
+	size_t i;
+
+	/* A saved game loads back */
+	require(savefile_save(path));
+	player->au = au + 1000;
+	player->lev = lev + 1;
+	require(savefile_load(path, false));
+	eq(player->au, au);
+	eq(player->lev, lev);
+
+	image = read_savefile(&size);
+	block = find_compressed(image, size);
+	require(block > 0);
+	data_size = get_u32b(image + block + HEAD_SIZE_AT);
+	unpacked_size = get_u32b(image + block + HEAD_SIZE);
+	require(unpacked_size > data_size);
+	broken = mem_alloc(size);
+
+	/* Truncated savefiles, including in the middle of a compressed block */
+	cuts[0] = 6;
+	cuts[1] = block + HEAD_SIZE / 2;
+	cuts[2] = block + HEAD_SIZE + 2;
+	cuts[3] = block + HEAD_SIZE + data_size / 2;
+	cuts[4] = block + HEAD_SIZE + data_size - 1;
+	cuts[5] = size - 1;
+	for (i = 0; i < N_ELEMENTS(cuts); i++) {
+		write_savefile(image, cuts[i]);
+		require(!savefile_load(path, false));
+	}
+
+	/* Wrong uncompressed sizes */
+	sizes[0] = unpacked_size - 1;
+	sizes[1] = unpacked_size + 1;
+	sizes[2] = 0;
+	sizes[3] = 0xFFFFFFFF;
+	for (i = 0; i < N_ELEMENTS(sizes); i++) {
+		memcpy(broken, image, size);
+		put_u32b(broken + block + HEAD_SIZE, sizes[i]);
+		write_savefile(broken, size);
+		require(!savefile_load(path, false));
+	}
+
+	/* Compressed blocks too short to hold a size, or longer than the file */
+	memcpy(broken, image, size);
+	put_u32b(broken + block + HEAD_SIZE_AT, 3);
+	write_savefile(broken, size);
+	require(!savefile_load(path, false));
+	memcpy(broken, image, size);
+	put_u32b(broken + block + HEAD_SIZE_AT, size);
+	write_savefile(broken, size);
+	require(!savefile_load(path, false));
+
+	/* The good one still loads */
+	write_savefile(image, size);
+	require(savefile_load(path, false));
+	eq(player->au, au);
+
+	mem_free(broken);
+	mem_free(image);
+	ok;
+}
+
+const char *suite_name = "savefile/block";
+struct test tests[] = {
+	{ "round-trip", test_round_trip },
+	{ "incompressible", test_incompressible },
+	{ "corrupt", test_corrupt },
+	{ "savefile", test_savefile },
+	{ NULL, NULL }
+};
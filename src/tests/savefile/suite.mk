@@ -0,0 +1 @@
+TESTPROGS += savefile/block
@@ -8,9 +8,19 @@
 
 #include "h-basic.h"
 #include "config.h"
+#include "cmd-core.h"
+#include "game-world.h"
+#include "generate.h"
 #include "init.h"
+#include "player-util.h"
+#include "test-utils.h"
+#include "z-file.h"
+#include "z-rand.h"
 #include "z-util.h"
 
+#include <stdlib.h>
+#include <unistd.h>
+
 #ifdef SOUND_SDL
 #include "sound.h"
 #include "snd-sdl.h"
@@ -22,9 +32,60 @@ errr init_sound_sdl(struct sound_hooks *hooks, int argc, char **argv)
 
 #endif
 
+static char temp_user_dir[1024];
+
+/*
+ * Send everything written to the user directory, such as caches and
+ * savefiles, to an empty directory of the suite's own, so tests never touch
+ * the player's files.  set_file_paths() does this; the directory goes when
+ * the suite exits, or earlier with remove_temp_user_dir().
+ */
+bool set_temp_user_dir(void) {
+	static bool registered = false;
+	const char *tmp = getenv("TMPDIR");
+
+	if (!temp_user_dir[0]) {
+		path_build(temp_user_dir, sizeof(temp_user_dir), tmp ? tmp : "/tmp",
+				   "angband-test-XXXXXX");
+		if (!mkdtemp(temp_user_dir)) {
+			temp_user_dir[0] = '\0';
+			return false;
+		}
+		if (!registered) {
+			atexit(remove_temp_user_dir);
+			registered = true;
+		}
+	}
+
+	string_free(ANGBAND_DIR_USER);
+	ANGBAND_DIR_USER = string_make(temp_user_dir);
+	return true;
+}
+
+/*
+ * Delete the directory made by set_temp_user_dir() and everything in it
+ */
+void remove_temp_user_dir(void) {
+	char name[1024], path[1024];
+	ang_dir *dir;
+
+	if (!temp_user_dir[0]) return;
+
+	dir = my_dopen(temp_user_dir);
+	if (dir) {
+		while (my_dread(dir, name, sizeof(name))) {
+			path_build(path, sizeof(path), temp_user_dir, name);
+			file_delete(path);
+		}
+		my_dclose(dir);
+	}
+	rmdir(temp_user_dir);
+	temp_user_dir[0] = '\0';
+}
+
 /*
  * Call this to initialise Angband's file paths before calling init_angband()
- * or similar.
+ * or similar.  The user directory is a temporary one; see set_temp_user_dir().
  */
 void set_file_paths(void) {
 	char configpath[512], libpath[512], datapath[512];
@@ -43,6 +104,7 @@ void set_file_paths(void) {
 		my_strcat(datapath, PATH_SEP, sizeof(datapath));
 
 	init_file_paths(configpath, libpath, datapath);
+	set_temp_user_dir();
 }
 
 /*
@@ -53,3 +115,32 @@ void read_edit_files(void) {
 	init_game_constants();
 	init_arrays();
 }
+
+/*
+ * Call this after init_angband() to make a new character and a level at the
+ * given depth, with the random number generator seeded so that everything
+ * after is reproducible
+ */
+void new_test_game(u32b seed, int depth) {
+	Rand_state_init(seed);
+
+	cmdq_push(CMD_BIRTH_INIT);
+	cmdq_push(CMD_BIRTH_RESET);
+	cmdq_push(CMD_CHOOSE_RACE);
+	cmd_set_arg_choice(cmdq_peek(), "choice", 0);
+	cmdq_push(CMD_CHOOSE_CLASS);
+	cmd_set_arg_choice(cmdq_peek(), "choice", 0);
+	cmdq_push(CMD_ROLL_STATS);
+	cmdq_push(CMD_NAME_CHOICE);
+	cmd_set_arg_string(cmdq_peek(), "name", "Tester");
+	cmdq_push(CMD_ACCEPT_CHARACTER);
+	cmdq_execute(CMD_BIRTH);
+	cave_generate(&cave, player);
+	on_new_level();
+
+	player->max_depth = depth;
+	dungeon_change_level(depth);
+	cave_generate(&cave, player);
+	on_new_level();
+	player->upkeep->generate_level = false;
+}
@@ -10,6 +10,9 @@
 #define TEST_UTILS_H
 
 void set_file_paths(void);
+bool set_temp_user_dir(void);
+void remove_temp_user_dir(void);
 void read_edit_files(void);
+void new_test_game(u32b seed, int depth);
 
 #endif /* TEST_UTIL_H */
@@ -0,0 +1,82 @@
+/* ui-term/term */
+
+#include "unit-test.h"
+#include "ui-term.h"
+#include "z-color.h"
+
+static term test_term;
+static int texts;
+
+static errr text_hook(int x, int y, int n, int a, const wchar_t *s) {
+	texts++;
+	return 0;
+}
+
+static errr wipe_hook(int x, int y, int n) {
+	return 0;
+}
+
+int setup_tests(void **state) {
+	u32b cells, spans;
+
+	term_init(&test_term, 80, 24, 16);
+	test_term.text_hook = text_hook;
+	test_term.wipe_hook = wipe_hook;
+	Term_activate(&test_term);
+
+	/* Get the first full redraw out of the way */
+	Term_fresh();
+	Term_get_fresh_stats(&cells, &spans);
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	term_nuke(&test_term);
+	return 0;
+}
+
+int test_changed(void *state) {
+	u32b cells, spans;
+
+	/* Every cell of the changed span is looked at once */
+	texts = 0;
+	Term_putstr(10, 5, 5, COLOUR_WHITE, "hello");
+	Term_fresh();
+	Term_get_fresh_stats(&cells, &spans);
+	eq(cells, 5);
+	eq(spans, 1);
+	eq(texts, 1);
+
+	/* Nothing to do, and the counts start again from zero */
+	Term_fresh();
+	Term_get_fresh_stats(&cells, &spans);
+	eq(cells, 0);
+	eq(spans, 0);
+	ok;
+}
+
+int test_skipped(void *state) {
+	u32b cells, spans;
+
+	/* Two changes with 25 untouched cells between them */
+	texts = 0;
+	Term_putstr(10, 7, 5, COLOUR_WHITE, "hello");
+	Term_putstr(40, 7, 5, COLOUR_WHITE, "world");
+	Term_fresh();
+	Term_get_fresh_stats(&cells, &spans);
+	eq(spans, 2);
+	eq(texts, 2);
+
+	/* The gap is skipped a block at a time, and only the block with the
+	 * second change in it gets looked at twice */
+	require(cells >= 35);
+	require(cells <= 40);
+	ok;
+}
+
+const char *suite_name = "ui-term/term";
+struct test tests[] = {
+	{ "changed", test_changed },
+	{ "skipped", test_skipped },
+	{ NULL, NULL }
+};
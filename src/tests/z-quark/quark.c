@@ -2,6 +2,9 @@
 
 #include "unit-test.h"
 #include "z-quark.h"
+#include "z-form.h"
+
+#define QUARK_BENCH_COUNT 20000
 
 int setup_tests(void **state) {
 	quarks_init();
@@ -46,9 +49,37 @@ int test_dedup(void *state) {
 	ok;
 }
 
+int test_bench(void *state) {
+	char buf[32];
+	quark_t first = 0;
+	int i;
+	clock_t start = clock();
+
+	/* Intern many distinct strings, then look each one up again */
+	for (i = 0; i < QUARK_BENCH_COUNT; i++) {
+		quark_t q;
+
+		strnfmt(buf, sizeof(buf), "2-quark-%d", i);
+		q = quark_add(buf);
+		if (!i) first = q;
+		require(q == first + i);
+	}
+	for (i = 0; i < QUARK_BENCH_COUNT; i++) {
+		strnfmt(buf, sizeof(buf), "2-quark-%d", i);
+		require(quark_add(buf) == first + i);
+		require(!strcmp(quark_str(first + i), buf));
+	}
+
+	if (verbose)
+		printf("(%d quarks in %.3fs) ", QUARK_BENCH_COUNT,
+			   (double)(clock() - start) / CLOCKS_PER_SEC);
+	ok;
+}
+
 const char *suite_name = "z-quark/quark";
 struct test tests[] = {
 	{ "alloc", test_alloc },
 	{ "dedup", test_dedup },
+	{ "bench", test_bench },
 	{ NULL, NULL }
 };
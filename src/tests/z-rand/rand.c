@@ -0,0 +1,118 @@
+/* z-rand/rand */
+
+#include "unit-test.h"
+#include "z-rand.h"
+
+NOSETUP
+NOTEARDOWN
+
+/* The first draws of Rand_div(100000) for the seeds used below */
+static const u32b complex_12345[] = {
+	67908, 44807, 99504, 90049, 78018, 55211, 27873, 39317
+};
+static const u32b quick_42[] = {
+	79125, 76000, 73308, 88863, 71152, 51675, 70878, 90448
+};
+
+int test_complex(void *state)
+{
+	struct rng_state rng, *old;
+	size_t i;
+
+	/* Whatever the context held before does not matter */
+	memset(&rng, 0xa5, sizeof(rng));
+	rng_state_init(&rng, 12345);
+	old = Rand_set_context(&rng);
+	for (i = 0; i < N_ELEMENTS(complex_12345); i++)
+		eq(Rand_div(100000), complex_12345[i]);
+	ptreq(Rand_set_context(old), &rng);
+	ok;
+}
+
+int test_quick(void *state)
+{
+	struct rng_state rng, *old;
+	size_t i;
+
+	rng_state_init_quick(&rng, 42);
+	old = Rand_set_context(&rng);
+	for (i = 0; i < N_ELEMENTS(quick_42); i++)
+		eq(Rand_div(100000), quick_42[i]);
+	Rand_set_context(old);
+	ok;
+}
+
+int test_independent(void *state)
+{
+	struct rng_state a, b, *old;
+	u32b first[16];
+	int i;
+
+	rng_state_init(&a, 777);
+	rng_state_init(&b, 777);
+
+	/* Draws from one context do not disturb another */
+	old = Rand_set_context(&a);
+	for (i = 0; i < 16; i++)
+		first[i] = Rand_div(0x10000000);
+	Rand_set_context(&b);
+	for (i = 0; i < 8; i++)
+		eq(Rand_div(0x10000000), first[i]);
+	Rand_set_context(&a);
+	(void)Rand_div(0x10000000);
+	Rand_set_context(&b);
+	for (i = 8; i < 16; i++)
+		eq(Rand_div(0x10000000), first[i]);
+	Rand_set_context(old);
+	ok;
+}
+
+int test_split(void *state)
+{
+	struct rng_state a, b, c, *old;
+	u32b x[16];
+	int i, same = 0;
+
+	/* The same stream of the same seed repeats */
+	rng_state_split(&a, 99, 3);
+	rng_state_split(&b, 99, 3);
+	rng_state_split(&c, 99, 4);
+	old = Rand_set_context(&a);
+	for (i = 0; i < 16; i++)
+		x[i] = Rand_div(0x10000000);
+	Rand_set_context(&b);
+	for (i = 0; i < 16; i++)
+		eq(Rand_div(0x10000000), x[i]);
+
+	/* Other streams differ */
+	Rand_set_context(&c);
+	for (i = 0; i < 16; i++)
+		if (Rand_div(0x10000000) == x[i]) same++;
+	Rand_set_context(old);
+	require(same < 2);
+	ok;
+}
+
+int test_default(void *state)
+{
+	struct rng_state rng, *main_rng = Rand_context();
+
+	rng_state_init_quick(&rng, 1);
+	Rand_set_context(&rng);
+	ptreq(Rand_context(), &rng);
+
+	/* NULL goes back to the main stream */
+	ptreq(Rand_set_context(NULL), &rng);
+	ptreq(Rand_context(), main_rng);
+	ok;
+}
+
+const char *suite_name = "z-rand/rand";
+struct test tests[] = {
+	{ "complex", test_complex },
+	{ "quick", test_quick },
+	{ "independent", test_independent },
+	{ "split", test_split },
+	{ "default", test_default },
+	{ NULL, NULL }
+};
@@ -25,9 +25,73 @@ int test_realloc(void *state) {
 	return 0;
 }
 
+int test_realloc_class(void *state) {
+	char *p1 = mem_alloc(20);
+	char *p2;
+	memset(p1, 0x4, 20);
+
+	/* Growing within a size class keeps the block */
+	require(mem_realloc(p1, 30) == p1);
+
+	/* Growing out of it keeps the contents */
+	p2 = mem_realloc(p1, 300);
+	require(p2[0] == 0x4 && p2[19] == 0x4);
+	p2 = mem_realloc(p2, 10);
+	require(p2[0] == 0x4 && p2[9] == 0x4);
+	mem_free(p2);
+	ok;
+}
+
+static void count_stats(const struct mem_class_stats *stats, void *data) {
+	struct mem_class_stats *total = data;
+	if (stats->size == 48) *total = *stats;
+}
+
+int test_stats(void *state) {
+	struct mem_class_stats before, after;
+	void *p1, *p2;
+
+	mem_report_stats(count_stats, &before);
+	p1 = mem_alloc(40);
+	mem_free(p1);
+	p2 = mem_alloc(48);
+	mem_report_stats(count_stats, &after);
+
+	/* A freed block is reused for the next request in its class */
+	require(p1 == p2);
+	eq(after.allocs, before.allocs + 2);
+	eq(after.reused, before.reused + 1);
+	eq(after.live, before.live + 1);
+	eq(after.bytes, before.bytes + 88);
+	mem_free(p2);
+	mem_trim();
+	ok;
+}
+
+int test_arena(void *state) {
+	struct mem_arena *arena = mem_arena_new();
+	char *small = mem_arena_zalloc(arena, 10);
+	char *big = mem_arena_alloc(arena, 100000);
+	char *next = mem_arena_alloc(arena, 10);
+	int i;
+
+	require(small[0] == 0 && small[9] == 0);
+	memset(big, 0x5, 100000);
+
+	/* Small requests keep sharing a block around a big one */
+	require(next == small + 16);
+	for (i = 0; i < 10000; i++)
+		require(mem_arena_alloc(arena, 24));
+	mem_arena_free(arena);
+	ok;
+}
+
 const char *suite_name = "z-virt/mem";
 struct test tests[] = {
 	{ "alloc", test_alloc },
 	{ "realloc", test_realloc },
+	{ "realloc-class", test_realloc_class },
+	{ "stats", test_stats },
+	{ "arena", test_arena },
 	{ NULL, NULL }
 };
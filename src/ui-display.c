@@ -1031,7 +1031,13 @@ static void update_statusline(game_event_type type, game_event_data *data, void
 static void trace_map_updates(game_event_type type, game_event_data *data,
 							  void *user)
 {
-	if (data->point.x == -1 && data->point.y == -1)
+	int i;
+
+	if (type == EVENT_MAP_POINTS) {
+		for (i = 0; i < data->points.count; i++)
+			printf("Redraw (%i, %i)\n", data->points.grids[i].x,
+				   data->points.grids[i].y);
+	} else if (data->point.x == -1 && data->point.y == -1)
 		printf("Redraw whole map\n");
 	else
 		printf("Redraw (%i, %i)\n", data->point.x, data->point.y);
@@ -1039,77 +1045,98 @@ static void trace_map_updates(game_event_type type, game_event_data *data,
 #endif
 
 /**
- * Update either a single map grid or a whole map
+ * Redraw a single map grid in the given term, if it is on the panel
  */
-static void update_maps(game_event_type type, game_event_data *data, void *user)
+static void update_map_point(term *t, int x, int y)
 {
-	term *t = user;
-
-	/* This signals a whole-map redraw. */
-	if (data->point.x == -1 && data->point.y == -1)
-		prt_map();
+	int a, ta;
+	wchar_t c, tc;
 
-	/* Single point to be redrawn */
-	else {
-		struct grid_data g;
-		int a, ta;
-		wchar_t c, tc;
+	int ky, kx;
+	int vy, vx;
 
-		int ky, kx;
-		int vy, vx;
+	/* Location relative to panel */
+	ky = y - t->offset_y;
+	kx = x - t->offset_x;
 
-		/* Location relative to panel */
-		ky = data->point.y - t->offset_y;
-		kx = data->point.x - t->offset_x;
+	if (t == angband_term[0]) {
+		/* Verify location */
+		if ((ky < 0) || (ky >= SCREEN_HGT)) return;
 
-		if (t == angband_term[0]) {
-			/* Verify location */
-			if ((ky < 0) || (ky >= SCREEN_HGT)) return;
+		/* Verify location */
+		if ((kx < 0) || (kx >= SCREEN_WID)) return;
 
-			/* Verify location */
-			if ((kx < 0) || (kx >= SCREEN_WID)) return;
+		/* Location in window */
+		vy = ky + ROW_MAP;
+		vx = kx + COL_MAP;
 
-			/* Location in window */
-			vy = ky + ROW_MAP;
-			vx = kx + COL_MAP;
+		if (tile_width > 1)
+			vx += (tile_width - 1) * kx;
 
-			if (tile_width > 1)
-				vx += (tile_width - 1) * kx;
+		if (tile_height > 1)
+			vy += (tile_height - 1) * ky;
 
-			if (tile_height > 1)
-				vy += (tile_height - 1) * ky;
-
-		} else {
-			if (tile_width > 1)
-			        kx += (tile_width - 1) * kx;
+	} else {
+		if (tile_width > 1)
+		        kx += (tile_width - 1) * kx;
 
-			if (tile_height > 1)
-			        ky += (tile_height - 1) * ky;
+		if (tile_height > 1)
+		        ky += (tile_height - 1) * ky;
 
-			
-			/* Verify location */
-			if ((ky < 0) || (ky >= t->hgt)) return;
-			if ((kx < 0) || (kx >= t->wid)) return;
+		
+		/* Verify location */
+		if ((ky < 0) || (ky >= t->hgt)) return;
+		if ((kx < 0) || (kx >= t->wid)) return;
 
-			/* Location in window */
-			vy = ky;
-			vx = kx;
-		}
+		/* Location in window */
+		vy = ky;
+		vx = kx;
+	}
 
 
-		/* Redraw the grid spot */
-		map_info(data->point.y, data->point.x, &g);
-		grid_data_as_text(&g, &a, &c, &ta, &tc);
-		Term_queue_char(t, vx, vy, a, c, ta, tc);
+	/* Redraw the grid spot */
+	map_grid_as_text(y, x, true, &a, &c, &ta, &tc);
+	Term_queue_char(t, vx, vy, a, c, ta, tc);
 #ifdef MAP_DEBUG
-		/* Plot 'spot' updates in light green to make them visible */
-		Term_queue_char(t, vx, vy, COLOUR_L_GREEN, c, ta, tc);
+	/* Plot 'spot' updates in light green to make them visible */
+	Term_queue_char(t, vx, vy, COLOUR_L_GREEN, c, ta, tc);
 #endif
 
-		if ((tile_width > 1) || (tile_height > 1))
-			Term_big_queue_char(t, vx, vy, a, c, COLOUR_WHITE, ' ');
+	if ((tile_width > 1) || (tile_height > 1))
+		Term_big_queue_char(t, vx, vy, a, c, COLOUR_WHITE, ' ');
+}
+
+/**
+ * Update a single map grid, a batch of grids or the whole map
+ */
+static void update_maps(game_event_type type, game_event_data *data, void *user)
+{
+	term *t = user;
+
+	/* A batch of grids, all drawn before a single refresh */
+	if (type == EVENT_MAP_POINTS) {
+		int i;
+
+		/* Nothing in the batch is near the panel */
+		if (data->points.max.y < t->offset_y ||
+			data->points.max.x < t->offset_x ||
+			data->points.min.y >= t->offset_y + t->hgt ||
+			data->points.min.x >= t->offset_x + t->wid)
+			return;
+
+		for (i = 0; i < data->points.count; i++)
+			update_map_point(t, data->points.grids[i].x,
+							 data->points.grids[i].y);
 	}
 
+	/* This signals a whole-map redraw. */
+	else if (data->point.x == -1 && data->point.y == -1)
+		prt_map();
+
+	/* Single point to be redrawn */
+	else
+		update_map_point(t, data->point.x, data->point.y);
+
 	/* Refresh the main screen unless the map needs to center */
 	if (player->upkeep->update & (PU_PANEL) && OPT(center_player)) {
 		int hgt = (t == angband_term[0]) ? SCREEN_HGT / 2 : t->hgt / 2;
@@ -1914,6 +1941,10 @@ static void subwindow_flag_changed(int win_idx, u32b flag, bool new_state)
 					       update_maps,
 					       angband_term[win_idx]);
 
+			register_or_deregister(EVENT_MAP_POINTS,
+					       update_maps,
+					       angband_term[win_idx]);
+
 			register_or_deregister(EVENT_END,
 					       flush_subwindow,
 					       angband_term[win_idx]);
@@ -2158,6 +2189,9 @@ static void repeated_command_display(game_event_type type,
 static void new_level_display_update(game_event_type type,
 									 game_event_data *data, void *user)
 {
+	/* New level, maybe a new character with new flavours */
+	map_glyphs_invalidate();
+
 	/* Hack -- enforce illegal panel */
 	Term->offset_y = z_info->dungeon_hgt;
 	Term->offset_x = z_info->dungeon_wid;
@@ -2390,8 +2424,10 @@ static void ui_enter_world(game_event_type type, game_event_data *data,
 
 	/* Simplest way to keep the map up to date - will do for now */
 	event_add_handler(EVENT_MAP, update_maps, angband_term[0]);
+	event_add_handler(EVENT_MAP_POINTS, update_maps, angband_term[0]);
 #ifdef MAP_DEBUG
 	event_add_handler(EVENT_MAP, trace_map_updates, angband_term[0]);
+	event_add_handler(EVENT_MAP_POINTS, trace_map_updates, angband_term[0]);
 #endif
 
 	/* Check if the panel should shift when the player's moved */
@@ -2455,8 +2491,10 @@ static void ui_leave_world(game_event_type type, game_event_data *data,
 
 	/* Simplest way to keep the map up to date - will do for now */
 	event_remove_handler(EVENT_MAP, update_maps, angband_term[0]);
+	event_remove_handler(EVENT_MAP_POINTS, update_maps, angband_term[0]);
 #ifdef MAP_DEBUG
 	event_remove_handler(EVENT_MAP, trace_map_updates, angband_term[0]);
+	event_remove_handler(EVENT_MAP_POINTS, trace_map_updates, angband_term[0]);
 #endif
 
 	/* Check if the panel should shift when the player's moved */
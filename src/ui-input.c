@@ -232,6 +232,9 @@ ui_event inkey_ex(void)
 			/* Hack -- activate proper term */
 			Term_activate(old);
 
+			/* Draw any map grids still waiting */
+			event_flush_map_points();
+
 			/* Flush output */
 			Term_fresh();
 
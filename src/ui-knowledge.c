@@ -42,6 +42,7 @@
 #include "trap.h"
 #include "ui-context.h"
 #include "ui-history.h"
+#include "ui-map.h"
 #include "ui-menu.h"
 #include "ui-mon-list.h"
 #include "ui-mon-lore.h"
@@ -1040,6 +1041,9 @@ static void display_knowledge(const char *title, int *obj_list, int o_count,
 	mem_free(g_offset);
 	mem_free(g_list);
 
+	/* The visuals may have been edited */
+	map_glyphs_invalidate();
+
 	screen_load();
 }
 
@@ -487,6 +487,128 @@ static void print_rel_map(wchar_t c, byte a, int y, int x)
 
 
 
+/**
+ * The text last drawn for each map grid, with the parts of its grid_data
+ * that decided it.  An entry is good while map_info() still gives the same
+ * key and the visuals haven't changed since (see map_glyphs_invalidate()).
+ * Grids showing a monster or the player, or seen while hallucinating, are
+ * never cached since their text can change from one redraw to the next.
+ */
+struct map_glyph {
+	u32b epoch;
+	u32b f_idx;
+	const struct object_kind *first_kind;
+	const struct trap_kind *trap_kind;
+	byte lighting;
+	byte flags;
+	int a, ta;
+	wchar_t c, tc;
+};
+
+enum {
+	MAP_GLYPH_IN_VIEW = 0x01,
+	MAP_GLYPH_MULTIPLE = 0x02,
+	MAP_GLYPH_UNSEEN_OBJECT = 0x04,
+	MAP_GLYPH_UNSEEN_MONEY = 0x08,
+	MAP_GLYPH_AWARE = 0x10,
+	MAP_GLYPH_TRAP_VISIBLE = 0x20
+};
+
+static struct map_glyph *map_glyphs;
+static int map_glyphs_wid, map_glyphs_hgt;
+static u32b map_glyph_epoch = 1;
+
+/**
+ * Forget all cached map text; needed whenever the attr/char tables, the
+ * options they depend on or the object flavours change.
+ */
+void map_glyphs_invalidate(void)
+{
+	/* Stale entries can't match again until the epoch wraps */
+	if (!++map_glyph_epoch) {
+		if (map_glyphs)
+			memset(map_glyphs, 0,
+				   map_glyphs_wid * map_glyphs_hgt * sizeof(*map_glyphs));
+		map_glyph_epoch = 1;
+	}
+}
+
+/**
+ * Fill in the key for a grid, returning false if the grid can't be cached
+ */
+static bool map_glyph_key(const struct grid_data *g, struct map_glyph *key)
+{
+	if (g->m_idx || g->is_player || g->hallucinate) return false;
+
+	key->f_idx = g->f_idx;
+	key->first_kind = g->first_kind;
+	key->trap_kind = g->trap ? g->trap->kind : NULL;
+	key->lighting = g->lighting;
+	key->flags = 0;
+	if (g->in_view) key->flags |= MAP_GLYPH_IN_VIEW;
+	if (g->multiple_objects) key->flags |= MAP_GLYPH_MULTIPLE;
+	if (g->unseen_object) key->flags |= MAP_GLYPH_UNSEEN_OBJECT;
+	if (g->unseen_money) key->flags |= MAP_GLYPH_UNSEEN_MONEY;
+	if (g->first_kind && g->first_kind->aware)
+		key->flags |= MAP_GLYPH_AWARE;
+	if (g->trap && (trf_has(g->trap->flags, TRF_VISIBLE) ||
+					trf_has(g->trap->flags, TRF_RUNE)))
+		key->flags |= MAP_GLYPH_TRAP_VISIBLE;
+
+	return true;
+}
+
+/**
+ * Get the text for the map grid at (y, x), reusing what was drawn there
+ * last time if nothing it depends on has changed.  A true "changed" says
+ * the grid is known to have changed and the text must be worked out again.
+ */
+void map_grid_as_text(int y, int x, bool changed, int *ap, wchar_t *cp,
+					  int *tap, wchar_t *tcp)
+{
+	struct grid_data g;
+	struct map_glyph key, *entry;
+
+	/* Always look, since that is how the player memorizes what is seen */
+	map_info(y, x, &g);
+
+	if (!map_glyph_key(&g, &key)) {
+		grid_data_as_text(&g, ap, cp, tap, tcp);
+		return;
+	}
+
+	/* Cover the current level */
+	if (cave->width != map_glyphs_wid || cave->height != map_glyphs_hgt) {
+		mem_free(map_glyphs);
+		map_glyphs_wid = cave->width;
+		map_glyphs_hgt = cave->height;
+		map_glyphs = mem_zalloc(map_glyphs_wid * map_glyphs_hgt *
+								sizeof(*map_glyphs));
+	}
+	entry = &map_glyphs[y * map_glyphs_wid + x];
+
+	if (!changed && entry->epoch == map_glyph_epoch &&
+		entry->f_idx == key.f_idx && entry->first_kind == key.first_kind &&
+		entry->trap_kind == key.trap_kind &&
+		entry->lighting == key.lighting && entry->flags == key.flags) {
+		*ap = entry->a;
+		*cp = entry->c;
+		*tap = entry->ta;
+		*tcp = entry->tc;
+		return;
+	}
+
+	grid_data_as_text(&g, ap, cp, tap, tcp);
+
+	key.epoch = map_glyph_epoch;
+	key.a = *ap;
+	key.c = *cp;
+	key.ta = *tap;
+	key.tc = *tcp;
+	*entry = key;
+}
+
+
 /**
  * Display an attr/char pair at the given map location
  *
@@ -533,7 +655,6 @@ static void prt_map_aux(void)
 {
 	int a, ta;
 	wchar_t c, tc;
-	struct grid_data g;
 
 	int y, x;
 	int vy, vx;
@@ -564,8 +685,7 @@ static void prt_map_aux(void)
 				if (vx + tile_width - 1 >= t->wid) continue;
 
 				/* Determine what is there */
-				map_info(y, x, &g);
-				grid_data_as_text(&g, &a, &c, &ta, &tc);
+				map_grid_as_text(y, x, false, &a, &c, &ta, &tc);
 				Term_queue_char(t, vx, vy, a, c, ta, tc);
 
 				if ((tile_width > 1) || (tile_height > 1))
@@ -588,7 +708,6 @@ void prt_map(void)
 {
 	int a, ta;
 	wchar_t c, tc;
-	struct grid_data g;
 
 	int y, x;
 	int vy, vx;
@@ -608,8 +727,7 @@ void prt_map(void)
 			if (!square_in_bounds(cave, y, x)) continue;
 
 			/* Determine what is there */
-			map_info(y, x, &g);
-			grid_data_as_text(&g, &a, &c, &ta, &tc);
+			map_grid_as_text(y, x, false, &a, &c, &ta, &tc);
 
 			/* Hack -- Queue it */
 			Term_queue_char(Term, vx, vy, a, c, ta, tc);
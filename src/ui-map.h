@@ -18,6 +18,9 @@
 
 extern void grid_data_as_text(struct grid_data *g, int *ap, wchar_t *cp,
 							  int *tap, wchar_t *tcp);
+extern void map_glyphs_invalidate(void);
+extern void map_grid_as_text(int y, int x, bool changed, int *ap, wchar_t *cp,
+							 int *tap, wchar_t *tcp);
 extern void move_cursor_relative(int y, int x);
 extern void print_rel(wchar_t c, byte a, int y, int x);
 extern void prt_map(void);
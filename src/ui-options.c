@@ -32,6 +32,7 @@
 #include "ui-input.h"
 #include "ui-keymap.h"
 #include "ui-knowledge.h"
+#include "ui-map.h"
 #include "ui-menu.h"
 #include "ui-options.h"
 #include "ui-prefs.h"
@@ -147,6 +148,9 @@ static bool option_toggle_handle(struct menu *m, const ui_event *event,
 		return false;
 	}
 
+	/* Some options change how the map is drawn */
+	map_glyphs_invalidate();
+
 	if (next) {
 		m->cursor++;
 		m->cursor = (m->cursor + m->filter_count) % m->filter_count;
@@ -32,6 +32,7 @@
 #include "trap.h"
 #include "ui-display.h"
 #include "ui-keymap.h"
+#include "ui-map.h"
 #include "ui-prefs.h"
 #include "ui-term.h"
 #include "sound.h"
@@ -1049,6 +1050,10 @@ static struct parser *init_parse_prefs(bool user)
 
 	parser_setpriv(p, pd);
 	pd->user = user;
+
+	/* The prefs may change how the map is drawn */
+	map_glyphs_invalidate();
+
 	for (i = 0; i < ANGBAND_TERM_MAX; i++) {
 		pd->loaded_window_flag[i] = false;
 	}
@@ -1264,6 +1269,8 @@ void reset_visuals(bool load_prefs)
 	int i, j;
 	struct flavor *f;
 
+	map_glyphs_invalidate();
+
 	/* Extract default attr/char code for features */
 	for (i = 0; i < z_info->f_max; i++) {
 		struct feature *feat = &f_info[i];
@@ -653,6 +653,67 @@ void Term_queue_chars(int x, int y, int n, int a, const wchar_t *s)
  * ------------------------------------------------------------------------ */
 
 
+/**
+ * Number of cells compared at once when looking for changes in a row
+ */
+#define TERM_DIFF_BLOCK 4
+
+/**
+ * Find the first column from x to x2 at which a row of the current window
+ * needs redrawing, or x2 + 1 if none does.  Whole blocks of cells are
+ * compared at a time, which the compiler turns into wide loads; the
+ * terrain arrays are only looked at when "ta" is true.
+ */
+static int Term_row_next_change(int y, int x, int x2, bool ta)
+{
+	const int *old_aa = Term->old->a[y];
+	const wchar_t *old_cc = Term->old->c[y];
+	const int *scr_aa = Term->scr->a[y];
+	const wchar_t *scr_cc = Term->scr->c[y];
+
+	const int *old_taa = Term->old->ta[y];
+	const wchar_t *old_tcc = Term->old->tc[y];
+	const int *scr_taa = Term->scr->ta[y];
+	const wchar_t *scr_tcc = Term->scr->tc[y];
+
+	/* Skip whole unchanged blocks */
+	while (x + TERM_DIFF_BLOCK - 1 <= x2) {
+		Term->cells_compared += TERM_DIFF_BLOCK;
+		if (memcmp(&old_aa[x], &scr_aa[x], TERM_DIFF_BLOCK * sizeof(int)) ||
+			memcmp(&old_cc[x], &scr_cc[x], TERM_DIFF_BLOCK * sizeof(wchar_t)))
+			break;
+		if (ta && (memcmp(&old_taa[x], &scr_taa[x],
+						  TERM_DIFF_BLOCK * sizeof(int)) ||
+				   memcmp(&old_tcc[x], &scr_tcc[x],
+						  TERM_DIFF_BLOCK * sizeof(wchar_t))))
+			break;
+		x += TERM_DIFF_BLOCK;
+	}
+
+	/* Then find the cell */
+	for (; x <= x2; x++) {
+		Term->cells_compared++;
+		if (old_aa[x] != scr_aa[x] || old_cc[x] != scr_cc[x]) break;
+		if (ta && (old_taa[x] != scr_taa[x] || old_tcc[x] != scr_tcc[x]))
+			break;
+	}
+
+	return x;
+}
+
+/**
+ * Draw a span of text (or blank it) from a row of the current window
+ */
+static void Term_fresh_span(int x, int y, int n, int a, const wchar_t *s)
+{
+	if (a || Term->always_text)
+		(void)((*Term->text_hook)(x, y, n, a, s));
+	else
+		(void)((*Term->wipe_hook)(x, y, n));
+
+	Term->spans_sent++;
+}
+
 /**
  * Flush a row of the current window (see "Term_fresh")
  *
@@ -694,6 +755,8 @@ static void Term_fresh_row_pict(int y, int x1, int x2)
 
 	/* Scan "modified" columns */
 	for (x = x1; x <= x2; x++) {
+		Term->cells_compared++;
+
 		/* See what is currently here */
 		oa = old_aa[x];
 		oc = old_cc[x];
@@ -715,12 +778,14 @@ static void Term_fresh_row_pict(int y, int x1, int x2)
 				/* Draw pending attr/char pairs */
 				(void)((*Term->pict_hook)(fx, y, fn, &scr_aa[fx], &scr_cc[fx],
 										  &scr_taa[fx], &scr_tcc[fx]));
+				Term->spans_sent++;
 
 				/* Forget */
 				fn = 0;
 			}
 
-			/* Skip */
+			/* Skip to the next change */
+			x = Term_row_next_change(y, x + 1, x2, true) - 1;
 			continue;
 		}
 
@@ -740,6 +805,7 @@ static void Term_fresh_row_pict(int y, int x1, int x2)
 		/* Draw pending attr/char pairs */
 		(void)((*Term->pict_hook)(fx, y, fn, &scr_aa[fx], &scr_cc[fx],
 								  &scr_taa[fx], &scr_tcc[fx]));
+		Term->spans_sent++;
 	}
 }
 
@@ -770,9 +836,6 @@ static void Term_fresh_row_both(int y, int x1, int x2)
 	int nta;
 	wchar_t ntc;
 
-	/* The "always_text" flag */
-	int always_text = Term->always_text;
-
 	/* Pending length */
 	int fn = 0;
 
@@ -790,6 +853,8 @@ static void Term_fresh_row_both(int y, int x1, int x2)
 
 	/* Scan "modified" columns */
 	for (x = x1; x <= x2; x++) {
+		Term->cells_compared++;
+
 		/* See what is currently here */
 		oa = old_aa[x];
 		oc = old_cc[x];
@@ -809,16 +874,14 @@ static void Term_fresh_row_both(int y, int x1, int x2)
 			/* Flush */
 			if (fn) {
 				/* Draw pending chars (normal or black) */
-				if (fa || always_text)
-					(void)((*Term->text_hook)(fx, y, fn, fa, &scr_cc[fx]));
-				else
-					(void)((*Term->wipe_hook)(fx, y, fn));
+				Term_fresh_span(fx, y, fn, fa, &scr_cc[fx]);
 
 				/* Forget */
 				fn = 0;
 			}
 
-			/* Skip */
+			/* Skip to the next change */
+			x = Term_row_next_change(y, x + 1, x2, true) - 1;
 			continue;
 		}
 
@@ -833,10 +896,7 @@ static void Term_fresh_row_both(int y, int x1, int x2)
 			/* Flush */
 			if (fn) {
 				/* Draw pending chars (normal or black) */
-				if (fa || always_text)
-					(void)((*Term->text_hook)(fx, y, fn, fa, &scr_cc[fx]));
-				else
-					(void)((*Term->wipe_hook)(fx, y, fn));
+				Term_fresh_span(fx, y, fn, fa, &scr_cc[fx]);
 
 				/* Forget */
 				fn = 0;
@@ -847,6 +907,7 @@ static void Term_fresh_row_both(int y, int x1, int x2)
 
 			/* Hack -- Draw the special attr/char pair */
 			(void)((*Term->pict_hook)(x, y, 1, &na, &nc, &nta, &ntc));
+			Term->spans_sent++;
 
 			/* Skip */
 			continue;
@@ -857,10 +918,7 @@ static void Term_fresh_row_both(int y, int x1, int x2)
 			/* Flush */
 			if (fn) {
 				/* Draw the pending chars, erase leading spaces */
-				if (fa || always_text)
-					(void)((*Term->text_hook)(fx, y, fn, fa, &scr_cc[fx]));
-				else
-					(void)((*Term->wipe_hook)(fx, y, fn));
+				Term_fresh_span(fx, y, fn, fa, &scr_cc[fx]);
 
 				/* Forget */
 				fn = 0;
@@ -877,10 +935,7 @@ static void Term_fresh_row_both(int y, int x1, int x2)
 	/* Flush */
 	if (fn) {
 		/* Draw pending chars (normal or black) */
-		if (fa || always_text)
-			(void)((*Term->text_hook)(fx, y, fn, fa, &scr_cc[fx]));
-		else
-			(void)((*Term->wipe_hook)(fx, y, fn));
+		Term_fresh_span(fx, y, fn, fa, &scr_cc[fx]);
 	}
 }
 
@@ -900,9 +955,6 @@ static void Term_fresh_row_text(int y, int x1, int x2)
 	int *scr_aa = Term->scr->a[y];
 	wchar_t *scr_cc = Term->scr->c[y];
 
-	/* The "always_text" flag */
-	int always_text = Term->always_text;
-
 	/* Pending length */
 	int fn = 0;
 
@@ -921,6 +973,8 @@ static void Term_fresh_row_text(int y, int x1, int x2)
 
 	/* Scan "modified" columns */
 	for (x = x1; x <= x2; x++) {
+		Term->cells_compared++;
+
 		/* See what is currently here */
 		oa = old_aa[x];
 		oc = old_cc[x];
@@ -932,18 +986,16 @@ static void Term_fresh_row_text(int y, int x1, int x2)
 		/* Handle unchanged grids */
 		if ((na == oa) && (nc == oc)) {
 			/* Flush */
-			if (fn) 	{
+			if (fn) {
 				/* Draw pending chars (normal or black) */
-				if (fa || always_text)
-					(void)((*Term->text_hook)(fx, y, fn, fa, &scr_cc[fx]));
-				else
-					(void)((*Term->wipe_hook)(fx, y, fn));
+				Term_fresh_span(fx, y, fn, fa, &scr_cc[fx]);
 
 				/* Forget */
 				fn = 0;
 			}
 
-			/* Skip */
+			/* Skip to the next change */
+			x = Term_row_next_change(y, x + 1, x2, false) - 1;
 			continue;
 		}
 
@@ -956,10 +1008,7 @@ static void Term_fresh_row_text(int y, int x1, int x2)
 			/* Flush */
 			if (fn) {
 				/* Draw the pending chars, erase leading spaces */
-				if (fa || always_text)
-					(void)((*Term->text_hook)(fx, y, fn, fa, &scr_cc[fx]));
-				else
-					(void)((*Term->wipe_hook)(fx, y, fn));
+				Term_fresh_span(fx, y, fn, fa, &scr_cc[fx]);
 
 				/* Forget */
 				fn = 0;
@@ -976,10 +1025,7 @@ static void Term_fresh_row_text(int y, int x1, int x2)
 	/* Flush */
 	if (fn) {
 		/* Draw pending chars (normal or black) */
-		if (fa || always_text)
-			(void)((*Term->text_hook)(fx, y, fn, fa, &scr_cc[fx]));
-		else
-			(void)((*Term->wipe_hook)(fx, y, fn));
+		Term_fresh_span(fx, y, fn, fa, &scr_cc[fx]);
 	}
 }
 
@@ -1814,6 +1860,21 @@ errr Term_get_size(int *w, int *h)
 }
 
 
+/**
+ * Get the number of cells Term_fresh() has compared and the number of spans
+ * it has drawn since this was last called, and start counting again
+ */
+errr Term_get_fresh_stats(u32b *cells_compared, u32b *spans_sent)
+{
+	*cells_compared = Term->cells_compared;
+	*spans_sent = Term->spans_sent;
+
+	Term->cells_compared = 0;
+	Term->spans_sent = 0;
+	return 0;
+}
+
+
 /**
  * Extract the current cursor location
  */
@@ -142,6 +142,9 @@ struct term_win
  *	- Temporary screen image
  *	- Memorized screen image
  *
+ *	- Cells compared by Term_fresh() (for profiling)
+ *	- Spans sent to the drawing hooks by Term_fresh() (for profiling)
+ *
  *
  *	- Hook for init-ing the term
  *	- Hook for nuke-ing the term
@@ -216,6 +219,10 @@ struct term
 	/* Number of times saved */
 	byte saved;
 
+	/* Work done by Term_fresh(), see Term_get_fresh_stats() */
+	u32b cells_compared;
+	u32b spans_sent;
+
 	void (*init_hook)(term *t);
 	void (*nuke_hook)(term *t);
 
@@ -378,6 +385,7 @@ extern errr Term_mark(int x, int y);
 
 extern errr Term_get_cursor(bool *v);
 extern errr Term_get_size(int *w, int *h);
+extern errr Term_get_fresh_stats(u32b *cells_compared, u32b *spans_sent);
 extern errr Term_locate(int *x, int *y);
 extern errr Term_what(int x, int y, int *a, wchar_t *c);
 
@@ -239,6 +239,47 @@ static void do_cmd_keylog(void) {
 }
 
 
+/**
+ * Show the allocator's counts for one size class on the next line
+ */
+static void wiz_mem_stats_line(const struct mem_class_stats *stats,
+							   void *data)
+{
+	int *row = data;
+	char size[16];
+	char buf[80];
+
+	if (stats->size)
+		strnfmt(size, sizeof(size), "%d", (int)stats->size);
+	else
+		my_strcpy(size, "larger", sizeof(size));
+
+	strnfmt(buf, sizeof(buf), "%8s %10lu %10lu %8lu %12lu", size,
+			(unsigned long)stats->allocs, (unsigned long)stats->reused,
+			(unsigned long)stats->live, (unsigned long)stats->bytes);
+	prt(buf, (*row)++, 0);
+}
+
+/**
+ * Show how the memory allocator's size classes are being used.
+ */
+static void do_cmd_wiz_mem_stats(void)
+{
+	int row = 2;
+
+	screen_save();
+
+	prt("Memory use by size class:", 0, 0);
+	prt(format("%8s %10s %10s %8s %12s", "size", "allocs", "reused", "live",
+			   "bytes"), 1, 0);
+	mem_report_stats(wiz_mem_stats_line, &row);
+
+	prt("Press any key to continue.", row + 1, 0);
+	anykey();
+	screen_load();
+}
+
+
 /**
  * Teleport to the requested target
  */
@@ -1634,7 +1675,7 @@ static void do_cmd_wiz_query(void)
 			if (!square_in_bounds_fully(cave, y, x)) continue;
 
 			/* Given flag, show only those grids */
-			if (flag && !sqinfo_has(cave->squares[y][x].info, flag)) continue;
+			if (flag && !square_flag_has(cave, y, x, flag)) continue;
 
 			/* Given no flag, show known grids */
 			if (!flag && (!square_isknown(cave, y, x))) continue;
@@ -2095,6 +2136,13 @@ void get_debug_command(void)
 			break;
 		}
 
+		/* Memory allocator statistics */
+		case 'M':
+		{
+			do_cmd_wiz_mem_stats();
+			break;
+		}
+
 		/* Magic Mapping */
 		case 'm':
 		{
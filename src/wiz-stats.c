@@ -1146,7 +1146,10 @@ static bool stats_monster(struct monster *mon, int i)
 		uniq_total[lvl] += addval;
 
 		/* kill the unique if we're in clearing mode */
-		if (clearing) mon->race->max_num = 0;
+		if (clearing) {
+			mon->race->max_num = 0;
+			mon_uniques_changed();
+		}
 
 		/* debugging print that we killed it
 		   msg_format("Killed %s",race->name); */
@@ -1485,6 +1488,7 @@ static void revive_uniques(void)
 		/* Revive the unique monster */
 		if (rf_has(race->flags, RF_UNIQUE)) race->max_num = 1;
 	}
+	mon_uniques_changed();
 }
 
 /**
@@ -17,6 +17,7 @@
  */
 
 #include "z-dice.h"
+#include "z-form.h"
 #include "z-virt.h"
 #include "z-util.h"
 #include "z-rand.h"
@@ -497,6 +498,66 @@ bool dice_parse_string(dice_t *dice, const char *string)
 	return true;
 }
 
+/**
+ * Write a dice object out as a string, in the form "base+dicedsidesmbonus",
+ * which dice_parse_string() reads back into the same values and variables.
+ * Variables are written by name, and numbers as they are; bound expressions
+ * are not written, but can be found with dice_variable().
+ *
+ * \param dice is the dice object to write out.
+ * \param buf is the buffer for the string.
+ * \param len is the size of the buffer.
+ * \return true if the whole string fitted in the buffer, false if not.
+ */
+bool dice_to_string(const dice_t *dice, char *buf, size_t len)
+{
+	const int values[4] = { dice->b, dice->x, dice->y, dice->m };
+	const bool variables[4] = { dice->ex_b, dice->ex_x, dice->ex_y, dice->ex_m };
+	const char *markers[4] = { "+", "d", "m", "" };
+	char string[4 * (DICE_TOKEN_SIZE + 2) + 1] = { '\0' };
+	char token[DICE_TOKEN_SIZE + 2];
+	int i;
+
+	for (i = 0; i < 4; i++) {
+		if (variables[i]) {
+			if (dice->expressions == NULL || values[i] < 0 ||
+				values[i] >= DICE_MAX_EXPRESSIONS ||
+				dice->expressions[values[i]].name == NULL)
+				return false;
+			strnfmt(token, sizeof(token), "$%s",
+					dice->expressions[values[i]].name);
+		}
+		else
+			strnfmt(token, sizeof(token), "%d", values[i]);
+
+		my_strcat(string, token, sizeof(string));
+		my_strcat(string, markers[i], sizeof(string));
+	}
+
+	return my_strcpy(buf, string, len) < len;
+}
+
+/**
+ * Get one of the variables in a dice object's symbol list.
+ *
+ * \param dice is the dice object.
+ * \param i is the index of the variable, counting from zero.
+ * \param expression is set to the expression bound to the variable, or NULL
+ * if there is none.
+ * \return The name of the variable, or NULL if there are fewer variables.
+ */
+const char *dice_variable(const dice_t *dice, int i,
+						  const expression_t **expression)
+{
+	*expression = NULL;
+
+	if (dice->expressions == NULL || i < 0 || i >= DICE_MAX_EXPRESSIONS)
+		return NULL;
+
+	*expression = dice->expressions[i].expression;
+	return dice->expressions[i].name;
+}
+
 /**
  * Extract a random_value by evaluating any bound expressions.
  *
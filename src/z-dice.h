@@ -29,6 +29,9 @@ typedef struct dice_s dice_t;
 dice_t *dice_new(void);
 void dice_free(dice_t *dice);
 bool dice_parse_string(dice_t *dice, const char *string);
+bool dice_to_string(const dice_t *dice, char *buf, size_t len);
+const char *dice_variable(const dice_t *dice, int i,
+						  const expression_t **expression);
 int dice_bind_expression(dice_t *dice, const char *name,
 						 const expression_t *expression);
 void dice_random_value(dice_t *dice, random_value *v);
@@ -17,6 +17,7 @@
  */
 
 #include "z-expression.h"
+#include "z-form.h"
 #include "z-virt.h"
 #include "z-util.h"
 
@@ -209,6 +210,14 @@ void expression_set_base_value(expression_t *expression,
 	expression->base_value = function;
 }
 
+/**
+ * Get the base value function that the operations operate on.
+ */
+expression_base_value_f expression_get_base_value(const expression_t *expression)
+{
+	return expression->base_value;
+}
+
 /**
  * Evaluate the given expression. If the base value function is NULL,
  * expression is evaluated from zero.
@@ -385,6 +394,54 @@ s16b expression_add_operations_string(expression_t *expression,
 	return count;
 }
 
+/**
+ * Write the operations of an expression out as a string, in the prefix
+ * notation expression_add_operations_string() reads back into the same
+ * operations.  The base value function is not written.
+ *
+ * \param expression is the expression to write out.
+ * \param buf is the buffer for the string.
+ * \param len is the size of the buffer.
+ * \return true if the whole string fitted in the buffer, false if not.
+ */
+bool expression_to_string(const expression_t *expression, char *buf,
+						  size_t len)
+{
+	size_t i;
+
+	if (len == 0)
+		return false;
+	buf[0] = '\0';
+
+	for (i = 0; i < expression->operation_count; i++) {
+		const expression_operation_t *op = &expression->operations[i];
+		const char *sep = i ? " " : "";
+		char token[32];
+		char symbol;
+
+		switch (op->operator) {
+			case OPERATOR_ADD: symbol = '+'; break;
+			case OPERATOR_SUB: symbol = '-'; break;
+			case OPERATOR_MUL: symbol = '*'; break;
+			case OPERATOR_DIV: symbol = '/'; break;
+			case OPERATOR_NEG: symbol = 'n'; break;
+			default: return false;
+		}
+
+		/* Negation takes no operand */
+		if (op->operator == OPERATOR_NEG)
+			strnfmt(token, sizeof(token), "%s%c", sep, symbol);
+		else
+			strnfmt(token, sizeof(token), "%s%c %d", sep, symbol,
+					op->operand);
+
+		if (my_strcat(buf, token, len) >= len)
+			return false;
+	}
+
+	return true;
+}
+
 /**
  * Test to make sure that the deep copy from expression_copy() is equal in value
  */
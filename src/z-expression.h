@@ -38,9 +38,12 @@ void expression_free(expression_t *expression);
 expression_t *expression_copy(const expression_t *source);
 void expression_set_base_value(expression_t *expression,
 							   expression_base_value_f function);
+expression_base_value_f expression_get_base_value(const expression_t *expression);
 s32b expression_evaluate(expression_t const * const expression);
 s16b expression_add_operations_string(expression_t *expression,
 									  const char *string);
+bool expression_to_string(const expression_t *expression, char *buf,
+						  size_t len);
 bool expression_test_copy(const expression_t *a, const expression_t *b);
 
 #endif /* INCLUDED_Z_EXPRESSION_H */
@@ -604,6 +604,7 @@ char *vformat(const char *fmt, va_list vp)
 void vformat_kill(void)
 {
 	mem_free(format_buf);
+	format_buf = NULL;
 }
 
 
@@ -19,22 +19,59 @@
  */
 #include "z-virt.h"
 #include "z-quark.h"
+#include "z-util.h"
 #include "init.h"
 
 static char **quarks;
 static size_t nr_quarks = 1;
 static size_t alloc_quarks = 0;
 
+/**
+ * Open-addressed index from string hash to quark; 0 marks an empty slot.
+ * The size is a power of two and is kept at least twice the quark count.
+ */
+static quark_t *quark_index;
+static size_t index_size = 0;
+
 #define QUARKS_INIT	16
 
-quark_t quark_add(const char *str)
+/**
+ * Find the index slot holding str, or the empty slot where it would go
+ */
+static size_t quark_slot(const char *str, u32b hash)
+{
+	size_t mask = index_size - 1;
+	size_t i = hash & mask;
+
+	while (quark_index[i] && strcmp(quarks[quark_index[i]], str))
+		i = (i + 1) & mask;
+
+	return i;
+}
+
+/**
+ * Double the size of the index and re-insert every quark
+ */
+static void quark_index_grow(void)
 {
 	quark_t q;
 
-	for (q = 1; q < nr_quarks; q++) {
-		if (!strcmp(quarks[q], str))
-			return q;
-	}
+	mem_free(quark_index);
+	index_size *= 2;
+	quark_index = mem_zalloc(index_size * sizeof(quark_t));
+
+	for (q = 1; q < nr_quarks; q++)
+		quark_index[quark_slot(quarks[q], djb2_hash(quarks[q]))] = q;
+}
+
+quark_t quark_add(const char *str)
+{
+	u32b hash = djb2_hash(str);
+	size_t slot = quark_slot(str, hash);
+	quark_t q = quark_index[slot];
+
+	if (q)
+		return q;
 
 	if (nr_quarks == alloc_quarks) {
 		alloc_quarks *= 2;
@@ -44,6 +81,13 @@ quark_t quark_add(const char *str)
 	q = nr_quarks++;
 	quarks[q] = string_make(str);
 
+	/* Keep the index at most half full */
+	if (2 * nr_quarks > index_size) {
+		quark_index_grow();
+	} else {
+		quark_index[slot] = q;
+	}
+
 	return q;
 }
 
@@ -56,6 +100,9 @@ void quarks_init(void)
 {
 	alloc_quarks = QUARKS_INIT;
 	quarks = mem_zalloc(alloc_quarks * sizeof(char*));
+
+	index_size = 2 * QUARKS_INIT;
+	quark_index = mem_zalloc(index_size * sizeof(quark_t));
 }
 
 void quarks_free(void)
@@ -67,6 +114,10 @@ void quarks_free(void)
 		string_free(quarks[i]);
 
 	mem_free(quarks);
+	mem_free(quark_index);
+	quark_index = NULL;
+	index_size = 0;
+	nr_quarks = 1;
 }
 
 struct init_module z_quark_module = {
@@ -38,6 +38,11 @@ int q_len(struct queue *q) {
     return len;
 }
 
+void q_clear(struct queue *q) {
+    q->head = 0;
+    q->tail = 0;
+}
+
 void q_push(struct queue *q, uintptr_t item) {
     q->data[q->tail] = item;
     q->tail = (q->tail + 1) % q->size;
@@ -43,6 +43,7 @@ struct queue {
 
 struct queue *q_new(size_t size);
 int q_len(struct queue *q);
+void q_clear(struct queue *q);
 
 void q_push(struct queue *q, uintptr_t item);
 uintptr_t q_pop(struct queue *q);
@@ -29,10 +29,14 @@
  * algorithm, used with permission. See below for copyright information
  * about the WELL implementation.
  *
- * To use of the "simple" RNG, activate it via "Rand_quick = true" and
- * "Rand_value = seed". After that it will be automatically used instead of
- * the "complex" RNG. When you are done, you can de-activate it via
- * "Rand_quick = false". You can also choose a new seed.
+ * To use of the "simple" RNG, give a context its seed with
+ * rng_state_init_quick() and make it current with Rand_set_context(). When
+ * you are done, set the previous context back.
+ *
+ * Every thread has its own current context, and rng_state_split() gives
+ * every worker a reproducible stream of its own from one master seed.  This
+ * only makes the random numbers thread-safe: the rest of the game, the
+ * memory allocator in z-virt.c included, still expects a single thread.
  */
 
 /* begin WELL RNG
@@ -50,29 +54,22 @@
 #define MAT0NEG(t, v) (v ^ (v << (-(t))))
 #define Identity(v) (v)
 
-u32b state_i = 0;
-u32b STATE[RAND_DEG] = {0, 0, 0, 0, 0, 0, 0, 0,
-						0, 0, 0, 0, 0, 0, 0, 0,
-						0, 0, 0, 0, 0, 0, 0, 0,
-						0, 0, 0, 0, 0, 0, 0, 0};
-u32b z0, z1, z2;
-
-#define V0    STATE[state_i]
-#define VM1   STATE[(state_i + M1) & 0x0000001fU]
-#define VM2   STATE[(state_i + M2) & 0x0000001fU]
-#define VM3   STATE[(state_i + M3) & 0x0000001fU]
-#define VRm1  STATE[(state_i + 31) & 0x0000001fU]
-#define newV0 STATE[(state_i + 31) & 0x0000001fU]
-#define newV1 STATE[state_i]
-
-static u32b WELLRNG1024a (void){
-	z0      = VRm1;
-	z1      = Identity(V0) ^ MAT0POS (8, VM1);
-	z2      = MAT0NEG (-19, VM2) ^ MAT0NEG(-14,VM3);
-	newV1   = z1 ^ z2; 
-	newV0   = MAT0NEG (-11,z0) ^ MAT0NEG(-7,z1) ^ MAT0NEG(-13,z2);
-	state_i = (state_i + 31) & 0x0000001fU;
-	return STATE[state_i];
+#define V0    r->state[r->state_i]
+#define VM1   r->state[(r->state_i + M1) & 0x0000001fU]
+#define VM2   r->state[(r->state_i + M2) & 0x0000001fU]
+#define VM3   r->state[(r->state_i + M3) & 0x0000001fU]
+#define VRm1  r->state[(r->state_i + 31) & 0x0000001fU]
+#define newV0 r->state[(r->state_i + 31) & 0x0000001fU]
+#define newV1 r->state[r->state_i]
+
+static u32b WELLRNG1024a (struct rng_state *r){
+	r->z0      = VRm1;
+	r->z1      = Identity(V0) ^ MAT0POS (8, VM1);
+	r->z2      = MAT0NEG (-19, VM2) ^ MAT0NEG(-14,VM3);
+	newV1      = r->z1 ^ r->z2;
+	newV0      = MAT0NEG (-11,r->z0) ^ MAT0NEG(-7,r->z1) ^ MAT0NEG(-13,r->z2);
+	r->state_i = (r->state_i + 31) & 0x0000001fU;
+	return r->state[r->state_i];
 }
 /* end WELL RNG */
 
@@ -83,52 +80,141 @@ static u32b WELLRNG1024a (void){
 
 
 /**
- * Whether to use the simple RNG or not.
+ * The main game stream, which starts out using the simple RNG until
+ * Rand_init() seeds it.
  */
-bool Rand_quick = true;
+static struct rng_state rand_main = { true };
 
 /**
- * The current "seed" of the simple RNG.
+ * Each thread's current context
  */
-u32b Rand_value;
-
-static bool rand_fixed = false;
-static u32b rand_fixval = 0;
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L
+static _Thread_local struct rng_state *rand_current = &rand_main;
+#elif defined(__GNUC__)
+static __thread struct rng_state *rand_current = &rand_main;
+#elif defined(_MSC_VER)
+static __declspec(thread) struct rng_state *rand_current = &rand_main;
+#else
+static struct rng_state *rand_current = &rand_main;
+#endif
 
 /**
- * Initialize the complex RNG using a new seed.
+ * Fill the complex RNG's table from a seed, carrying on from the table's
+ * current index.
  */
-void Rand_state_init(u32b seed)
+static void rng_state_seed(struct rng_state *rng, u32b seed)
 {
 	int i, j;
 
 	/* Seed the table */
-	STATE[0] = seed;
+	rng->state[0] = seed;
 
 	/* Propagate the seed */
 	for (i = 1; i < RAND_DEG; i++)
-		STATE[i] = LCRNG(STATE[i - 1]);
+		rng->state[i] = LCRNG(rng->state[i - 1]);
 
 	/* Cycle the table ten times per degree */
 	for (i = 0; i < RAND_DEG * 10; i++) {
 		/* Acquire the next index */
-		j = (state_i + 1) % RAND_DEG;
+		j = (rng->state_i + 1) % RAND_DEG;
 
 		/* Update the table, extract an entry */
-		STATE[j] += STATE[state_i];
+		rng->state[j] += rng->state[rng->state_i];
 
 		/* Advance the index */
-		state_i = j;
+		rng->state_i = j;
 	}
 }
 
+/**
+ * Initialize a context's complex RNG using a new seed.
+ */
+void rng_state_init(struct rng_state *rng, u32b seed)
+{
+	memset(rng, 0, sizeof(*rng));
+	rng_state_seed(rng, seed);
+}
+
+/**
+ * Initialize a context to use the simple RNG from a new seed.
+ */
+void rng_state_init_quick(struct rng_state *rng, u32b seed)
+{
+	memset(rng, 0, sizeof(*rng));
+	rng->quick = true;
+	rng->value = seed;
+}
+
+/**
+ * Mix the bits of a 32-bit number thoroughly (the finaliser of MurmurHash3)
+ */
+static u32b rand_mix(u32b x)
+{
+	x ^= x >> 16;
+	x *= 0x85ebca6bU;
+	x ^= x >> 13;
+	x *= 0xc2b2ae35U;
+	x ^= x >> 16;
+	return x;
+}
+
+/**
+ * Initialize a context to stream number `stream` of a master seed.
+ *
+ * The whole table of the complex RNG is filled from a hash of the seed, the
+ * stream and the position in the table, so that each stream starts from an
+ * unrelated point in the generator's period and is the same every time.
+ * This takes the place of a jump-ahead, which WELL1024a makes expensive.
+ */
+void rng_state_split(struct rng_state *rng, u32b seed, u32b stream)
+{
+	u32b key = rand_mix(rand_mix(seed) ^ (stream * 0x9e3779b9U + 0x7f4a7c15U));
+	int i;
+
+	memset(rng, 0, sizeof(*rng));
+	for (i = 0; i < RAND_DEG; i++)
+		rng->state[i] = rand_mix(key + (u32b)i * 0x9e3779b9U);
+
+	/* The all-zero table is the one state the generator never leaves */
+	rng->state[0] |= 1;
+}
+
+/**
+ * Get the current thread's RNG context
+ */
+struct rng_state *Rand_context(void)
+{
+	return rand_current;
+}
+
+/**
+ * Make a context current for this thread, returning the previous one
+ */
+struct rng_state *Rand_set_context(struct rng_state *rng)
+{
+	struct rng_state *old = rand_current;
+
+	rand_current = rng ? rng : &rand_main;
+	return old;
+}
+
+/**
+ * Initialize the current context's complex RNG using a new seed.
+ */
+void Rand_state_init(u32b seed)
+{
+	/* Only the table is reseeded, as the main stream always was */
+	rand_current->quick = false;
+	rng_state_seed(rand_current, seed);
+}
+
 /**
  * Initialise the RNG
  */
 void Rand_init(void)
 {
 	/* Init RNG */
-	if (Rand_quick) {
+	if (rand_main.quick) {
 		u32b seed;
 
 		/* Basic seed */
@@ -141,11 +227,9 @@ void Rand_init(void)
 
 #endif
 
-		/* Use the complex RNG */
-		Rand_quick = false;
-
 		/* Seed the "complex" RNG */
-		Rand_state_init(seed);
+		rand_main.quick = false;
+		rng_state_seed(&rand_main, seed);
 	}
 }
 
@@ -163,7 +247,8 @@ void Rand_init(void)
  */
 u32b Rand_div(u32b m)
 {
-	u32b r, n;
+	struct rng_state *r = rand_current;
+	u32b n, v;
 
 	/* Division by zero will result if m is larger than 0x10000000 */
 	assert(m <= 0x10000000);
@@ -171,41 +256,41 @@ u32b Rand_div(u32b m)
 	/* Hack -- simple case */
 	if (m <= 1) return (0);
 
-	if (rand_fixed)
-		return (rand_fixval * 1000 * (m - 1)) / (100 * 1000);
+	if (r->fixed)
+		return (r->fixval * 1000 * (m - 1)) / (100 * 1000);
 
 	/* Partition size */
 	n = (0x10000000 / m);
 
-	if (Rand_quick) {
+	if (r->quick) {
 		/* Use a simple RNG */
 		/* Wait for it */
 		while (1) {
 			/* Cycle the generator */
-			r = (Rand_value = LCRNG(Rand_value));
+			v = (r->value = LCRNG(r->value));
 
 			/* Mutate a 28-bit "random" number */
-			r = ((r >> 4) & 0x0FFFFFFF) / n;
+			v = ((v >> 4) & 0x0FFFFFFF) / n;
 
 			/* Done */
-			if (r < m) break;
+			if (v < m) break;
 		}
 	} else {
 		/* Use a complex RNG */
 		while (1) {
 			/* Get the next pseudorandom number */
-			r = WELLRNG1024a();
+			v = WELLRNG1024a(r);
 
 			/* Mutate a 28-bit "random" number */
-			r = ((r >> 4) & 0x0FFFFFFF) / n;
+			v = ((v >> 4) & 0x0FFFFFFF) / n;
 
 			/* Done */
-			if (r < m) break;
+			if (v < m) break;
 		}
 	}
 
 	/* Use the value */
-	return (r);
+	return (v);
 }
 
 
@@ -503,8 +588,8 @@ bool randcalc_varies(random_value v)
 
 void rand_fix(u32b val)
 {
-	rand_fixed = true;
-	rand_fixval = val;
+	rand_current->fixed = true;
+	rand_current->fixval = val;
 }
 
 int getpid(void);
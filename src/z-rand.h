@@ -90,27 +90,52 @@ typedef enum {
 #define one_in_(x) (!randint0(x))
 
 /**
- * Whether we are currently using the "quick" method or not.
+ * The state of one stream of random numbers.
+ *
+ * Each thread draws its numbers from its current context, which is the main
+ * game stream until the thread picks another with Rand_set_context().
+ */
+struct rng_state {
+	bool quick;			/* Whether to use the "quick" method or not */
+	u32b value;			/* The state used by the "quick" RNG */
+
+	u32b state_i;		/* The state used by the "complex" RNG */
+	u32b state[RAND_DEG];
+	u32b z0;
+	u32b z1;
+	u32b z2;
+
+	bool fixed;			/* Return a fixed fraction for testing */
+	u32b fixval;
+};
+
+/**
+ * Initialise a context's complex RNG with the given seed.
  */
-extern bool Rand_quick;
+void rng_state_init(struct rng_state *rng, u32b seed);
 
 /**
- * The state used by the "quick" RNG.
+ * Initialise a context to use the quick RNG with the given seed.
  */
-extern u32b Rand_value;
+void rng_state_init_quick(struct rng_state *rng, u32b seed);
 
 /**
- * The state used by the "complex" RNG.
+ * Initialise a context to the given stream of a master seed.
  */
-extern u32b state_i;
-extern u32b STATE[RAND_DEG];
-extern u32b z0;
-extern u32b z1;
-extern u32b z2;
+void rng_state_split(struct rng_state *rng, u32b seed, u32b stream);
 
+/**
+ * Get the current thread's RNG context.
+ */
+struct rng_state *Rand_context(void);
+
+/**
+ * Make `rng` the current thread's RNG context, returning the previous one.
+ */
+struct rng_state *Rand_set_context(struct rng_state *rng);
 
 /**
- * Initialise the RNG state with the given seed.
+ * Initialise the current RNG context's complex RNG with the given seed.
  */
 void Rand_state_init(u32b seed);
 
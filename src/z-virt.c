@@ -22,6 +22,56 @@ unsigned int mem_flags = 0;
 
 #define SZ(uptr)	*((size_t *)((char *)(uptr) - sizeof(size_t)))
 
+/**
+ * Size class of a request of `len` bytes; MEM_CLASSES for large requests
+ */
+#define MEM_CLASS(len) \
+	((len) > MEM_CLASS_MAX ? MEM_CLASSES : ((len) - 1) / MEM_CLASS_STEP)
+
+/**
+ * Freed blocks of each small size class, linked through their first bytes.
+ *
+ * These lists and the counts below are plain globals with no locking, so
+ * only one thread may allocate and free memory.  That is the game's main
+ * thread; main-stats.c runs its jobs as separate processes for this reason.
+ */
+static void *free_blocks[MEM_CLASSES];
+
+/**
+ * Counts for each size class, and for large blocks
+ */
+static struct mem_class_stats class_stats[MEM_CLASSES + 1];
+
+/**
+ * Get a block big enough for the size class of `len`, with its size header
+ */
+static char *mem_get_block(size_t len)
+{
+	size_t class = MEM_CLASS(len);
+	struct mem_class_stats *stats = &class_stats[class];
+	char *mem;
+
+	if (class < MEM_CLASSES && free_blocks[class]) {
+		mem = free_blocks[class];
+		free_blocks[class] = *(void **)mem;
+		stats->reused++;
+	} else {
+		size_t size = class < MEM_CLASSES ? (class + 1) * MEM_CLASS_STEP : len;
+
+		mem = malloc(size + sizeof(size_t));
+		if (!mem)
+			quit("Out of Memory!");
+		mem += sizeof(size_t);
+	}
+
+	stats->allocs++;
+	stats->live++;
+	stats->bytes += len;
+	SZ(mem) = len;
+
+	return mem;
+}
+
 /**
  * Allocate `len` bytes of memory.
  *
@@ -38,13 +88,9 @@ void *mem_alloc(size_t len)
 	/* Allow allocation of "zero bytes" */
 	if (len == 0) return (NULL);
 
-	mem = malloc(len + sizeof(size_t));
-	if (!mem)
-		quit("Out of Memory!");
-	mem += sizeof(size_t);
+	mem = mem_get_block(len);
 	if (mem_flags & MEM_POISON_ALLOC)
 		memset(mem, 0xCC, len);
-	SZ(mem) = len;
 
 	return mem;
 }
@@ -56,32 +102,191 @@ void *mem_zalloc(size_t len)
 	return mem;
 }
 
+/**
+ * Free a block.  Small blocks go back on their class's free list, unless
+ * freed memory is being poisoned, in which case every block goes straight
+ * back to the system so that use-after-free is not masked by reuse.
+ */
 void mem_free(void *p)
 {
+	size_t class;
+
 	if (!p) return;
 
+	class = MEM_CLASS(SZ(p));
+	class_stats[class].live--;
+
 	if (mem_flags & MEM_POISON_FREE)
 		memset(p, 0xCD, SZ(p));
-	free((char *)p - sizeof(size_t));
+
+	if (class < MEM_CLASSES && !(mem_flags & MEM_POISON_FREE)) {
+		*(void **)p = free_blocks[class];
+		free_blocks[class] = p;
+	} else {
+		free((char *)p - sizeof(size_t));
+	}
 }
 
 void *mem_realloc(void *p, size_t len)
 {
 	char *m = p;
+	size_t old_len;
 
 	/* Fail gracefully */
 	if (len == 0) return (NULL);
 
-	m = realloc(m ? m - sizeof(size_t) : NULL, len + sizeof(size_t));
-	m += sizeof(size_t);
+	/* Nothing to keep */
+	if (!m) return mem_alloc(len);
+
+	old_len = SZ(m);
+
+	/* Still fits in the same small block */
+	if (MEM_CLASS(len) == MEM_CLASS(old_len) && len <= MEM_CLASS_MAX) {
+		SZ(m) = len;
+		return m;
+	}
+
+	/* Both large, so let the system move it */
+	if (len > MEM_CLASS_MAX && old_len > MEM_CLASS_MAX) {
+		m = realloc(m - sizeof(size_t), len + sizeof(size_t));
 
-	/* Handle OOM */
-	if (!m) quit("Out of Memory!");
-	SZ(m) = len;
+		/* Handle OOM */
+		if (!m) quit("Out of Memory!");
+		m += sizeof(size_t);
+		SZ(m) = len;
+
+		return m;
+	}
+
+	/* Moving between classes */
+	m = mem_alloc(len);
+	memcpy(m, p, MIN(len, old_len));
+	mem_free(p);
 
 	return m;
 }
 
+/**
+ * Pass the counts for each size class, then for large blocks, to `hook`
+ */
+void mem_report_stats(mem_stats_hook hook, void *data)
+{
+	size_t i;
+
+	for (i = 0; i <= MEM_CLASSES; i++) {
+		class_stats[i].size = i < MEM_CLASSES ? (i + 1) * MEM_CLASS_STEP : 0;
+		hook(&class_stats[i], data);
+	}
+}
+
+/**
+ * Give every block on the free lists back to the system
+ */
+void mem_trim(void)
+{
+	size_t i;
+
+	for (i = 0; i < MEM_CLASSES; i++) {
+		while (free_blocks[i]) {
+			char *mem = free_blocks[i];
+			free_blocks[i] = *(void **)mem;
+			free(mem - sizeof(size_t));
+		}
+	}
+}
+
+
+/**
+ * Arena blocks are carved up from the front; requests too big for a
+ * standard block get a block of their own.
+ */
+#define ARENA_BLOCK_SIZE	65536
+#define ARENA_ALIGN			16
+
+struct arena_block {
+	struct arena_block *next;
+	size_t size;
+	size_t used;
+};
+
+struct mem_arena {
+	struct arena_block *blocks;
+};
+
+/**
+ * Offset of the usable space in an arena block, kept aligned
+ */
+#define ARENA_HEADER \
+	((sizeof(struct arena_block) + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1))
+
+struct mem_arena *mem_arena_new(void)
+{
+	return mem_zalloc(sizeof(struct mem_arena));
+}
+
+void *mem_arena_alloc(struct mem_arena *arena, size_t len)
+{
+	struct arena_block *block = arena->blocks;
+	char *mem;
+
+	if (len == 0) return (NULL);
+
+	len = (len + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+
+	/* Start a new block when the current one is full */
+	if (!block || block->size - block->used < len) {
+		size_t size = MAX(len, ARENA_BLOCK_SIZE);
+
+		block = malloc(ARENA_HEADER + size);
+		if (!block)
+			quit("Out of Memory!");
+		block->size = size;
+		block->used = 0;
+
+		/* Oversized requests keep the current block in front */
+		if (arena->blocks && len > ARENA_BLOCK_SIZE) {
+			block->next = arena->blocks->next;
+			arena->blocks->next = block;
+		} else {
+			block->next = arena->blocks;
+			arena->blocks = block;
+		}
+	}
+
+	mem = (char *)block + ARENA_HEADER + block->used;
+	block->used += len;
+	if (mem_flags & MEM_POISON_ALLOC)
+		memset(mem, 0xCC, len);
+
+	return mem;
+}
+
+void *mem_arena_zalloc(struct mem_arena *arena, size_t len)
+{
+	void *mem = mem_arena_alloc(arena, len);
+	if (mem)
+		memset(mem, 0, len);
+	return mem;
+}
+
+/**
+ * Release everything allocated from `arena`, and the arena itself
+ */
+void mem_arena_free(struct mem_arena *arena)
+{
+	if (!arena) return;
+
+	while (arena->blocks) {
+		struct arena_block *block = arena->blocks;
+		arena->blocks = block->next;
+		if (mem_flags & MEM_POISON_FREE)
+			memset((char *)block + ARENA_HEADER, 0xCD, block->used);
+		free(block);
+	}
+
+	mem_free(arena);
+}
+
 /**
  * Duplicates an existing string `str`, allocating as much memory as necessary.
  */
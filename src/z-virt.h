@@ -23,6 +23,47 @@ void *mem_zalloc(size_t len);
 void mem_free(void *p);
 void *mem_realloc(void *p, size_t len);
 
+/**
+ * Requests up to MEM_CLASS_MAX bytes are rounded up to a multiple of
+ * MEM_CLASS_STEP, and freed blocks of each such size class are kept for
+ * reuse rather than handed back to the system.  None of this is locked, so
+ * only one thread may use these functions.  mem_trim() hands the free
+ * blocks back, and cleanup_angband() calls it.
+ */
+#define MEM_CLASS_STEP	16
+#define MEM_CLASS_MAX	256
+#define MEM_CLASSES		(MEM_CLASS_MAX / MEM_CLASS_STEP)
+
+/**
+ * Allocation counts for one size class; the last class (size 0) covers
+ * every request bigger than MEM_CLASS_MAX.
+ */
+struct mem_class_stats {
+	size_t size;	/* Largest request in the class */
+	u32b allocs;	/* Blocks handed out */
+	u32b reused;	/* ...of which came from the free list */
+	u32b live;		/* Blocks not yet freed */
+	size_t bytes;	/* Total bytes requested */
+};
+
+typedef void (*mem_stats_hook)(const struct mem_class_stats *stats,
+							   void *data);
+
+void mem_report_stats(mem_stats_hook hook, void *data);
+void mem_trim(void);
+
+/**
+ * Arenas hand out memory that is only ever released all at once, for data
+ * that lives exactly as long as some owner (such as a level).  An arena is
+ * not locked, so it must only be used by one thread at a time.
+ */
+struct mem_arena;
+
+struct mem_arena *mem_arena_new(void);
+void *mem_arena_alloc(struct mem_arena *arena, size_t len);
+void *mem_arena_zalloc(struct mem_arena *arena, size_t len);
+void mem_arena_free(struct mem_arena *arena);
+
 char *string_make(const char *str);
 void string_free(char *str);
 char *string_append(char *s1, const char *s2);